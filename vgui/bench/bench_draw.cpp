@@ -0,0 +1,368 @@
+// Headless microbenchmarks for the Draw:: tessellators. Only the CPU side of vgui_draw.cpp is
+// built; frames go to the built-in NullBackend, which counts and drops them.
+//
+// Build (Linux or any g++/clang, no D3D11 needed), from the vgui/ directory:
+//   g++ -std=c++17 -O2 -pthread -Ivgui bench/bench_draw.cpp vgui/vgui_draw.cpp vgui/vgui_render.cpp vgui/vgui_context.cpp vgui/vgui_jobs.cpp vgui/vgui_curves.cpp vgui/vgui_polygon.cpp vgui/vgui_arena.cpp -o vgui_bench
+// Run:
+//   ./vgui_bench [--filter <substring>] [--min-time <ms>] [--tolerance <px>] [--kernels scalar|sse2|avx2|neon] > bench.json
+//
+// Every case records calls in batches (one frame per batch) until min-time is spent inside the
+// Draw* calls. Render() runs between batches and is timed separately: with the null backend that
+// is the merge and submission walk alone. --kernels forces the circle / Bezier point kernels
+// (vgui_curves.cpp) instead of the best the CPU supports, --tolerance sets the curve tolerance that
+// AutoSegments (segments 0) and rounded rects follow. Output is one JSON document; circle and
+// rounded-rect cases report how often their arc table was a compile-time one, and the footer the
+// memory the arc tables take. Global operator new is counted, so every case reports the heap
+// allocations its Draw* calls make after the first batch (0 once vectors and the scratch arena
+// have grown) and the high-water mark of the context's scratch arena.
+
+#include "vgui_curves.h"
+#include "vgui_draw.h"
+#include "vgui_render.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace VGUI::Draw;
+
+static NullBackend g_NullBackend;
+static std::atomic<size_t> g_HeapAllocations{ 0 };
+
+void* operator new(size_t size) {
+    g_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+struct BenchCase {
+    std::string name;
+    std::string params;     // JSON object body, e.g. "\"segments\": 32"
+    bool antiAlias;
+    bool instancing;
+    std::function<void(int)> call;
+};
+
+struct BenchResult {
+    double seconds;
+    double renderSeconds;
+    size_t calls;
+    size_t vertices;
+    size_t indices;
+    size_t instances;
+    size_t fringeVertices;
+    size_t arcTableHits;
+    size_t arcTableMisses;
+    size_t polygonCacheHits;
+    size_t polygonCacheMisses;
+    size_t heapAllocations;     // in Draw* calls, first batch excluded
+    size_t heapCalls;           // calls those were counted over
+    size_t scratchBytes;        // highest per-frame scratch arena use
+    size_t submits;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static BenchResult Run(const BenchCase& bench, double minSeconds) {
+    EnableAntiAliasing(bench.antiAlias);
+    EnableShapeInstancing(bench.instancing);
+
+    // Warm up the vectors so steady-state capacity is measured, not the first allocations
+    for (int i = 0; i < 16; i++) bench.call(i);
+    Render();
+
+    BenchResult result = {};
+    g_NullBackend.ResetCounters();
+    int counter = 0;
+    bool firstBatch = true;
+    while (result.seconds < minSeconds) {
+        // One batch: up to 1024 calls or ~1ms, whichever comes first
+        size_t batchCalls = 0;
+        const size_t allocations = g_HeapAllocations.load(std::memory_order_relaxed);
+        Clock::time_point start = Clock::now();
+        Clock::time_point now = start;
+        while (batchCalls < 1024 && std::chrono::duration<double>(now - start).count() < 0.001) {
+            for (int i = 0; i < 8; i++) bench.call(counter++);
+            batchCalls += 8;
+            now = Clock::now();
+        }
+        result.seconds += std::chrono::duration<double>(now - start).count();
+        result.calls += batchCalls;
+        if (!firstBatch) {
+            result.heapAllocations += g_HeapAllocations.load(std::memory_order_relaxed) - allocations;
+            result.heapCalls += batchCalls;
+        }
+        firstBatch = false;
+
+        start = Clock::now();
+        Render();
+        result.renderSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+        const FrameStats& stats = GetFrameStats();
+        result.vertices += stats.vertices;
+        result.indices += stats.indices;
+        result.instances += stats.instances;
+        result.fringeVertices += stats.fringeVertices;
+        result.arcTableHits += stats.arcTableHits;
+        result.arcTableMisses += stats.arcTableMisses;
+        result.polygonCacheHits += stats.polygonCacheHits;
+        result.polygonCacheMisses += stats.polygonCacheMisses;
+        if (stats.scratchBytes > result.scratchBytes) result.scratchBytes = stats.scratchBytes;
+    }
+    result.submits = static_cast<size_t>(g_NullBackend.GetCounters().submits);
+    return result;
+}
+
+static std::string Params(const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return buffer;
+}
+
+static float Jitter(int i) {
+    return static_cast<float>(i & 63);
+}
+
+static std::vector<BenchCase> BuildCases() {
+    std::vector<BenchCase> cases;
+    static std::vector<std::vector<float>> polygons;
+    static DrawList panel;
+
+    for (int aa = 0; aa <= 1; aa++) {
+        cases.push_back({ "DrawLine", "", aa != 0, false, [](int i) {
+            DrawLine(10 + Jitter(i), 10, 300, 200 + Jitter(i), 1, 1, 1, 1);
+        } });
+
+        const float thicknesses[] = { 2.0f, 8.0f };
+        for (float t : thicknesses) {
+            cases.push_back({ "DrawThickLine", Params("\"thickness\": %g", t), aa != 0, false, [t](int i) {
+                DrawThickLine(10 + Jitter(i), 10, 300, 200 + Jitter(i), t, 1, 1, 1, 1);
+            } });
+        }
+
+        cases.push_back({ "DrawTriangle", "", aa != 0, false, [](int i) {
+            DrawTriangle(10 + Jitter(i), 10, 110, 10, 60, 90, 1, 1, 1, 1);
+        } });
+        cases.push_back({ "DrawFilledTriangle", "", aa != 0, false, [](int i) {
+            DrawFilledTriangle(10 + Jitter(i), 10, 110, 10, 60, 90, 1, 1, 1, 1);
+        } });
+        cases.push_back({ "DrawGradientRect", "", aa != 0, false, [](int i) {
+            DrawGradientRect(10 + Jitter(i), 10, 200, 40, 1, 0, 0, 1, 0, 0, 1, 1, true);
+        } });
+
+        for (int inst = 0; inst <= 1; inst++) {
+            cases.push_back({ "DrawRect", "", aa != 0, inst != 0, [](int i) {
+                DrawRect(10 + Jitter(i), 10, 200, 100, 1, 1, 1, 1);
+            } });
+            cases.push_back({ "DrawRectThick", "\"thickness\": 3", aa != 0, inst != 0, [](int i) {
+                DrawRectThick(10 + Jitter(i), 10, 200, 100, 3, 1, 1, 1, 1);
+            } });
+            cases.push_back({ "DrawFilledRect", "", aa != 0, inst != 0, [](int i) {
+                DrawFilledRect(10 + Jitter(i), 10, 200, 100, 1, 1, 1, 1);
+            } });
+
+            const float radii[] = { 2.0f, 8.0f, 32.0f, 64.0f };
+            for (float radius : radii) {
+                cases.push_back({ "DrawRoundedRect", Params("\"radius\": %g", radius), aa != 0, inst != 0, [radius](int i) {
+                    DrawRoundedRect(10 + Jitter(i), 10, 200, 150, radius, 1, 1, 1, 1);
+                } });
+            }
+
+            // Instanced circles ignore the segment count, one sweep point is enough. 0 is AutoSegments.
+            const int segmentCounts[] = { 0, 8, 32, 64, 128 };
+            const float circleRadii[] = { 10.0f, 100.0f };
+            for (int segments : segmentCounts) {
+                if (inst && segments != segmentCounts[0]) continue;
+                for (float radius : circleRadii) {
+                    std::string params = inst ? Params("\"radius\": %g", radius)
+                        : Params("\"segments\": %d, \"radius\": %g", segments, radius);
+                    cases.push_back({ "DrawCircle", params, aa != 0, inst != 0, [segments, radius](int i) {
+                        DrawCircle(200 + Jitter(i), 200, radius, segments, 1, 1, 1, 1);
+                    } });
+                    cases.push_back({ "DrawFilledCircle", params, aa != 0, inst != 0, [segments, radius](int i) {
+                        DrawFilledCircle(200 + Jitter(i), 200, radius, segments, 1, 1, 1, 1);
+                    } });
+                }
+            }
+        }
+
+        const int polygonSizes[] = { 8, 64, 1024, 100000 };
+        for (int size : polygonSizes) {
+            polygons.emplace_back();
+            std::vector<float>& points = polygons.back();
+            for (int p = 0; p < size; p++) {
+                float angle = 6.28318530718f * static_cast<float>(p) / static_cast<float>(size);
+                float radius = (p & 1) ? 300.0f : 280.0f;
+                points.push_back(400 + radius * cosf(angle));
+                points.push_back(400 + radius * sinf(angle));
+            }
+            const float* data = points.data();
+            cases.push_back({ "DrawPolygon", Params("\"points\": %d", size), aa != 0, false, [data, size](int) {
+                DrawPolygon(data, size, 1, 1, 1, 1);
+            } });
+            cases.push_back({ "DrawFilledPolygon", Params("\"points\": %d", size), aa != 0, false, [data, size](int) {
+                DrawFilledPolygon(data, size, 1, 1, 1, 1);
+            } });
+        }
+
+        // The 1024-point star with a different outline every call, so it is ear-clipped each time
+        // instead of coming from the triangulation cache, and the convex fan fast path
+        static std::vector<float> uniqueStar;
+        uniqueStar = polygons[2];
+        cases.push_back({ "DrawFilledPolygon", "\"points\": 1024, \"shape\": \"uncached\"", aa != 0, false, [](int i) {
+            uniqueStar[0] = 700.0f + static_cast<float>(i & 0xFFFF) * (1.0f / 1024.0f);
+            DrawFilledPolygon(uniqueStar.data(), 1024, 1, 1, 1, 1);
+        } });
+        static float convexPoints[64 * 2];
+        for (int p = 0; p < 64; p++) {
+            float angle = 6.28318530718f * static_cast<float>(p) / 64.0f;
+            convexPoints[p * 2] = 400 + 300 * cosf(angle);
+            convexPoints[p * 2 + 1] = 400 + 300 * sinf(angle);
+        }
+        cases.push_back({ "DrawFilledPolygon", "\"points\": 64, \"shape\": \"convex\"", aa != 0, false, [](int) {
+            DrawFilledPolygon(convexPoints, 64, 1, 1, 1, 1);
+        } });
+
+        const int bezierSegments[] = { 0, 4, 16, 64 };
+        for (int segments : bezierSegments) {
+            cases.push_back({ "DrawBezierCurve", Params("\"segments\": %d", segments), aa != 0, false, [segments](int i) {
+                DrawBezierCurve(10 + Jitter(i), 100, 100, 0, 200, 200, 300, 100, segments, 1, 1, 1, 1);
+            } });
+            // Node-graph wire: horizontal tangents, nearly straight
+            cases.push_back({ "DrawBezierCurve", Params("\"segments\": %d, \"shape\": \"wire\"", segments), aa != 0, false, [segments](int i) {
+                DrawBezierCurve(10 + Jitter(i), 100, 160, 100, 160, 130, 310, 130, segments, 1, 1, 1, 1);
+            } });
+            cases.push_back({ "DrawQuadraticBezierCurve", Params("\"segments\": %d", segments), aa != 0, false, [segments](int i) {
+                DrawQuadraticBezierCurve(10 + Jitter(i), 100, 150, 0, 300, 100, segments, 1, 1, 1, 1);
+            } });
+        }
+
+        // Zigzag through 16 points, the shape of a plot line
+        static float splinePoints[16 * 2];
+        for (int p = 0; p < 16; p++) {
+            splinePoints[p * 2] = 10.0f + 20.0f * static_cast<float>(p);
+            splinePoints[p * 2 + 1] = (p & 1) ? 140.0f : 100.0f;
+        }
+        const int splineSegments[] = { 0, 8 };
+        for (int segments : splineSegments) {
+            cases.push_back({ "DrawCatmullRomSpline", Params("\"points\": 16, \"segments\": %d", segments), aa != 0, false, [segments](int) {
+                DrawCatmullRomSpline(splinePoints, 16, false, segments, 1, 1, 1, 1);
+            } });
+        }
+
+        // The same zigzag stroked as one strip per join style
+        const LineJoin joins[] = { LineJoin::Miter, LineJoin::Bevel, LineJoin::Round };
+        const char* joinNames[] = { "miter", "bevel", "round" };
+        for (int j = 0; j < 3; j++) {
+            LineJoin join = joins[j];
+            cases.push_back({ "DrawPolyline", Params("\"points\": 16, \"thickness\": 4, \"join\": \"%s\"", joinNames[j]), aa != 0, false, [join](int) {
+                SetLineJoin(join);
+                DrawPolyline(splinePoints, 16, false, 4.0f, 1, 1, 1, 1);
+                SetLineJoin(LineJoin::Miter);
+            } });
+        }
+    }
+
+    // Replay of a recorded panel, the path static chrome takes
+    cases.push_back({ "SubmitDrawList", "\"content\": \"panel\"", true, false, [](int i) {
+        if (panel.commands.empty()) {
+            BeginDrawList(panel);
+            DrawFilledRoundedRect(0, 0, 400, 300, 15, 0.15f, 0.15f, 0.2f, 0.95f);
+            DrawRectThick(0, 0, 400, 300, 2.0f, 0.4f, 0.8f, 1.0f, 1.0f);
+            DrawGradientRect(0, 0, 400, 40, 0.3f, 0.6f, 0.9f, 1.0f, 0.2f, 0.4f, 0.7f, 1.0f, true);
+            DrawThickLine(20, 260, 380, 260, 4.0f, 0.2f, 1.0f, 0.2f, 1.0f);
+            EndDrawList();
+        }
+        SubmitDrawList(panel, 50 + Jitter(i), 50);
+    } });
+
+    return cases;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    double minSeconds = 0.2;
+    double tolerance = 0.25;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) minSeconds = atof(argv[++i]) / 1000.0;
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--kernels") && i + 1 < argc) {
+            const char* name = argv[++i];
+            const VGUI::Curves::KernelSet sets[] = { VGUI::Curves::KernelSet::Scalar, VGUI::Curves::KernelSet::SSE2,
+                VGUI::Curves::KernelSet::AVX2, VGUI::Curves::KernelSet::NEON };
+            for (VGUI::Curves::KernelSet set : sets)
+                if (!strcmp(name, VGUI::Curves::GetKernelSetName(set))) VGUI::Curves::SetKernelSet(set);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--filter <substring>] [--min-time <ms>] [--tolerance <px>] [--kernels scalar|sse2|avx2|neon]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SetDisplaySize(1920, 1080);
+    SetRenderBackend(&g_NullBackend);
+    SetCurveTolerance(static_cast<float>(tolerance));
+    std::vector<BenchCase> cases = BuildCases();
+
+    printf("{\n  \"benchmark\": \"vgui_draw\",\n  \"kernels\": \"%s\",\n  \"curve_tolerance\": %g,\n",
+        VGUI::Curves::GetKernelSetName(VGUI::Curves::GetKernelSet()), tolerance);
+    printf("  \"vertex_bytes\": %zu,\n  \"index_bytes\": %zu,\n  \"instance_bytes\": %zu,\n",
+        sizeof(Vertex), sizeof(DrawIndex), sizeof(ShapeInstance));
+    printf("  \"results\": [");
+
+    bool first = true;
+    for (const BenchCase& bench : cases) {
+        if (filter && bench.name.find(filter) == std::string::npos) continue;
+
+        BenchResult r = Run(bench, minSeconds);
+        double calls = static_cast<double>(r.calls);
+        double bytes = static_cast<double>(r.vertices * sizeof(Vertex) + r.indices * sizeof(DrawIndex) +
+            r.instances * sizeof(ShapeInstance));
+
+        printf("%s\n    { \"name\": \"%s\", \"params\": { %s }, \"aa\": %s, \"instancing\": %s,\n",
+            first ? "" : ",", bench.name.c_str(), bench.params.c_str(),
+            bench.antiAlias ? "true" : "false", bench.instancing ? "true" : "false");
+        printf("      \"calls\": %zu, \"ns_per_call\": %.1f, \"vertices_per_call\": %.1f, \"indices_per_call\": %.1f,\n",
+            r.calls, r.seconds * 1e9 / calls, r.vertices / calls, r.indices / calls);
+        printf("      \"instances_per_call\": %.1f, \"fringe_vertices_per_call\": %.1f,\n",
+            r.instances / calls, r.fringeVertices / calls);
+        printf("      \"render_ns_per_call\": %.1f, \"submits_per_call\": %.3f,\n",
+            r.renderSeconds * 1e9 / calls, r.submits / calls);
+        size_t arcLookups = r.arcTableHits + r.arcTableMisses;
+        if (arcLookups)
+            printf("      \"arc_table_hit_rate\": %.3f,\n", static_cast<double>(r.arcTableHits) / arcLookups);
+        size_t polygonLookups = r.polygonCacheHits + r.polygonCacheMisses;
+        if (polygonLookups)
+            printf("      \"polygon_cache_hit_rate\": %.3f,\n", static_cast<double>(r.polygonCacheHits) / polygonLookups);
+        if (r.heapCalls)
+            printf("      \"heap_allocs_per_call\": %.3f,\n", static_cast<double>(r.heapAllocations) / r.heapCalls);
+        printf("      \"scratch_bytes\": %zu,\n", r.scratchBytes);
+        printf("      \"vertices_per_sec\": %.0f, \"bytes_per_sec\": %.0f }",
+            r.vertices / r.seconds, bytes / r.seconds);
+        fflush(stdout);
+        first = false;
+    }
+    // Compile-time tables plus the ones the cases above generated
+    VGUI::Curves::ArcTableStats arcStats = VGUI::Curves::GetArcTableStats();
+    printf("\n  ],\n  \"arc_tables\": { \"precomputed\": %u, \"precomputed_bytes\": %zu, \"lazy\": %u, \"lazy_bytes\": %zu }\n}\n",
+        arcStats.precomputedTables, arcStats.precomputedBytes, arcStats.lazyTables, arcStats.lazyBytes);
+    return 0;
+}
\ No newline at end of file
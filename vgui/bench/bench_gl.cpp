@@ -0,0 +1,238 @@
+// Headless OpenGL backend benchmark (vgui_render_gl.cpp) on an EGL surfaceless context, so it runs
+// on GPU-less Linux machines through Mesa llvmpipe.
+//
+// Build, from the vgui/ directory:
+//   g++ -std=c++17 -O2 -pthread -Ivgui bench/bench_gl.cpp vgui/vgui_draw.cpp vgui/vgui_render.cpp vgui/vgui_context.cpp vgui/vgui_jobs.cpp vgui/vgui_curves.cpp vgui/vgui_polygon.cpp vgui/vgui_arena.cpp vgui/vgui_render_gl.cpp vgui/vgui_raster.cpp vgui/vgui_upload.cpp -lEGL -o vgui_bench_gl
+// Run:
+//   ./vgui_bench_gl [--api gl|gles] [--filter <substring>] [--min-time <ms>] [--size <w>x<h>] > gl.json
+//   (LIBGL_ALWAYS_SOFTWARE=1 forces llvmpipe when a GPU driver is present)
+//
+// Every scene is recorded once into a DrawList, then submitted and rendered into an RGBA8
+// framebuffer object until min-time is spent. A frame is timed up to glFinish, cpu_ms is the
+// Render() call alone. The last frame is read back and compared with the software rasterizer:
+// max_diff is the largest color channel difference, mismatched_pixels counts pixels off by more
+// than 2. Alpha is left out: it is the last fragment's source alpha, so it follows fill rule tie
+// breaks, which GL resolves on the other vertical side than D3D11 and the rasterizer.
+
+#include "bench_scenes.h"
+#include "vgui_draw.h"
+#include "vgui_raster.h"
+#include "vgui_render.h"
+#include "vgui_render_gl.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace VGUI;
+using namespace VGUI::Draw;
+
+typedef std::chrono::steady_clock Clock;
+
+// Host-side GL calls: framebuffer setup, clear and readback
+typedef unsigned int GLenum;
+typedef unsigned int GLuint;
+typedef int GLint;
+typedef int GLsizei;
+typedef float GLfloat;
+typedef unsigned int GLbitfield;
+
+static const GLenum GL_COLOR_BUFFER_BIT = 0x4000;
+static const GLenum GL_RGBA = 0x1908;
+static const GLenum GL_RGBA8 = 0x8058;
+static const GLenum GL_UNSIGNED_BYTE = 0x1401;
+static const GLenum GL_RENDERER = 0x1F01;
+static const GLenum GL_VERSION = 0x1F02;
+static const GLenum GL_FRAMEBUFFER = 0x8D40;
+static const GLenum GL_RENDERBUFFER = 0x8D41;
+static const GLenum GL_COLOR_ATTACHMENT0 = 0x8CE0;
+static const GLenum GL_FRAMEBUFFER_COMPLETE = 0x8CD5;
+
+struct HostGL {
+    const unsigned char* (*GetString)(GLenum);
+    void (*GenFramebuffers)(GLsizei, GLuint*);
+    void (*BindFramebuffer)(GLenum, GLuint);
+    void (*GenRenderbuffers)(GLsizei, GLuint*);
+    void (*BindRenderbuffer)(GLenum, GLuint);
+    void (*RenderbufferStorage)(GLenum, GLenum, GLsizei, GLsizei);
+    void (*FramebufferRenderbuffer)(GLenum, GLenum, GLenum, GLuint);
+    GLenum (*CheckFramebufferStatus)(GLenum);
+    void (*Viewport)(GLint, GLint, GLsizei, GLsizei);
+    void (*ClearColor)(GLfloat, GLfloat, GLfloat, GLfloat);
+    void (*Clear)(GLbitfield);
+    void (*Finish)();
+    void (*ReadPixels)(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*);
+};
+
+template <typename T>
+static bool LoadProc(T& proc, const char* name) {
+    proc = reinterpret_cast<T>(eglGetProcAddress(name));
+    return proc != nullptr;
+}
+
+static bool LoadHostGL(HostGL& gl) {
+    return LoadProc(gl.GetString, "glGetString") && LoadProc(gl.GenFramebuffers, "glGenFramebuffers") &&
+        LoadProc(gl.BindFramebuffer, "glBindFramebuffer") && LoadProc(gl.GenRenderbuffers, "glGenRenderbuffers") &&
+        LoadProc(gl.BindRenderbuffer, "glBindRenderbuffer") && LoadProc(gl.RenderbufferStorage, "glRenderbufferStorage") &&
+        LoadProc(gl.FramebufferRenderbuffer, "glFramebufferRenderbuffer") &&
+        LoadProc(gl.CheckFramebufferStatus, "glCheckFramebufferStatus") && LoadProc(gl.Viewport, "glViewport") &&
+        LoadProc(gl.ClearColor, "glClearColor") && LoadProc(gl.Clear, "glClear") && LoadProc(gl.Finish, "glFinish") &&
+        LoadProc(gl.ReadPixels, "glReadPixels");
+}
+
+static GLProc GetProcAddress(const char* name) {
+    return reinterpret_cast<GLProc>(eglGetProcAddress(name));
+}
+
+// Surfaceless display and a current context without any window system
+static bool CreateContext(bool es) {
+    EGLDisplay display = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        fprintf(stderr, "no EGL surfaceless display\n");
+        return false;
+    }
+    if (!eglBindAPI(es ? EGL_OPENGL_ES_API : EGL_OPENGL_API)) return false;
+
+    // Rendering goes to a framebuffer object; surfaceless configs only advertise pbuffers
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, es ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        fprintf(stderr, "no EGL config\n");
+        return false;
+    }
+
+    const EGLint glAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    const EGLint esAttribs[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_NONE };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, es ? esAttribs : glAttribs);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        fprintf(stderr, "cannot create a %s 3 context\n", es ? "GLES" : "GL");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    double minSeconds = 0.5;
+    int width = 1920, height = 1080;
+    bool es = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) minSeconds = atof(argv[++i]) / 1000.0;
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &width, &height) == 2) i++;
+        else if (!strcmp(argv[i], "--api") && i + 1 < argc) es = !strcmp(argv[++i], "gles");
+        else {
+            fprintf(stderr, "usage: %s [--api gl|gles] [--filter <substring>] [--min-time <ms>] [--size <w>x<h>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    HostGL gl;
+    if (!CreateContext(es) || !LoadHostGL(gl)) return 1;
+
+    std::unique_ptr<RenderBackend> backend(CreateGLBackend(GetProcAddress));
+    if (!backend) {
+        fprintf(stderr, "CreateGLBackend failed\n");
+        return 1;
+    }
+
+    GLuint framebuffer = 0, renderbuffer = 0;
+    gl.GenFramebuffers(1, &framebuffer);
+    gl.GenRenderbuffers(1, &renderbuffer);
+    gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    gl.BindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    gl.RenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    gl.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+    if (gl.CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "framebuffer incomplete\n");
+        return 1;
+    }
+    gl.Viewport(0, 0, width, height);
+    gl.ClearColor(0, 0, 0, 0);
+
+    SetDisplaySize(width, height);
+    std::vector<Scene> scenes = BuildScenes();
+    Raster::Rasterizer reference;
+    Raster::RasterBackend referenceBackend(reference);
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+
+    printf("{\n  \"benchmark\": \"vgui_gl\",\n");
+    printf("  \"renderer\": \"%s\",\n  \"version\": \"%s\",\n  \"width\": %d,\n  \"height\": %d,\n",
+        reinterpret_cast<const char*>(gl.GetString(GL_RENDERER)), reinterpret_cast<const char*>(gl.GetString(GL_VERSION)),
+        width, height);
+    printf("  \"results\": [");
+
+    bool first = true;
+    for (const Scene& scene : scenes) {
+        if (filter && scene.name.find(filter) == std::string::npos) continue;
+
+        DrawList list;
+        BeginDrawList(list);
+        scene.record(width, height);
+        EndDrawList();
+
+        SetRenderBackend(backend.get());
+        double seconds = 0.0, cpuSeconds = 0.0;
+        size_t frames = 0, drawCalls = 0;
+        while (seconds < minSeconds || frames < 2) {
+            Clock::time_point start = Clock::now();
+            gl.Clear(GL_COLOR_BUFFER_BIT);
+            SubmitDrawList(list);
+            Clock::time_point submit = Clock::now();
+            Render();
+            cpuSeconds += std::chrono::duration<double>(Clock::now() - submit).count();
+            gl.Finish();
+            seconds += std::chrono::duration<double>(Clock::now() - start).count();
+            drawCalls = GetFrameStats().drawCalls;
+            frames++;
+        }
+        gl.ReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        // Same frame through the software rasterizer; GL rows are bottom-up
+        SetRenderBackend(&referenceBackend);
+        reference.Resize(width, height);
+        SubmitDrawList(list);
+        Render();
+        SetRenderBackend(nullptr);
+
+        int maxDiff = 0;
+        size_t mismatched = 0;
+        for (int y = 0; y < height; y++) {
+            const uint32_t* row = pixels.data() + static_cast<size_t>(height - 1 - y) * width;
+            const uint32_t* expected = reference.GetPixels() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                int pixelDiff = 0;
+                for (int shift = 0; shift < 24; shift += 8) {
+                    int diff = abs(static_cast<int>((row[x] >> shift) & 0xff) - static_cast<int>((expected[x] >> shift) & 0xff));
+                    if (diff > pixelDiff) pixelDiff = diff;
+                }
+                if (pixelDiff > maxDiff) maxDiff = pixelDiff;
+                if (pixelDiff > 2) mismatched++;
+            }
+        }
+
+        printf("%s\n    { \"scene\": \"%s\", \"frames\": %zu, \"ms_per_frame\": %.3f, \"cpu_ms\": %.3f, \"draw_calls\": %zu,\n",
+            first ? "" : ",", scene.name.c_str(), frames, seconds * 1000.0 / frames, cpuSeconds * 1000.0 / frames, drawCalls);
+        printf("      \"max_diff\": %d, \"mismatched_pixels\": %zu }", maxDiff, mismatched);
+        fflush(stdout);
+        first = false;
+    }
+    printf("\n  ]\n}\n");
+
+    backend.reset();
+    return 0;
+}
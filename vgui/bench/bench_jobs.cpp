@@ -0,0 +1,158 @@
+// Scaling of batch tessellation (DrawFilledCircles, DrawBezierCurves) on the work-stealing job
+// system (vgui_jobs.cpp).
+//
+// Build (Linux or any g++/clang, no D3D11 needed), from the vgui/ directory:
+//   g++ -std=c++17 -O2 -pthread -Ivgui bench/bench_jobs.cpp vgui/vgui_draw.cpp vgui/vgui_render.cpp vgui/vgui_context.cpp vgui/vgui_jobs.cpp vgui/vgui_curves.cpp vgui/vgui_polygon.cpp vgui/vgui_arena.cpp -o vgui_bench_jobs
+// Run:
+//   ./vgui_bench_jobs [--filter <substring>] [--min-time <ms>] [--count <n>] [--max-threads <n>] > jobs.json
+//
+// Every scene records count shapes per frame into a DrawList until min-time is spent recording:
+// first one Draw* call per shape ("serial"), then as one batch for thread counts 1, 2, 4 ...
+// max-threads (default: every hardware thread, pass --max-threads 32 to sweep up to 32 cores).
+// Speedup is relative to the batch on one thread; matches_serial compares the batch's list hash
+// with the one-by-one recording, which must be identical.
+
+#include "vgui_draw.h"
+#include "vgui_jobs.h"
+#include "vgui_render.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace VGUI;
+using namespace VGUI::Draw;
+
+typedef std::chrono::steady_clock Clock;
+
+struct JobScene {
+    std::string name;
+    std::function<void()> serial;   // one call per shape
+    std::function<void()> batch;    // the same shapes as batches
+};
+
+struct SceneResult {
+    double seconds;
+    size_t frames;
+    size_t vertices;
+    uint64_t hash;
+};
+
+static SceneResult Record(const std::function<void()>& record, double minSeconds) {
+    SceneResult result = {};
+    DrawList list;
+    while (result.seconds < minSeconds || result.frames < 2) {
+        list.Clear();
+        Clock::time_point start = Clock::now();
+        BeginDrawList(list);
+        record();
+        EndDrawList();
+        result.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+        result.frames++;
+    }
+    result.vertices = list.vertices.size();
+    result.hash = list.hash;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    double minSeconds = 0.5;
+    size_t count = 50000;
+    unsigned maxThreads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) minSeconds = atof(argv[++i]) / 1000.0;
+        else if (!strcmp(argv[i], "--count") && i + 1 < argc) count = static_cast<size_t>(atol(argv[++i]));
+        else if (!strcmp(argv[i], "--max-threads") && i + 1 < argc) maxThreads = static_cast<unsigned>(atoi(argv[++i]));
+        else {
+            fprintf(stderr, "usage: %s [--filter <substring>] [--min-time <ms>] [--count <n>] [--max-threads <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxThreads == 0) maxThreads = 1;
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    // Scattered node-graph style content: small anti-aliased dots and wires between them
+    std::vector<CircleDesc> circles(count);
+    std::vector<BezierDesc> curves(count);
+    for (size_t i = 0; i < count; i++) {
+        float x = static_cast<float>((i * 37) % 1920);
+        float y = static_cast<float>((i * 101) % 1080);
+        float shade = static_cast<float>(i & 255) / 255.0f;
+        circles[i] = { x, y, 2.0f + static_cast<float>(i % 12), 32, shade, 0.6f, 1.0f - shade, 1.0f };
+        curves[i] = { x, y, x + 60.0f, y, x + 40.0f, y + 80.0f, x + 100.0f, y + 80.0f, 32, 0.9f, shade, 0.2f, 0.8f };
+    }
+
+    std::vector<JobScene> scenes;
+    scenes.push_back({ "circles", [&]() {
+        for (const CircleDesc& c : circles) DrawFilledCircle(c.cx, c.cy, c.radius, c.segments, c.r, c.g, c.b, c.a);
+    }, [&]() {
+        DrawFilledCircles(circles.data(), circles.size());
+    } });
+    scenes.push_back({ "beziers", [&]() {
+        for (const BezierDesc& c : curves)
+            DrawBezierCurve(c.x1, c.y1, c.x2, c.y2, c.x3, c.y3, c.x4, c.y4, c.segments, c.r, c.g, c.b, c.a);
+    }, [&]() {
+        DrawBezierCurves(curves.data(), curves.size());
+    } });
+    scenes.push_back({ "circles+beziers", [&]() {
+        scenes[0].serial();
+        scenes[1].serial();
+    }, [&]() {
+        scenes[0].batch();
+        scenes[1].batch();
+    } });
+
+    // Tessellated circles are what the batch path parallelizes, so instancing stays off
+    SetDisplaySize(1920, 1080);
+    EnableAntiAliasing(true);
+    EnableShapeInstancing(false);
+
+    printf("{\n  \"benchmark\": \"vgui_jobs\",\n  \"count\": %zu,\n  \"hardware_threads\": %u,\n",
+        count, std::thread::hardware_concurrency());
+    printf("  \"results\": [");
+
+    bool first = true;
+    for (const JobScene& scene : scenes) {
+        if (filter && scene.name.find(filter) == std::string::npos) continue;
+
+        SetJobSystem(nullptr);
+        SceneResult serial = Record(scene.serial, minSeconds);
+        printf("%s\n    { \"scene\": \"%s\", \"mode\": \"serial\", \"threads\": 1, \"frames\": %zu, \"ms_per_frame\": %.3f,\n",
+            first ? "" : ",", scene.name.c_str(), serial.frames, serial.seconds * 1000.0 / serial.frames);
+        printf("      \"vertices\": %zu }", serial.vertices);
+        fflush(stdout);
+        first = false;
+
+        double singleMs = 0.0;
+        for (unsigned threads : threadCounts) {
+            std::unique_ptr<Jobs::JobSystem> jobs(new Jobs::JobSystem(threads));
+            SetJobSystem(jobs.get());
+            SceneResult r = Record(scene.batch, minSeconds);
+            SetJobSystem(nullptr);
+
+            double ms = r.seconds * 1000.0 / r.frames;
+            if (threads == 1) singleMs = ms;
+            Jobs::JobStats stats = jobs->GetStats();
+            printf(",\n    { \"scene\": \"%s\", \"mode\": \"batch\", \"threads\": %u, \"frames\": %zu, \"ms_per_frame\": %.3f,\n",
+                scene.name.c_str(), threads, r.frames, ms);
+            printf("      \"speedup\": %.2f, \"vertices\": %zu, \"ranges_per_frame\": %.1f, \"steals_per_frame\": %.1f,\n",
+                singleMs / ms, r.vertices, static_cast<double>(stats.ranges) / r.frames,
+                static_cast<double>(stats.steals) / r.frames);
+            printf("      \"matches_serial\": %s }", (r.hash == serial.hash && r.vertices == serial.vertices) ? "true" : "false");
+            fflush(stdout);
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
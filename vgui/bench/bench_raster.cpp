@@ -0,0 +1,110 @@
+// Throughput of the tile-binned software rasterizer (vgui_raster.cpp) on recorded VGUI frames.
+//
+// Build (Linux or any g++/clang, no D3D11 needed), from the vgui/ directory:
+//   g++ -std=c++17 -O2 -pthread -Ivgui bench/bench_raster.cpp vgui/vgui_draw.cpp vgui/vgui_render.cpp vgui/vgui_context.cpp vgui/vgui_jobs.cpp vgui/vgui_curves.cpp vgui/vgui_polygon.cpp vgui/vgui_arena.cpp vgui/vgui_raster.cpp -o vgui_bench_raster
+// Run:
+//   ./vgui_bench_raster [--filter <substring>] [--min-time <ms>] [--size <w>x<h>] [--max-threads <n>] > raster.json
+//
+// Every scene is recorded once into a DrawList, then submitted and rendered through a
+// Raster::RasterBackend until min-time is spent inside Render, for thread counts 1, 2, 4 ...
+// max-threads. Mpixels/s counts shaded fragments (overdraw included), overdraw is fragments per
+// framebuffer pixel.
+
+#include "bench_scenes.h"
+#include "vgui_draw.h"
+#include "vgui_raster.h"
+#include "vgui_render.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace VGUI;
+using namespace VGUI::Draw;
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    double minSeconds = 0.5;
+    int width = 1920, height = 1080;
+    unsigned maxThreads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) minSeconds = atof(argv[++i]) / 1000.0;
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &width, &height) == 2) i++;
+        else if (!strcmp(argv[i], "--max-threads") && i + 1 < argc) maxThreads = static_cast<unsigned>(atoi(argv[++i]));
+        else {
+            fprintf(stderr, "usage: %s [--filter <substring>] [--min-time <ms>] [--size <w>x<h>] [--max-threads <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxThreads == 0) maxThreads = 1;
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    SetDisplaySize(width, height);
+    std::vector<Scene> scenes = BuildScenes();
+
+    printf("{\n  \"benchmark\": \"vgui_raster\",\n");
+    printf("  \"width\": %d,\n  \"height\": %d,\n  \"tile_size\": %d,\n  \"hardware_threads\": %u,\n",
+        width, height, Raster::Rasterizer::TileSize, std::thread::hardware_concurrency());
+    printf("  \"results\": [");
+
+    bool first = true;
+    for (const Scene& scene : scenes) {
+        if (filter && scene.name.find(filter) == std::string::npos) continue;
+
+        DrawList list;
+        BeginDrawList(list);
+        scene.record(width, height);
+        EndDrawList();
+
+        for (unsigned threads : threadCounts) {
+            std::unique_ptr<Raster::Rasterizer> rasterizer(new Raster::Rasterizer(threads));
+            rasterizer->Resize(width, height);
+            Raster::RasterBackend backend(*rasterizer);
+            SetRenderBackend(&backend);
+
+            double seconds = 0.0, setupMs = 0.0, shadeMs = 0.0;
+            size_t frames = 0;
+            uint64_t fragments = 0;
+            Raster::RasterStats stats = {};
+            while (seconds < minSeconds || frames < 2) {
+                rasterizer->Clear(0);
+                SubmitDrawList(list);
+                Clock::time_point start = Clock::now();
+                Render();
+                seconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+                stats = rasterizer->GetStats();
+                setupMs += stats.setupMilliseconds;
+                shadeMs += stats.shadeMilliseconds;
+                fragments += stats.fragments;
+                frames++;
+            }
+            SetRenderBackend(nullptr);
+
+            double pixels = static_cast<double>(width) * height;
+            printf("%s\n    { \"scene\": \"%s\", \"threads\": %u, \"frames\": %zu, \"ms_per_frame\": %.3f,\n",
+                first ? "" : ",", scene.name.c_str(), threads, frames, seconds * 1000.0 / frames);
+            printf("      \"setup_ms\": %.3f, \"shade_ms\": %.3f, \"triangles\": %zu, \"shapes\": %zu, \"bin_entries\": %zu,\n",
+                setupMs / frames, shadeMs / frames, stats.triangles, stats.shapes, stats.binEntries);
+            printf("      \"full_tile_entries\": %zu, \"active_tiles\": %zu, \"fragments_per_frame\": %.0f,\n",
+                stats.fullTileEntries, stats.activeTiles, static_cast<double>(fragments) / frames);
+            printf("      \"overdraw\": %.3f, \"mpixels_per_sec\": %.1f }",
+                static_cast<double>(fragments) / frames / pixels, static_cast<double>(fragments) / seconds / 1e6);
+            fflush(stdout);
+            first = false;
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
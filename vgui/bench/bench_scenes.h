@@ -0,0 +1,78 @@
+// Recorded frames shared by the rasterizer, GL and Vulkan benchmarks: fill, shape and stroke heavy
+// scenes plus an overlay-like UI frame. Each scene records into the current frame or DrawList.
+#pragma once
+#include "vgui_draw.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+struct Scene {
+    std::string name;
+    std::function<void(int, int)> record;   // (width, height)
+};
+
+inline std::vector<Scene> BuildScenes() {
+    using namespace VGUI::Draw;
+    std::vector<Scene> scenes;
+
+    // Large translucent tessellated fills: blend bound, mostly full-tile bins
+    scenes.push_back({ "fill_rects", [](int w, int h) {
+        EnableShapeInstancing(false);
+        for (int i = 0; i < 16; i++)
+            DrawFilledRect(static_cast<float>(i * 8), static_cast<float>(i * 4), w * 0.8f, h * 0.8f, 0.2f, 0.4f, 0.8f, 0.25f);
+    } });
+
+    // Many small SDF circles: per-pixel coverage bound
+    scenes.push_back({ "sdf_circles", [](int w, int h) {
+        EnableShapeInstancing(true);
+        for (int i = 0; i < 4000; i++)
+            DrawFilledCircle(static_cast<float>((i * 37) % w), static_cast<float>((i * 91) % h), 8.0f, 0, 1.0f, 0.3f, 0.3f, 0.9f);
+    } });
+
+    // Tessellated anti-aliased circles: many small triangles, setup and binning bound
+    scenes.push_back({ "tess_circles", [](int w, int h) {
+        EnableShapeInstancing(false);
+        for (int i = 0; i < 2000; i++)
+            DrawFilledCircle(static_cast<float>((i * 37) % w), static_cast<float>((i * 91) % h), 12.0f, 32, 0.3f, 1.0f, 0.3f, 0.9f);
+    } });
+
+    // Anti-aliased strokes across the screen: thin sliver triangles spanning many tiles
+    scenes.push_back({ "strokes", [](int w, int h) {
+        for (int i = 0; i < 1000; i++) {
+            float y = static_cast<float>((i * 13) % h);
+            DrawThickLine(0, y, static_cast<float>(w), static_cast<float>(h) - y, 1.5f, 1.0f, 1.0f, 0.0f, 1.0f);
+        }
+    } });
+
+    // Thick zigzags with round joins and caps: one triangle strip per stroke, restarts in between
+    scenes.push_back({ "polylines", [](int w, int h) {
+        SetLineJoin(LineJoin::Round);
+        SetLineCap(LineCap::Round);
+        float points[32 * 2];
+        for (int i = 0; i < 200; i++) {
+            for (int p = 0; p < 32; p++) {
+                points[p * 2] = static_cast<float>(p * (w - 20)) / 31.0f + 10.0f;
+                points[p * 2 + 1] = static_cast<float>((i * 29) % h) + ((p & 1) ? 12.0f : -12.0f);
+            }
+            DrawPolyline(points, 32, false, 6.0f, 0.9f, 0.6f, 0.2f, 0.8f);
+        }
+        SetLineJoin(LineJoin::Miter);
+        SetLineCap(LineCap::Butt);
+    } });
+
+    // Overlay-like frame: the main.cpp panel repeated over the screen
+    scenes.push_back({ "ui_panels", [](int w, int h) {
+        EnableShapeInstancing(true);
+        for (float y = 10; y + 300 < h; y += 320) {
+            for (float x = 10; x + 400 < w; x += 420) {
+                DrawFilledRoundedRect(x, y, 400, 300, 15, 0.15f, 0.15f, 0.2f, 0.95f);
+                DrawRectThick(x, y, 400, 300, 2.0f, 0.4f, 0.8f, 1.0f, 1.0f);
+                DrawGradientRect(x, y, 400, 40, 0.3f, 0.6f, 0.9f, 1.0f, 0.2f, 0.4f, 0.7f, 1.0f, true);
+                DrawFilledCircle(x + 200, y + 150, 35, 32, 1.0f, 0.3f, 0.3f, 0.9f);
+                DrawBezierCurve(x + 20, y + 80, x + 120, y + 30, x + 280, y + 130, x + 380, y + 80, 32, 0.0f, 1.0f, 1.0f, 1.0f);
+            }
+        }
+    } });
+
+    return scenes;
+}
@@ -0,0 +1,419 @@
+// Headless Vulkan backend benchmark (vgui_render_vulkan.cpp). Needs no window system or GPU: on CI
+// it runs on Mesa lavapipe (or SwiftShader), selected through the loader's ICD environment.
+//
+// Build, from the vgui/ directory:
+//   g++ -std=c++17 -O2 -pthread -Ivgui bench/bench_vulkan.cpp vgui/vgui_draw.cpp vgui/vgui_render.cpp vgui/vgui_context.cpp vgui/vgui_jobs.cpp vgui/vgui_curves.cpp vgui/vgui_polygon.cpp vgui/vgui_arena.cpp vgui/vgui_render_vulkan.cpp vgui/vgui_raster.cpp -lvulkan -o vgui_bench_vulkan
+// Run:
+//   ./vgui_bench_vulkan [--device <substring>] [--frames-in-flight <n>] [--filter <substring>] [--min-time <ms>] [--size <w>x<h>] > vulkan.json
+//   (VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json selects lavapipe)
+//
+// Every scene is recorded once into a DrawList, then submitted and rendered into an RGBA8 image
+// until min-time is spent, with up to frames-in-flight frames queued: a frame only waits for the
+// fence of the frame that last used its slot, so recording overlaps GPU execution the way a
+// swapchain loop would. ms_per_frame is wall time per frame including that overlap, cpu_ms the
+// Render() call alone. The last frame is read back and compared with the software rasterizer:
+// max_diff is the largest color channel difference, mismatched_pixels counts pixels off by more
+// than 2. Alpha is left out, as in the GL benchmark.
+
+#include "bench_scenes.h"
+#include "vgui_draw.h"
+#include "vgui_raster.h"
+#include "vgui_render.h"
+#include "vgui_render_vulkan.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace VGUI;
+using namespace VGUI::Draw;
+
+typedef std::chrono::steady_clock Clock;
+
+struct VulkanContext {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    uint32_t queueFamily = 0;
+    VkPhysicalDeviceMemoryProperties memory = {};
+    char deviceName[256] = {};
+};
+
+static bool CreateContext(VulkanContext& vk, const char* deviceFilter) {
+    VkApplicationInfo app = {};
+    app.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app.pApplicationName = "vgui_bench_vulkan";
+    app.apiVersion = VK_API_VERSION_1_0;
+    VkInstanceCreateInfo instanceInfo = {};
+    instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    instanceInfo.pApplicationInfo = &app;
+    if (vkCreateInstance(&instanceInfo, nullptr, &vk.instance) != VK_SUCCESS) {
+        fprintf(stderr, "vkCreateInstance failed\n");
+        return false;
+    }
+
+    uint32_t count = 0;
+    vkEnumeratePhysicalDevices(vk.instance, &count, nullptr);
+    std::vector<VkPhysicalDevice> devices(count);
+    vkEnumeratePhysicalDevices(vk.instance, &count, devices.data());
+    for (VkPhysicalDevice device : devices) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device, &properties);
+        if (deviceFilter && !strstr(properties.deviceName, deviceFilter)) continue;
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+        for (uint32_t i = 0; i < familyCount; i++) {
+            if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                vk.physicalDevice = device;
+                vk.queueFamily = i;
+                memcpy(vk.deviceName, properties.deviceName, sizeof(vk.deviceName));
+                break;
+            }
+        }
+        if (vk.physicalDevice) break;
+    }
+    if (!vk.physicalDevice) {
+        fprintf(stderr, "no Vulkan device with a graphics queue\n");
+        return false;
+    }
+    vkGetPhysicalDeviceMemoryProperties(vk.physicalDevice, &vk.memory);
+
+    const float priority = 1.0f;
+    VkDeviceQueueCreateInfo queueInfo = {};
+    queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueInfo.queueFamilyIndex = vk.queueFamily;
+    queueInfo.queueCount = 1;
+    queueInfo.pQueuePriorities = &priority;
+    VkDeviceCreateInfo deviceInfo = {};
+    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.queueCreateInfoCount = 1;
+    deviceInfo.pQueueCreateInfos = &queueInfo;
+    if (vkCreateDevice(vk.physicalDevice, &deviceInfo, nullptr, &vk.device) != VK_SUCCESS) {
+        fprintf(stderr, "vkCreateDevice failed\n");
+        return false;
+    }
+    vkGetDeviceQueue(vk.device, vk.queueFamily, 0, &vk.queue);
+    return true;
+}
+
+static uint32_t FindMemoryType(const VulkanContext& vk, uint32_t typeBits, VkMemoryPropertyFlags flags) {
+    for (uint32_t i = 0; i < vk.memory.memoryTypeCount; i++) {
+        if ((typeBits & (1u << i)) && (vk.memory.memoryTypes[i].propertyFlags & flags) == flags) return i;
+    }
+    return UINT32_MAX;
+}
+
+static bool AllocateMemory(const VulkanContext& vk, const VkMemoryRequirements& requirements, VkMemoryPropertyFlags flags,
+    VkDeviceMemory& memory) {
+    VkMemoryAllocateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    info.allocationSize = requirements.size;
+    info.memoryTypeIndex = FindMemoryType(vk, requirements.memoryTypeBits, flags);
+    return info.memoryTypeIndex != UINT32_MAX && vkAllocateMemory(vk.device, &info, nullptr, &memory) == VK_SUCCESS;
+}
+
+// RGBA8 color target, its render pass and a host-visible buffer the last frame is copied to
+struct Target {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    VkBuffer readback = VK_NULL_HANDLE;
+    VkDeviceMemory readbackMemory = VK_NULL_HANDLE;
+    void* readbackData = nullptr;
+};
+
+static bool CreateTarget(const VulkanContext& vk, int width, int height, Target& target) {
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageInfo.extent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (vkCreateImage(vk.device, &imageInfo, nullptr, &target.image) != VK_SUCCESS) return false;
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(vk.device, target.image, &requirements);
+    if (!AllocateMemory(vk, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, target.imageMemory) ||
+        vkBindImageMemory(vk.device, target.image, target.imageMemory, 0) != VK_SUCCESS) {
+        return false;
+    }
+
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = target.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    if (vkCreateImageView(vk.device, &viewInfo, nullptr, &target.view) != VK_SUCCESS) return false;
+
+    // Cleared every frame, left ready for the readback copy
+    VkAttachmentDescription attachment = {};
+    attachment.format = VK_FORMAT_R8G8B8A8_UNORM;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    VkAttachmentReference colorRef = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    VkSubpassDependency dependencies[2] = {};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    VkRenderPassCreateInfo passInfo = {};
+    passInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    passInfo.attachmentCount = 1;
+    passInfo.pAttachments = &attachment;
+    passInfo.subpassCount = 1;
+    passInfo.pSubpasses = &subpass;
+    passInfo.dependencyCount = 2;
+    passInfo.pDependencies = dependencies;
+    if (vkCreateRenderPass(vk.device, &passInfo, nullptr, &target.renderPass) != VK_SUCCESS) return false;
+
+    VkFramebufferCreateInfo framebufferInfo = {};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = target.renderPass;
+    framebufferInfo.attachmentCount = 1;
+    framebufferInfo.pAttachments = &target.view;
+    framebufferInfo.width = static_cast<uint32_t>(width);
+    framebufferInfo.height = static_cast<uint32_t>(height);
+    framebufferInfo.layers = 1;
+    if (vkCreateFramebuffer(vk.device, &framebufferInfo, nullptr, &target.framebuffer) != VK_SUCCESS) return false;
+
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = static_cast<VkDeviceSize>(width) * height * 4;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (vkCreateBuffer(vk.device, &bufferInfo, nullptr, &target.readback) != VK_SUCCESS) return false;
+    vkGetBufferMemoryRequirements(vk.device, target.readback, &requirements);
+    return AllocateMemory(vk, requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        target.readbackMemory) &&
+        vkBindBufferMemory(vk.device, target.readback, target.readbackMemory, 0) == VK_SUCCESS &&
+        vkMapMemory(vk.device, target.readbackMemory, 0, VK_WHOLE_SIZE, 0, &target.readbackData) == VK_SUCCESS;
+}
+
+static void DestroyTarget(const VulkanContext& vk, Target& target) {
+    vkDestroyBuffer(vk.device, target.readback, nullptr);
+    vkFreeMemory(vk.device, target.readbackMemory, nullptr);
+    vkDestroyFramebuffer(vk.device, target.framebuffer, nullptr);
+    vkDestroyRenderPass(vk.device, target.renderPass, nullptr);
+    vkDestroyImageView(vk.device, target.view, nullptr);
+    vkDestroyImage(vk.device, target.image, nullptr);
+    vkFreeMemory(vk.device, target.imageMemory, nullptr);
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* deviceFilter = nullptr;
+    double minSeconds = 0.5;
+    int width = 1920, height = 1080;
+    uint32_t framesInFlight = 2;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if (!strcmp(argv[i], "--device") && i + 1 < argc) deviceFilter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) minSeconds = atof(argv[++i]) / 1000.0;
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &width, &height) == 2) i++;
+        else if (!strcmp(argv[i], "--frames-in-flight") && i + 1 < argc && atoi(argv[i + 1]) > 0) framesInFlight = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--device <substring>] [--frames-in-flight <n>] [--filter <substring>] [--min-time <ms>] [--size <w>x<h>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    VulkanContext vk;
+    Target target;
+    if (!CreateContext(vk, deviceFilter)) return 1;
+    if (!CreateTarget(vk, width, height, target)) {
+        fprintf(stderr, "cannot create the %dx%d render target\n", width, height);
+        return 1;
+    }
+
+    VulkanBackendDesc desc = {};
+    desc.getInstanceProcAddr = vkGetInstanceProcAddr;
+    desc.instance = vk.instance;
+    desc.physicalDevice = vk.physicalDevice;
+    desc.device = vk.device;
+    desc.queueFamilyIndex = vk.queueFamily;
+    desc.renderPass = target.renderPass;
+    desc.subpass = 0;
+    desc.framesInFlight = framesInFlight;
+    std::unique_ptr<VulkanBackend> backend(CreateVulkanBackend(desc));
+    if (!backend) {
+        fprintf(stderr, "CreateVulkanBackend failed\n");
+        return 1;
+    }
+
+    // One primary command buffer and fence per frame in flight, plus one for the readback
+    VkCommandPool pool = VK_NULL_HANDLE;
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = vk.queueFamily;
+    vkCreateCommandPool(vk.device, &poolInfo, nullptr, &pool);
+    std::vector<VkCommandBuffer> commandBuffers(framesInFlight + 1);
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = pool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = framesInFlight + 1;
+    vkAllocateCommandBuffers(vk.device, &allocInfo, commandBuffers.data());
+    std::vector<VkFence> fences(framesInFlight);
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    for (VkFence& fence : fences) vkCreateFence(vk.device, &fenceInfo, nullptr, &fence);
+
+    SetDisplaySize(width, height);
+    std::vector<Scene> scenes = BuildScenes();
+    Raster::Rasterizer reference;
+    Raster::RasterBackend referenceBackend(reference);
+
+    printf("{\n  \"benchmark\": \"vgui_vulkan\",\n");
+    printf("  \"device\": \"%s\",\n  \"frames_in_flight\": %u,\n  \"width\": %d,\n  \"height\": %d,\n",
+        vk.deviceName, framesInFlight, width, height);
+    printf("  \"results\": [");
+
+    uint64_t frameIndex = 0;
+    bool first = true;
+    for (const Scene& scene : scenes) {
+        if (filter && scene.name.find(filter) == std::string::npos) continue;
+
+        DrawList list;
+        BeginDrawList(list);
+        scene.record(width, height);
+        EndDrawList();
+
+        SetRenderBackend(backend.get());
+        double cpuSeconds = 0.0;
+        size_t frames = 0, drawCalls = 0;
+        Clock::time_point start = Clock::now();
+        while (std::chrono::duration<double>(Clock::now() - start).count() < minSeconds || frames < 2) {
+            // Only the frame that last used this slot has to be finished
+            uint32_t slot = static_cast<uint32_t>(frameIndex % framesInFlight);
+            vkWaitForFences(vk.device, 1, &fences[slot], VK_TRUE, UINT64_MAX);
+            vkResetFences(vk.device, 1, &fences[slot]);
+
+            VkCommandBuffer commandBuffer = commandBuffers[slot];
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            vkBeginCommandBuffer(commandBuffer, &beginInfo);
+            VkClearValue clear = {};
+            VkRenderPassBeginInfo passBegin = {};
+            passBegin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            passBegin.renderPass = target.renderPass;
+            passBegin.framebuffer = target.framebuffer;
+            passBegin.renderArea.extent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+            passBegin.clearValueCount = 1;
+            passBegin.pClearValues = &clear;
+            vkCmdBeginRenderPass(commandBuffer, &passBegin, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+            SubmitDrawList(list);
+            Clock::time_point render = Clock::now();
+            backend->BeginFrame(frameIndex, commandBuffer, target.framebuffer);
+            Render();
+            cpuSeconds += std::chrono::duration<double>(Clock::now() - render).count();
+
+            vkCmdEndRenderPass(commandBuffer);
+            vkEndCommandBuffer(commandBuffer);
+            VkSubmitInfo submit = {};
+            submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit.commandBufferCount = 1;
+            submit.pCommandBuffers = &commandBuffer;
+            vkQueueSubmit(vk.queue, 1, &submit, fences[slot]);
+            drawCalls = GetFrameStats().drawCalls;
+            frameIndex++;
+            frames++;
+        }
+        vkQueueWaitIdle(vk.queue);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // Copy the last frame to the readback buffer
+        VkCommandBuffer copyBuffer = commandBuffers[framesInFlight];
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(copyBuffer, &beginInfo);
+        VkBufferImageCopy region = {};
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        region.imageExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1 };
+        vkCmdCopyImageToBuffer(copyBuffer, target.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, target.readback, 1, &region);
+        VkMemoryBarrier hostRead = {};
+        hostRead.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        hostRead.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostRead.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(copyBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostRead,
+            0, nullptr, 0, nullptr);
+        vkEndCommandBuffer(copyBuffer);
+        VkSubmitInfo submit = {};
+        submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit.commandBufferCount = 1;
+        submit.pCommandBuffers = &copyBuffer;
+        vkQueueSubmit(vk.queue, 1, &submit, VK_NULL_HANDLE);
+        vkQueueWaitIdle(vk.queue);
+
+        // Same frame through the software rasterizer; Vulkan rows are top-down like its pixels
+        SetRenderBackend(&referenceBackend);
+        reference.Resize(width, height);
+        SubmitDrawList(list);
+        Render();
+        SetRenderBackend(nullptr);
+
+        const uint32_t* pixels = static_cast<const uint32_t*>(target.readbackData);
+        const uint32_t* expected = reference.GetPixels();
+        int maxDiff = 0;
+        size_t mismatched = 0;
+        for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+            int pixelDiff = 0;
+            for (int shift = 0; shift < 24; shift += 8) {
+                int diff = abs(static_cast<int>((pixels[i] >> shift) & 0xff) - static_cast<int>((expected[i] >> shift) & 0xff));
+                if (diff > pixelDiff) pixelDiff = diff;
+            }
+            if (pixelDiff > maxDiff) maxDiff = pixelDiff;
+            if (pixelDiff > 2) mismatched++;
+        }
+
+        printf("%s\n    { \"scene\": \"%s\", \"frames\": %zu, \"ms_per_frame\": %.3f, \"cpu_ms\": %.3f, \"draw_calls\": %zu,\n",
+            first ? "" : ",", scene.name.c_str(), frames, seconds * 1000.0 / frames, cpuSeconds * 1000.0 / frames, drawCalls);
+        printf("      \"max_diff\": %d, \"mismatched_pixels\": %zu }", maxDiff, mismatched);
+        fflush(stdout);
+        first = false;
+    }
+    printf("\n  ]\n}\n");
+
+    vkDeviceWaitIdle(vk.device);
+    backend.reset();
+    for (VkFence fence : fences) vkDestroyFence(vk.device, fence, nullptr);
+    vkDestroyCommandPool(vk.device, pool, nullptr);
+    DestroyTarget(vk, target);
+    vkDestroyDevice(vk.device, nullptr);
+    vkDestroyInstance(vk.instance, nullptr);
+    return 0;
+}
@@ -6,7 +6,11 @@
 #include <d3d11.h>
 #include "vgui/vgui_core.h"
 #include "vgui/vgui_draw.h"
+#include "vgui/vgui_pipeline.h"
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
 
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dwmapi.lib")
@@ -19,6 +23,11 @@ static ID3D11RenderTargetView* g_mainRenderTargetView = nullptr;
 
 static int g_WindowWidth = 0;
 static int g_WindowHeight = 0;
+static UINT g_BufferWidth = 0;
+static UINT g_BufferHeight = 0;
+
+// Start with --render-thread to record frame N + 1 while a render thread presents frame N
+static bool g_UseRenderThread = false;
 
 bool CreateDeviceD3D(HWND hWnd);
 void CleanupDeviceD3D();
@@ -42,7 +51,96 @@ bool GetWindowRect(HWND hWnd, int& x, int& y, int& width, int& height) {
     return false;
 }
 
+// Records the animated scene into the current frame (or the pipeline's slot)
+static void BuildScene(const VGUI::Draw::DrawList& panelChrome, float panelW, float animTime) {
+    // Main panel
+    float panelX = 50;
+    float panelY = 50;
+    VGUI::Draw::SubmitDrawList(panelChrome, panelX, panelY);
+
+    // Animated circle
+    float circleX = panelX + panelW / 2;
+    float circleY = panelY + 150;
+    float circleRadius = 30 + sinf(animTime * 2.0f) * 10;
+    VGUI::Draw::DrawFilledCircle(circleX, circleY, circleRadius, 32, 1.0f, 0.3f, 0.3f, 0.9f);
+    VGUI::Draw::DrawCircle(circleX, circleY, circleRadius + 5, 32, 1.0f, 1.0f, 0.0f, 1.0f);
+
+    // Bezier curve showcase
+    float bezStartX = panelX + 20;
+    float bezStartY = panelY + 80;
+    float bezEndX = panelX + panelW - 20;
+    float bezEndY = panelY + 80;
+    float ctrlOffset = sinf(animTime) * 50;
+
+    VGUI::Draw::DrawBezierCurve(
+        bezStartX, bezStartY,
+        bezStartX + 100, bezStartY - 50 + ctrlOffset,
+        bezEndX - 100, bezStartY + 50 - ctrlOffset,
+        bezEndX, bezEndY,
+        32, 0.0f, 1.0f, 1.0f, 1.0f
+    );
+
+    // Status indicators
+    for (int i = 0; i < 5; i++) {
+        float indicatorX = panelX + 20 + i * 30;
+        float indicatorY = panelY + 20;
+        float phase = animTime * 3.0f - i * 0.5f;
+        float brightness = (sinf(phase) + 1.0f) * 0.5f;
+        VGUI::Draw::DrawFilledCircle(indicatorX, indicatorY, 8, 16, 0.2f + brightness * 0.8f, 0.8f, 0.2f, 1.0f);
+    }
+}
+
+// Draws the recorded frame and presents it. Returns false when nothing changed since the last
+// presented frame: upload, draw and present are skipped and the caller waits for the compositor.
+static bool PresentFrame() {
+    if (!VGUI::Draw::FrameChanged()) {
+        VGUI::Draw::DiscardFrame();
+        return false;
+    }
+
+    // The swap chain is resized here rather than in WM_SIZE, so only the thread that presents
+    // touches it
+    int width, height;
+    VGUI::Core::GetWindowSize(width, height);
+    if (width > 0 && height > 0 && ((UINT)width != g_BufferWidth || (UINT)height != g_BufferHeight)) {
+        CleanupRenderTarget();
+        g_pSwapChain->ResizeBuffers(0, (UINT)width, (UINT)height, DXGI_FORMAT_UNKNOWN, 0);
+        CreateRenderTarget();
+    }
+
+    const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.01f };
+    g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
+    g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, clear_color);
+
+    D3D11_VIEWPORT vp;
+    vp.Width = (FLOAT)width;
+    vp.Height = (FLOAT)height;
+    vp.MinDepth = 0.0f;
+    vp.MaxDepth = 1.0f;
+    vp.TopLeftX = 0;
+    vp.TopLeftY = 0;
+    g_pd3dDeviceContext->RSSetViewports(1, &vp);
+
+    // Render everything
+    VGUI::Draw::Render();
+
+    g_pSwapChain->Present(1, 0);
+    return true;
+}
+
+// Render thread of --render-thread mode: owns the D3D11 immediate context and the swap chain
+static void RenderThreadMain(VGUI::FramePipeline* pipeline, VGUI::Context* context) {
+    VGUI::ContextScope scope(*context);
+    while (pipeline->AcquireFrame()) {
+        if (!PresentFrame())
+            DwmFlush();
+        pipeline->ReleaseFrame();
+    }
+}
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
+    g_UseRenderThread = lpCmdLine && strstr(lpCmdLine, "--render-thread") != nullptr;
+
     HWND hNotepad = FindNotepadWindow();
     if (!hNotepad) {
         MessageBoxA(nullptr, "Notepad.exe not found! Please open Notepad first.", "Error", MB_OK | MB_ICONERROR);
@@ -92,6 +190,53 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     bool done = false;
     float animTime = 0.0f;
 
+    // Main panel with rounded corners. The static chrome is recorded once relative to the
+    // panel origin and replayed every frame instead of being re-tessellated.
+    float panelW = 400;
+    float panelH = 300;
+
+    VGUI::Draw::DrawList panelChrome;
+    VGUI::Draw::BeginDrawList(panelChrome);
+    {
+        VGUI::Draw::DrawFilledRoundedRect(0, 0, panelW, panelH, 15, 0.15f, 0.15f, 0.2f, 0.95f);
+        VGUI::Draw::DrawRectThick(0, 0, panelW, panelH, 2.0f, 0.4f, 0.8f, 1.0f, 1.0f);
+
+        // Title bar gradient
+        VGUI::Draw::DrawGradientRect(0, 0, panelW, 40,
+            0.3f, 0.6f, 0.9f, 1.0f,
+            0.2f, 0.4f, 0.7f, 1.0f,
+            true);
+
+        // Thick line test
+        VGUI::Draw::DrawThickLine(20, panelH - 40, panelW - 20, panelH - 40,
+            4.0f, 0.2f, 1.0f, 0.2f, 1.0f);
+
+        // Triangle
+        float triX = panelW - 80;
+        float triY = panelH - 80;
+        VGUI::Draw::DrawFilledTriangle(triX, triY, triX + 30, triY + 40, triX - 30, triY + 40,
+            1.0f, 0.5f, 0.0f, 0.8f);
+
+        // Polygon (pentagon)
+        float polyPoints[10] = {
+            80, panelH - 30,
+            100, panelH - 50,
+            90, panelH - 70,
+            70, panelH - 70,
+            60, panelH - 50
+        };
+        VGUI::Draw::DrawFilledPolygon(polyPoints, 5, 0.8f, 0.2f, 0.8f, 0.9f);
+    }
+    VGUI::Draw::EndDrawList();
+
+    // The render thread draws with the context Initialize() set up; this thread only records
+    VGUI::FramePipeline* pipeline = nullptr;
+    std::thread renderThread;
+    if (g_UseRenderThread) {
+        pipeline = new VGUI::FramePipeline(VGUI::GetCurrentContext());
+        renderThread = std::thread(RenderThreadMain, pipeline, &VGUI::GetCurrentContext());
+    }
+
     while (!done) {
         MSG msg;
         while (PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE)) {
@@ -109,98 +254,42 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                 SetWindowPos(hwnd, HWND_TOPMOST, nx, ny, nw, nh, SWP_NOACTIVATE);
                 g_WindowWidth = nw;
                 g_WindowHeight = nh;
-                VGUI::Core::SetWindowSize(nw, nh);
+                if (!pipeline)
+                    VGUI::Core::SetWindowSize(nw, nh);
             }
         }
         else {
             done = true;
         }
 
-        const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.01f };
-        g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
-        g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, clear_color);
-
-        D3D11_VIEWPORT vp;
-        vp.Width = (FLOAT)g_WindowWidth;
-        vp.Height = (FLOAT)g_WindowHeight;
-        vp.MinDepth = 0.0f;
-        vp.MaxDepth = 1.0f;
-        vp.TopLeftX = 0;
-        vp.TopLeftY = 0;
-        g_pd3dDeviceContext->RSSetViewports(1, &vp);
-
         animTime += 0.016f;
 
-        // Main panel with rounded corners
-        float panelX = 50;
-        float panelY = 50;
-        float panelW = 400;
-        float panelH = 300;
-
-        VGUI::Draw::DrawFilledRoundedRect(panelX, panelY, panelW, panelH, 15, 0.15f, 0.15f, 0.2f, 0.95f);
-        VGUI::Draw::DrawRectThick(panelX, panelY, panelW, panelH, 2.0f, 0.4f, 0.8f, 1.0f, 1.0f);
-
-        // Title bar gradient
-        VGUI::Draw::DrawGradientRect(panelX, panelY, panelW, 40,
-            0.3f, 0.6f, 0.9f, 1.0f,
-            0.2f, 0.4f, 0.7f, 1.0f,
-            true);
-
-        // Animated circle
-        float circleX = panelX + panelW / 2;
-        float circleY = panelY + 150;
-        float circleRadius = 30 + sinf(animTime * 2.0f) * 10;
-        VGUI::Draw::DrawFilledCircle(circleX, circleY, circleRadius, 32, 1.0f, 0.3f, 0.3f, 0.9f);
-        VGUI::Draw::DrawCircle(circleX, circleY, circleRadius + 5, 32, 1.0f, 1.0f, 0.0f, 1.0f);
-
-        // Bezier curve showcase
-        float bezStartX = panelX + 20;
-        float bezStartY = panelY + 80;
-        float bezEndX = panelX + panelW - 20;
-        float bezEndY = panelY + 80;
-        float ctrlOffset = sinf(animTime) * 50;
-
-        VGUI::Draw::DrawBezierCurve(
-            bezStartX, bezStartY,
-            bezStartX + 100, bezStartY - 50 + ctrlOffset,
-            bezEndX - 100, bezStartY + 50 - ctrlOffset,
-            bezEndX, bezEndY,
-            32, 0.0f, 1.0f, 1.0f, 1.0f
-        );
-
-        // Thick line test
-        VGUI::Draw::DrawThickLine(panelX + 20, panelY + panelH - 40, panelX + panelW - 20, panelY + panelH - 40,
-            4.0f, 0.2f, 1.0f, 0.2f, 1.0f);
-
-        // Triangle
-        float triX = panelX + panelW - 80;
-        float triY = panelY + panelH - 80;
-        VGUI::Draw::DrawFilledTriangle(triX, triY, triX + 30, triY + 40, triX - 30, triY + 40,
-            1.0f, 0.5f, 0.0f, 0.8f);
-
-        // Polygon (pentagon)
-        float polyPoints[10] = {
-            panelX + 80, panelY + panelH - 30,
-            panelX + 100, panelY + panelH - 50,
-            panelX + 90, panelY + panelH - 70,
-            panelX + 70, panelY + panelH - 70,
-            panelX + 60, panelY + panelH - 50
-        };
-        VGUI::Draw::DrawFilledPolygon(polyPoints, 5, 0.8f, 0.2f, 0.8f, 0.9f);
-
-        // Status indicators
-        for (int i = 0; i < 5; i++) {
-            float indicatorX = panelX + 20 + i * 30;
-            float indicatorY = panelY + 20;
-            float phase = animTime * 3.0f - i * 0.5f;
-            float brightness = (sinf(phase) + 1.0f) * 0.5f;
-            VGUI::Draw::DrawFilledCircle(indicatorX, indicatorY, 8, 16, 0.2f + brightness * 0.8f, 0.8f, 0.2f, 1.0f);
+        if (pipeline) {
+            // The render thread presents the previous frame meanwhile; the frame carries its size
+            if (!pipeline->BeginFrame()) break;
+            BuildScene(panelChrome, panelW, animTime);
+            pipeline->EndFrame(g_WindowWidth, g_WindowHeight);
+            continue;
         }
 
-        // Render everything
-        VGUI::Draw::Render();
+        BuildScene(panelChrome, panelW, animTime);
+        if (!PresentFrame())
+            DwmFlush();
+    }
 
-        g_pSwapChain->Present(1, 0);
+    if (pipeline) {
+        pipeline->Stop();
+        renderThread.join();
+
+        VGUI::FramePipelineStats stats = pipeline->GetStats();
+        double recorded = stats.framesRecorded ? (double)stats.framesRecorded : 1.0;
+        double rendered = stats.framesRendered ? (double)stats.framesRendered : 1.0;
+        char line[256];
+        snprintf(line, sizeof(line), "VGUI: %llu frames, record %.2f ms, render %.2f ms, latency %.2f ms (waits: record %.2f ms, render %.2f ms)\n",
+            (unsigned long long)stats.framesRendered, stats.recordMilliseconds / recorded, stats.renderMilliseconds / rendered,
+            stats.latencyMilliseconds / rendered, stats.recordWaitMilliseconds / recorded, stats.renderWaitMilliseconds / rendered);
+        OutputDebugStringA(line);
+        delete pipeline;
     }
 
     VGUI::Core::Cleanup();
@@ -251,6 +340,11 @@ void CreateRenderTarget() {
     ID3D11Texture2D* pBackBuffer;
     g_pSwapChain->GetBuffer(0, IID_PPV_ARGS(&pBackBuffer));
     g_pd3dDevice->CreateRenderTargetView(pBackBuffer, nullptr, &g_mainRenderTargetView);
+
+    D3D11_TEXTURE2D_DESC desc;
+    pBackBuffer->GetDesc(&desc);
+    g_BufferWidth = desc.Width;
+    g_BufferHeight = desc.Height;
     pBackBuffer->Release();
 }
 
@@ -261,11 +355,7 @@ void CleanupRenderTarget() {
 LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_SIZE:
-        if (g_pd3dDevice != nullptr && wParam != SIZE_MINIMIZED) {
-            CleanupRenderTarget();
-            g_pSwapChain->ResizeBuffers(0, (UINT)LOWORD(lParam), (UINT)HIWORD(lParam), DXGI_FORMAT_UNKNOWN, 0);
-            CreateRenderTarget();
-        }
+        // PresentFrame() resizes the swap chain to the size the frame was recorded for
         return 0;
     case WM_DESTROY:
         PostQuitMessage(0);
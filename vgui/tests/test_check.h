@@ -0,0 +1,30 @@
+#pragma once
+// Check counting for the programs in tests/ (one translation unit each, no framework). A test calls
+// Check() for every expectation and returns CheckSummary() from main(): it prints every failure,
+// then the totals, and exits with 1 if a check failed. Build lines are in README.md.
+#include <cstdarg>
+#include <cstdio>
+
+inline int g_Checks = 0;
+inline int g_Failures = 0;
+
+#if defined(__GNUC__)
+__attribute__((format(printf, 2, 3)))
+#endif
+inline bool Check(bool ok, const char* format, ...) {
+    g_Checks++;
+    if (ok) return true;
+    g_Failures++;
+    va_list args;
+    va_start(args, format);
+    printf("FAIL ");
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+    return false;
+}
+
+inline int CheckSummary() {
+    printf("%d checks, %d failures\n", g_Checks, g_Failures);
+    return g_Failures ? 1 : 0;
+}
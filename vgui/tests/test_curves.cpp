@@ -0,0 +1,144 @@
+// Checks that adaptive flattening (Curves::FlattenCubicBezier / FlattenQuadraticBezier) stays within
+// its tolerance on the curves that are hard for it: cusps, near-cusps, double inflections and curves
+// that end where they start.
+//
+// The error of a flattening is measured both ways: from dense samples of the curve to the polyline,
+// and from samples along the polyline to the curve. Fixed curves from bug reports come first, then
+// a sweep over integer-grid cubics keeps the ones with a cusp or two inflections.
+
+#include "test_check.h"
+#include "vgui_curves.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace VGUI;
+
+static const int MaxSegments = 64;     // as Draw::DrawBezierCurve
+static const int CurveSamples = 2000;
+static const float Tolerances[] = { 0.1f, 0.25f, 1.0f };
+
+static double SegmentDistance(double px, double py, double ax, double ay, double bx, double by) {
+    const double dx = bx - ax, dy = by - ay;
+    const double length2 = dx * dx + dy * dy;
+    double t = (length2 > 0.0) ? ((px - ax) * dx + (py - ay) * dy) / length2 : 0.0;
+    t = (t < 0.0) ? 0.0 : (t > 1.0) ? 1.0 : t;
+    const double ex = ax + dx * t - px, ey = ay + dy * t - py;
+    return sqrt(ex * ex + ey * ey);
+}
+
+static double PolylineDistance(double x, double y, const std::vector<double>& polyline) {
+    double best = 1e30;
+    for (size_t i = 0; i + 3 < polyline.size(); i += 2)
+        best = std::min(best, SegmentDistance(x, y, polyline[i], polyline[i + 1], polyline[i + 2], polyline[i + 3]));
+    return best;
+}
+
+// Largest distance between the curve (samples) and the flattened polyline, measured both ways
+static double FlatteningError(const std::vector<double>& curve, const std::vector<double>& polyline) {
+    double error = 0.0;
+    for (size_t i = 0; i < curve.size(); i += 2)
+        error = std::max(error, PolylineDistance(curve[i], curve[i + 1], polyline));
+    for (size_t i = 0; i + 3 < polyline.size(); i += 2) {
+        for (int s = 0; s <= 8; s++) {
+            const double u = s / 8.0;
+            const double x = polyline[i] + (polyline[i + 2] - polyline[i]) * u;
+            const double y = polyline[i + 1] + (polyline[i + 3] - polyline[i + 1]) * u;
+            error = std::max(error, PolylineDistance(x, y, curve));
+        }
+    }
+    return error;
+}
+
+// degree 2 or 3, control points x, y interleaved
+static void CheckCurve(const char* name, const float* p, int degree) {
+    std::vector<double> curve;
+    for (int i = 0; i <= CurveSamples; i++) {
+        const double t = static_cast<double>(i) / CurveSamples, mt = 1.0 - t;
+        for (int axis = 0; axis < 2; axis++) {
+            curve.push_back((degree == 2)
+                ? mt * mt * p[axis] + 2.0 * mt * t * p[2 + axis] + t * t * p[4 + axis]
+                : mt * mt * mt * p[axis] + 3.0 * mt * mt * t * p[2 + axis] + 3.0 * mt * t * t * p[4 + axis] + t * t * t * p[6 + axis]);
+        }
+    }
+
+    std::string controlPoints;
+    for (int i = 0; i <= degree * 2 + 1; i++) {
+        char value[32];
+        snprintf(value, sizeof(value), i ? ", %g" : "%g", p[i]);
+        controlPoints += value;
+    }
+
+    for (float tolerance : Tolerances) {
+        float points[MaxSegments * 2];
+        const int count = (degree == 2)
+            ? Curves::FlattenQuadraticBezier(p[0], p[1], p[2], p[3], p[4], p[5], tolerance, points, MaxSegments)
+            : Curves::FlattenCubicBezier(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], tolerance, points, MaxSegments);
+        // At the segment cap the tolerance is not promised
+        if (count >= MaxSegments) continue;
+
+        std::vector<double> polyline = { p[0], p[1] };
+        polyline.insert(polyline.end(), points, points + count * 2);
+        const double error = FlatteningError(curve, polyline);
+        Check(error <= tolerance, "%s (%s) tolerance %g: %d segments, error %.3f",
+            name, controlPoints.c_str(), tolerance, count, error);
+    }
+}
+
+// Cusp when cross(B', B'') has a double root in (0, 1), double inflection when it has two roots
+enum class CubicKind { Other, Cusp, DoubleInflection };
+
+static CubicKind Classify(const float* p) {
+    const double ax = p[2] - p[0], ay = p[3] - p[1];
+    const double bx = p[4] - 2.0 * p[2] + p[0], by = p[5] - 2.0 * p[3] + p[1];
+    const double cx = p[6] - 3.0 * (p[4] - p[2]) - p[0], cy = p[7] - 3.0 * (p[5] - p[3]) - p[1];
+    const double qa = bx * cy - by * cx, qb = ax * cy - ay * cx, qc = ax * by - ay * bx;
+    if (qa == 0.0) return CubicKind::Other;
+    const double discriminant = qb * qb - 4.0 * qa * qc;
+    const double vertex = -qb / (2.0 * qa);
+    if (fabs(discriminant) <= 1e-3 * qb * qb) return (vertex > 0.0 && vertex < 1.0) ? CubicKind::Cusp : CubicKind::Other;
+    if (discriminant < 0.0) return CubicKind::Other;
+    const double root = sqrt(discriminant);
+    const double t0 = (-qb - root) / (2.0 * qa), t1 = (-qb + root) / (2.0 * qa);
+    return (t0 > 0.0 && t0 < 1.0 && t1 > 0.0 && t1 < 1.0) ? CubicKind::DoubleInflection : CubicKind::Other;
+}
+
+int main() {
+    // Cusps whose inflection discriminant came out at 0 used to flatten to one straight segment
+    const float cusp[8] = { 120, 175, 160, 95, 140, 100, 150, 115 };
+    const float symmetricCusp[8] = { 0, 0, 100, 100, 0, 100, 100, 0 };
+    // Two inflections 0.01 apart: a hook the polyline used to cut off
+    const float hook[8] = { 140, 2, 153, 185, 62, 30, 78, 56 };
+    // A hairpin halfway between two inflections
+    const float hairpin[8] = { 59, 139, 178, 71, 169, 63, 64, 161 };
+    // Curves that end where they start
+    const float closedQuad[6] = { 164, 56, 62, 156, 164, 56 };
+    const float closedCubic[8] = { 50, 50, 150, 50, 150, 150, 50, 50 };
+    CheckCurve("cusp", cusp, 3);
+    CheckCurve("symmetric cusp", symmetricCusp, 3);
+    CheckCurve("hook", hook, 3);
+    CheckCurve("hairpin", hairpin, 3);
+    CheckCurve("closed quadratic", closedQuad, 2);
+    CheckCurve("closed cubic", closedCubic, 3);
+
+    std::mt19937 rng(1);
+    int cusps = 0, doubleInflections = 0;
+    const int PerKind = 300;
+    while (cusps < PerKind || doubleInflections < PerKind) {
+        float p[8];
+        for (float& v : p) v = static_cast<float>(rng() % 200);
+        const CubicKind kind = Classify(p);
+        if (kind == CubicKind::Cusp && cusps < PerKind) {
+            cusps++;
+            CheckCurve("cusp sweep", p, 3);
+        }
+        else if (kind == CubicKind::DoubleInflection && doubleInflections < PerKind) {
+            doubleInflections++;
+            CheckCurve("double inflection sweep", p, 3);
+        }
+    }
+
+    return CheckSummary();
+}
@@ -0,0 +1,87 @@
+// Checks that contexts which record frames for another context (FramePipeline, ThreadRecorder) end
+// those frames for their caches: the triangulation cache drops outlines that stopped being drawn,
+// and the polygon cache counts reach the rendering context's FrameStats.
+//
+// Both threads' sides run on one thread here; the slots and published lists are handed over the same
+// way. Every frame draws a few concave outlines that change each frame and one that never does.
+
+#include "test_check.h"
+#include "vgui_context.h"
+#include "vgui_pipeline.h"
+#include <cmath>
+
+using namespace VGUI;
+
+static const int Frames = 500;
+static const int AnimatedPolygons = 10;
+static const int PolygonPoints = 100;    // cached from 64 points on
+
+// A star whose spikes wobble with phase, so every phase and size is a different outline
+static void DrawStar(float cx, float cy, float size, float phase) {
+    float points[PolygonPoints * 2];
+    for (int i = 0; i < PolygonPoints; i++) {
+        const float angle = 6.2831853f * i / PolygonPoints;
+        const float radius = (i % 2) ? 20.0f : size + 5.0f * sinf(phase + i);
+        points[i * 2] = cx + radius * cosf(angle);
+        points[i * 2 + 1] = cy + radius * sinf(angle);
+    }
+    Draw::DrawFilledPolygon(points, PolygonPoints, 1.0f, 1.0f, 1.0f);
+}
+
+static void DrawScene(int frame) {
+    for (int i = 0; i < AnimatedPolygons; i++)
+        DrawStar(50.0f + 90.0f * i, 100.0f, 30.0f + i, 0.1f * frame);
+    DrawStar(500.0f, 300.0f, 40.0f, 0.0f);
+}
+
+// The target only counts, so every frame is rendered and none is discarded as unchanged
+static void CheckFrame(const char* name, int frame, const Context& recorder) {
+    const Draw::FrameStats& stats = Draw::GetFrameStats();
+    const size_t misses = AnimatedPolygons + (frame == 0 ? 1 : 0);
+    const size_t hits = (frame == 0) ? 0 : 1;
+    const size_t maxEntries = (Polygon::TriangulationCache::MaxUnusedFrames + 1) * AnimatedPolygons + 1;
+    const size_t entries = recorder.triangulationCache.GetEntryCount();
+    Check(stats.polygonCacheMisses == misses, "%s polygon cache misses, frame %d: %zu, expected %zu",
+        name, frame, stats.polygonCacheMisses, misses);
+    Check(stats.polygonCacheHits == hits, "%s polygon cache hits, frame %d: %zu, expected %zu",
+        name, frame, stats.polygonCacheHits, hits);
+    Check(entries <= maxEntries, "%s recorder cache entries, frame %d: %zu, at most %zu",
+        name, frame, entries, maxEntries);
+}
+
+static void TestFramePipeline() {
+    Context target;
+    ContextScope scope(target);
+    FramePipeline pipeline(target);
+    for (int frame = 0; frame < Frames; frame++) {
+        pipeline.BeginFrame();
+        DrawScene(frame);
+        pipeline.EndFrame(1280, 720);
+
+        pipeline.AcquireFrame();
+        Draw::Render();
+        CheckFrame("pipeline", frame, pipeline.GetRecordContext());
+        pipeline.ReleaseFrame();
+    }
+}
+
+static void TestThreadRecorder() {
+    Context target;
+    ContextScope scope(target);
+    ThreadRecorder recorder(target, 0);
+    for (int frame = 0; frame < Frames; frame++) {
+        recorder.Begin();
+        DrawScene(frame);
+        recorder.End();
+
+        Draw::Render();
+        CheckFrame("recorder", frame, recorder.GetContext());
+    }
+}
+
+int main() {
+    TestFramePipeline();
+    TestThreadRecorder();
+
+    return CheckSummary();
+}
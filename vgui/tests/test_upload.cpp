@@ -0,0 +1,241 @@
+// Checks Upload::RingBuffer against a mock UploadDevice: no-overwrite placement within a frame,
+// wrapping to the start once fences retire old frames, the discard fallback when nothing has
+// retired, and growth to NextPow2(frame bytes x headroomFrames).
+//
+// Scripted frames check each policy with exact offsets. Then a random workload, with the GPU up to
+// six frames behind, checks that no no-overwrite map touches bytes a frame in flight still owns.
+
+#include "test_check.h"
+#include "vgui_upload.h"
+#include <random>
+#include <vector>
+
+using namespace VGUI;
+
+static void CheckEqual(const char* what, unsigned long long value, unsigned long long expected) {
+    Check(value == expected, "%s: %llu, expected %llu", what, value, expected);
+}
+
+// Buffer in system memory; the test sets how far the "GPU" has got in completed
+class MockDevice : public Upload::UploadDevice {
+public:
+    bool CreateBuffer(size_t capacity) override {
+        m_Storage.assign(capacity, 0);
+        creations++;
+        return true;
+    }
+    void* Map(bool discard) override {
+        lastDiscard = discard;
+        return m_Storage.data();
+    }
+    void Unmap() override {}
+    uint64_t SignalFence() override { return ++signalled; }
+    uint64_t GetCompletedFence() override { return completed; }
+
+    size_t GetSize() const { return m_Storage.size(); }
+
+    uint64_t signalled = 0;
+    uint64_t completed = 0;
+    uint64_t creations = 0;
+    bool lastDiscard = false;
+
+private:
+    std::vector<unsigned char> m_Storage;
+};
+
+static size_t MapBytes(Upload::RingBuffer& ring, size_t size, size_t alignment) {
+    size_t offset = ~static_cast<size_t>(0);
+    void* data = ring.Map(size, alignment, offset);
+    Check(data != nullptr, "map of %zu bytes failed", size);
+    ring.Unmap();
+    return offset;
+}
+
+// First map creates the buffer and discards; later maps in the frame follow on without discarding
+static void TestNoOverwrite() {
+    MockDevice device;
+    Upload::RingBuffer ring(&device, 1024, 3);
+
+    CheckEqual("first map offset", MapBytes(ring, 100, 16), 0);
+    CheckEqual("first map discards", device.lastDiscard, 1);
+    CheckEqual("buffer created once", device.creations, 1);
+    CheckEqual("capacity raised to the minimum", ring.GetCapacity(), 1024);
+    CheckEqual("device buffer size", device.GetSize(), 1024);
+
+    CheckEqual("second map offset, aligned after the first", MapBytes(ring, 100, 16), 112);
+    CheckEqual("second map is no-overwrite", device.lastDiscard, 0);
+    CheckEqual("odd alignment", MapBytes(ring, 10, 24), 216);
+    ring.EndFrame();
+    CheckEqual("frame bytes include alignment padding", ring.GetStats().bytesThisFrame, 226);
+    CheckEqual("frames in flight", ring.GetStats().framesInFlight, 1);
+
+    CheckEqual("next frame continues at the head", MapBytes(ring, 50, 1), 226);
+    CheckEqual("next frame is no-overwrite", device.lastDiscard, 0);
+    CheckEqual("no discards", ring.GetStats().discards, 0);
+}
+
+// Three frames fill most of the ring; the next map only fits at the start once frames retire
+static void TestWrapAndRetire() {
+    MockDevice device;
+    Upload::RingBuffer ring(&device, 1024, 3);
+
+    MapBytes(ring, 300, 16);
+    ring.EndFrame();                                        // fence 1: [0, 300)
+    CheckEqual("frame 2 offset", MapBytes(ring, 300, 16), 304);
+    ring.EndFrame();                                        // fence 2: [300, 604)
+    CheckEqual("frame 3 offset", MapBytes(ring, 300, 16), 608);
+    ring.EndFrame();                                        // fence 3: [604, 908)
+    CheckEqual("frames in flight before retiring", ring.GetStats().framesInFlight, 3);
+
+    // 200 bytes do not fit after the head; frame 1 retiring frees [0, 300)
+    device.completed = 1;
+    CheckEqual("wrapped map offset", MapBytes(ring, 200, 16), 0);
+    CheckEqual("wrapped map is no-overwrite", device.lastDiscard, 0);
+    CheckEqual("wraps", ring.GetStats().wraps, 1);
+    CheckEqual("no discards while wrapping", ring.GetStats().discards, 0);
+    ring.EndFrame();                                        // fence 4: [908, 1024) and [0, 200)
+    CheckEqual("frames in flight after retiring", ring.GetStats().framesInFlight, 3);
+    CheckEqual("wrap padding owned by the frame", ring.GetStats().bytesThisFrame, (1024 - 908) + 200);
+
+    // Frame 2 retiring frees [300, 604) behind the wrapped frame
+    device.completed = 2;
+    CheckEqual("map after wrap", MapBytes(ring, 100, 16), 208);
+    CheckEqual("map after wrap is no-overwrite", device.lastDiscard, 0);
+    ring.EndFrame();
+    CheckEqual("frames in flight", ring.GetStats().framesInFlight, 3);
+    CheckEqual("capacity unchanged", ring.GetCapacity(), 1024);
+    CheckEqual("buffer created once", device.creations, 1);
+}
+
+// When the GPU has not finished any frame the ring orphans the buffer instead of waiting
+static void TestDiscardFallback() {
+    MockDevice device;
+    Upload::RingBuffer ring(&device, 1024, 3);
+
+    MapBytes(ring, 300, 16);
+    ring.EndFrame();
+    MapBytes(ring, 300, 16);
+    ring.EndFrame();
+    MapBytes(ring, 300, 16);
+    ring.EndFrame();
+
+    CheckEqual("discard map offset", MapBytes(ring, 300, 16), 0);
+    CheckEqual("discard map discards", device.lastDiscard, 1);
+    CheckEqual("discards", ring.GetStats().discards, 1);
+    CheckEqual("no wraps", ring.GetStats().wraps, 0);
+    CheckEqual("no buffer created", device.creations, 1);
+    ring.EndFrame();
+    CheckEqual("orphaned frames forgotten", ring.GetStats().framesInFlight, 1);
+
+    // After the discard only the new frame is live, so no-overwrite maps resume behind it
+    CheckEqual("map after discard", MapBytes(ring, 100, 16), 304);
+    CheckEqual("map after discard is no-overwrite", device.lastDiscard, 0);
+}
+
+// Frames over capacity / headroomFrames grow the buffer at the next map, and so do single maps
+// larger than the buffer
+static void TestGrowth() {
+    MockDevice device;
+    Upload::RingBuffer ring(&device, 1024, 3);
+
+    MapBytes(ring, 300, 16);
+    MapBytes(ring, 300, 16);
+    ring.EndFrame();
+    CheckEqual("frame bytes", ring.GetStats().bytesThisFrame, 604);
+    CheckEqual("growth waits for the next map", ring.GetCapacity(), 1024);
+
+    CheckEqual("map after growth offset", MapBytes(ring, 100, 16), 0);
+    CheckEqual("grown to NextPow2(604 x 3)", ring.GetCapacity(), 2048);
+    CheckEqual("device buffer size", device.GetSize(), 2048);
+    CheckEqual("buffer created again", device.creations, 2);
+    CheckEqual("new buffer is discarded", device.lastDiscard, 1);
+    ring.EndFrame();
+    CheckEqual("old frames forgotten with the old buffer", ring.GetStats().framesInFlight, 1);
+
+    CheckEqual("oversized map offset", MapBytes(ring, 5000, 64), 0);
+    CheckEqual("grown to NextPow2((5000 + 64) x 3)", ring.GetCapacity(), 16384);
+    CheckEqual("buffer created for the oversized map", device.creations, 3);
+
+    // A frame that fits within the headroom leaves the capacity alone
+    ring.EndFrame();
+    MapBytes(ring, 1000, 16);
+    ring.EndFrame();
+    MapBytes(ring, 16, 16);
+    CheckEqual("steady capacity", ring.GetCapacity(), 16384);
+    CheckEqual("no more buffers", device.creations, 3);
+    CheckEqual("peak frame bytes", ring.GetStats().peakFrameBytes, 5000);
+}
+
+// Random frames with the GPU a varying number of frames behind. Every no-overwrite map must avoid
+// the bytes of the frames not yet completed and of the open frame; a discard map orphans them all.
+static void TestRandomFrames() {
+    struct Range {
+        uint64_t fence;     // 0 while the frame is open
+        size_t begin;
+        size_t end;
+    };
+
+    MockDevice device;
+    Upload::RingBuffer ring(&device, 4096, 3);
+    std::mt19937 rng(1);
+    const size_t alignments[] = { 1, 4, 16, 256 };
+    std::vector<Range> live;
+    int overlaps = 0, misaligned = 0, outOfBounds = 0;
+
+    for (int frame = 0; frame < 2000; frame++) {
+        // Bursts of larger frames now and then, so the ring wraps, discards and grows
+        const size_t maxSize = (frame % 200 < 20) ? 3000 : 600;
+        const int maps = 1 + static_cast<int>(rng() % 6);
+        for (int m = 0; m < maps; m++) {
+            const size_t size = 1 + rng() % maxSize;
+            const size_t alignment = alignments[rng() % 4];
+            const uint64_t creations = device.creations;
+            size_t offset = 0;
+            if (!ring.Map(size, alignment, offset)) {
+                Check(false, "random map of %zu bytes failed", size);
+                continue;
+            }
+            ring.Unmap();
+
+            if (device.lastDiscard || device.creations != creations) {
+                live.clear();
+            }
+            else {
+                for (const Range& range : live)
+                    if (offset < range.end && range.begin < offset + size) overlaps++;
+            }
+            if (offset % alignment != 0) misaligned++;
+            if (offset + size > ring.GetCapacity()) outOfBounds++;
+            live.push_back({ 0, offset, offset + size });
+        }
+
+        ring.EndFrame();
+        for (Range& range : live)
+            if (range.fence == 0) range.fence = device.signalled;
+        // The GPU lags one to six frames behind and never goes backwards
+        const uint64_t lag = 1 + rng() % 6;
+        if (device.signalled > lag && device.signalled - lag > device.completed) device.completed = device.signalled - lag;
+        std::vector<Range> pending;
+        for (const Range& range : live)
+            if (range.fence > device.completed) pending.push_back(range);
+        live.swap(pending);
+    }
+
+    CheckEqual("random maps overlapping live data", overlaps, 0);
+    CheckEqual("random maps misaligned", misaligned, 0);
+    CheckEqual("random maps out of bounds", outOfBounds, 0);
+    const Upload::RingStats& stats = ring.GetStats();
+    Check(stats.wraps > 0, "random frames never wrapped");
+    Check(stats.discards > 0, "random frames never discarded");
+    Check(stats.bufferCreations > 1, "random frames never grew the buffer");
+}
+
+int main() {
+    TestNoOverwrite();
+    TestWrapAndRetire();
+    TestDiscardFallback();
+    TestGrowth();
+    TestRandomFrames();
+
+    return CheckSummary();
+}
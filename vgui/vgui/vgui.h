@@ -1,6 +1,7 @@
 #pragma once
 #include "vgui_core.h"
 #include "vgui_draw.h"
+#include "vgui_context.h"
 #include "vgui_streamproof.h"
 
 // Convenience namespace that exposes everything
@@ -0,0 +1,87 @@
+#include "vgui_arena.h"
+
+namespace VGUI {
+    namespace Memory {
+        static size_t AlignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        static size_t NextPow2(size_t value) {
+            size_t result = 1;
+            while (result < value) result <<= 1;
+            return result;
+        }
+
+        FrameArena::FrameArena(size_t minBlockSize) : m_MinBlockSize(minBlockSize ? minBlockSize : 1) {
+        }
+
+        // Moves past the current block to one with room for size bytes: the next one if it is big
+        // enough, otherwise a new block inserted before it. Blocks at least double the capacity.
+        void FrameArena::NextBlock(size_t size) {
+            if (m_Block < m_Blocks.size()) {
+                m_BlockBase += m_Blocks[m_Block].size;
+                m_Block++;
+            }
+            m_Offset = 0;
+            if (m_Block < m_Blocks.size() && m_Blocks[m_Block].size >= size) return;
+
+            size_t blockSize = NextPow2(size);
+            if (blockSize < m_MinBlockSize) blockSize = m_MinBlockSize;
+            if (blockSize < m_Stats.capacity) blockSize = NextPow2(m_Stats.capacity);
+            m_Blocks.insert(m_Blocks.begin() + m_Block, Block{ std::unique_ptr<unsigned char[]>(new unsigned char[blockSize]), blockSize });
+            m_Stats.capacity += blockSize;
+            m_Stats.blockAllocations++;
+        }
+
+        void* FrameArena::Allocate(size_t size, size_t alignment) {
+            size_t start = AlignUp(m_Offset, alignment);
+            if (m_Block >= m_Blocks.size() || start + size > m_Blocks[m_Block].size) {
+                // Block data is aligned for any type, so a new block starts at offset 0
+                NextBlock(size);
+                start = 0;
+            }
+            m_Offset = start + size;
+            size_t used = m_BlockBase + m_Offset;
+            if (used > m_Stats.frameBytes) m_Stats.frameBytes = used;
+            return m_Blocks[m_Block].data.get() + start;
+        }
+
+        bool FrameArena::TryExtend(void* ptr, size_t oldSize, size_t newSize) {
+            if (m_Block >= m_Blocks.size()) return false;
+            unsigned char* data = m_Blocks[m_Block].data.get();
+            unsigned char* p = static_cast<unsigned char*>(ptr);
+            if (p + oldSize != data + m_Offset) return false;
+            size_t start = static_cast<size_t>(p - data);
+            if (start + newSize > m_Blocks[m_Block].size) return false;
+
+            m_Offset = start + newSize;
+            size_t used = m_BlockBase + m_Offset;
+            if (used > m_Stats.frameBytes) m_Stats.frameBytes = used;
+            return true;
+        }
+
+        void FrameArena::Rewind(const Marker& marker) {
+            m_Block = marker.block;
+            m_Offset = marker.offset;
+            m_BlockBase = marker.blockBase;
+        }
+
+        void FrameArena::Reset() {
+            m_Stats.lastFrameBytes = m_Stats.frameBytes;
+            if (m_Stats.frameBytes > m_Stats.peakFrameBytes) m_Stats.peakFrameBytes = m_Stats.frameBytes;
+            m_Stats.frameBytes = 0;
+            m_Block = 0;
+            m_Offset = 0;
+            m_BlockBase = 0;
+
+            // One block as big as all of them, so the next frame of this size stays in it
+            if (m_Blocks.size() > 1) {
+                size_t blockSize = NextPow2(m_Stats.capacity);
+                m_Blocks.clear();
+                m_Blocks.push_back(Block{ std::unique_ptr<unsigned char[]>(new unsigned char[blockSize]), blockSize });
+                m_Stats.capacity = blockSize;
+                m_Stats.blockAllocations++;
+            }
+        }
+    }
+}
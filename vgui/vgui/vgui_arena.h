@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace VGUI {
+    namespace Memory {
+        struct ArenaStats {
+            size_t capacity;            // bytes in all blocks
+            size_t frameBytes;          // high-water mark of the open frame
+            size_t lastFrameBytes;      // ... of the frame the last Reset() closed
+            size_t peakFrameBytes;      // highest high-water mark of any frame
+            uint64_t blockAllocations;  // heap allocations made for blocks
+        };
+
+        // Bump allocator for scratch memory that lives at most until the end of a frame, such as
+        // the normals, stroke stations and triangles a Draw* call builds before writing vertices.
+        // Memory comes from a list of blocks. When a frame needed more than one, Reset() replaces
+        // them with a single block of their combined size, so steady-state frames make no heap
+        // allocations. Mark() / Rewind() (see ArenaScope) hand memory back before the frame ends.
+        // Allocations are aligned to at most alignof(std::max_align_t). Not thread-safe.
+        class FrameArena {
+        public:
+            struct Marker {
+                size_t block;
+                size_t offset;
+                size_t blockBase;
+            };
+
+            explicit FrameArena(size_t minBlockSize = 64 * 1024);
+            FrameArena(const FrameArena&) = delete;
+            FrameArena& operator=(const FrameArena&) = delete;
+
+            // size bytes aligned to alignment (a power of two); the memory is uninitialized
+            void* Allocate(size_t size, size_t alignment);
+
+            template <typename T>
+            T* AllocateArray(size_t count) {
+                static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                    "arena memory is never constructed or destroyed");
+                return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+            }
+
+            // Grows the allocation at ptr to newSize bytes when it is the newest one and its block
+            // has room; otherwise returns false and leaves it alone
+            bool TryExtend(void* ptr, size_t oldSize, size_t newSize);
+
+            Marker Mark() const { return { m_Block, m_Offset, m_BlockBase }; }
+            // Releases everything allocated since marker was taken
+            void Rewind(const Marker& marker);
+
+            // Ends the frame: releases everything and merges the blocks
+            void Reset();
+
+            const ArenaStats& GetStats() const { return m_Stats; }
+
+        private:
+            struct Block {
+                std::unique_ptr<unsigned char[]> data;
+                size_t size;
+            };
+
+            void NextBlock(size_t size);
+
+            std::vector<Block> m_Blocks;
+            size_t m_MinBlockSize;
+            size_t m_Block = 0;         // block allocations come from
+            size_t m_Offset = 0;        // next free byte in it
+            size_t m_BlockBase = 0;     // bytes of the blocks before it, counted as used
+            ArenaStats m_Stats = {};
+        };
+
+        // Rewinds the arena to where it was on construction, e.g. at the end of a Draw* call
+        class ArenaScope {
+        public:
+            explicit ArenaScope(FrameArena& arena) : m_Arena(arena), m_Marker(arena.Mark()) {}
+            ~ArenaScope() { m_Arena.Rewind(m_Marker); }
+            ArenaScope(const ArenaScope&) = delete;
+            ArenaScope& operator=(const ArenaScope&) = delete;
+
+        private:
+            FrameArena& m_Arena;
+            FrameArena::Marker m_Marker;
+        };
+
+        // Growable array of trivially copyable T in a FrameArena, the scratch counterpart of
+        // std::vector. While it is the newest allocation it grows in place, otherwise it moves into
+        // twice the room and its old storage stays dead until the arena rewinds. resize() leaves new
+        // elements uninitialized. Valid until its arena rewinds past it.
+        template <typename T>
+        class ArenaVector {
+            static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                "ArenaVector never constructs or destroys its elements");
+
+        public:
+            explicit ArenaVector(FrameArena& arena) : m_Arena(&arena) {}
+
+            size_t size() const { return m_Size; }
+            bool empty() const { return m_Size == 0; }
+            T* data() { return m_Data; }
+            const T* data() const { return m_Data; }
+            T* begin() { return m_Data; }
+            T* end() { return m_Data + m_Size; }
+            const T* begin() const { return m_Data; }
+            const T* end() const { return m_Data + m_Size; }
+            T& operator[](size_t i) { return m_Data[i]; }
+            const T& operator[](size_t i) const { return m_Data[i]; }
+            T& front() { return m_Data[0]; }
+            T& back() { return m_Data[m_Size - 1]; }
+
+            void reserve(size_t capacity) {
+                if (capacity <= m_Capacity) return;
+                if (m_Data && m_Arena->TryExtend(m_Data, m_Capacity * sizeof(T), capacity * sizeof(T))) {
+                    m_Capacity = capacity;
+                    return;
+                }
+                T* data = m_Arena->AllocateArray<T>(capacity);
+                if (m_Size > 0) memcpy(data, m_Data, m_Size * sizeof(T));
+                m_Data = data;
+                m_Capacity = capacity;
+            }
+
+            void resize(size_t size) {
+                if (size > m_Capacity) reserve((size > m_Capacity * 2) ? size : m_Capacity * 2);
+                m_Size = size;
+            }
+
+            void push_back(const T& value) {
+                if (m_Size == m_Capacity) {
+                    const T copy = value;   // value may live in the old storage
+                    reserve(m_Capacity ? m_Capacity * 2 : 16);
+                    m_Data[m_Size++] = copy;
+                    return;
+                }
+                m_Data[m_Size++] = value;
+            }
+
+            void clear() { m_Size = 0; }
+
+        private:
+            FrameArena* m_Arena;
+            T* m_Data = nullptr;
+            size_t m_Size = 0;
+            size_t m_Capacity = 0;
+        };
+    }
+}
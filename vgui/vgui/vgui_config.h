@@ -0,0 +1,7 @@
+#pragma once
+
+// Compile-time options. Uncomment here or define them in the project's preprocessor settings.
+
+// Keep vertex colors as four floats (24-byte vertices) instead of packed RGBA8 (12 bytes).
+// Only needed when rendering to float / HDR targets where 8 bits per channel are not enough.
+//#define VGUI_VERTEX_FLOAT_COLOR
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "vgui_context.h"
+
+namespace VGUI {
+    // nullptr means the default context, so threads that never pick one share it as before
+    static thread_local Context* g_CurrentContext = nullptr;
+
+    Context::Context() : current(&frameList), backend(&nullBackend) {
+    }
+
+    Context::~Context() {
+        if (g_CurrentContext == this) g_CurrentContext = nullptr;
+    }
+
+    Context& GetDefaultContext() {
+        static Context defaultContext;
+        return defaultContext;
+    }
+
+    void SetCurrentContext(Context* ctx) {
+        g_CurrentContext = ctx;
+    }
+
+    Context& GetCurrentContext() {
+        return g_CurrentContext ? *g_CurrentContext : GetDefaultContext();
+    }
+
+    ThreadRecorder::ThreadRecorder(Context& target, int order) : m_Target(target) {
+        m_Node.list = &m_List;
+        m_Node.order = order;
+        m_Node.sequence = target.publisherCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool ThreadRecorder::Begin() {
+        // The target still reads the last list; acquire pairs with its release once merged
+        if (m_Node.pending.load(std::memory_order_acquire)) return false;
+        m_Previous = &GetCurrentContext();
+        SetCurrentContext(&m_Context);
+        Draw::BeginDrawList(m_List);
+        return true;
+    }
+
+    void ThreadRecorder::End() {
+        m_Node.stats = Draw::EndRecordedFrame();
+        SetCurrentContext(m_Previous);
+        if (m_List.commands.empty()) return;
+
+        m_Node.pending.store(true, std::memory_order_relaxed);
+        PublishedList* head = m_Target.published.load(std::memory_order_relaxed);
+        do {
+            m_Node.next = head;
+        } while (!m_Target.published.compare_exchange_weak(head, &m_Node,
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "vgui_draw.h"
+#include "vgui_render.h"
+#include "vgui_polygon.h"
+#include "vgui_arena.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace VGUI {
+    // A DrawList another thread handed to a context's Render(), see ThreadRecorder
+    struct PublishedList {
+        const Draw::DrawList* list = nullptr;
+        int order = 0;
+        uint32_t sequence = 0;              // creation order, breaks ties between equal orders
+        // Added to the target's FrameStats when the list is merged
+        Draw::RecordedFrameStats stats = {};
+        PublishedList* next = nullptr;
+        std::atomic<bool> pending{ false }; // set until the target has merged the list
+    };
+
+    // Where one shape of a batch (Draw::DrawFilledCircles...) lands, planned before tessellation
+    struct BatchPrimitive {
+        size_t vertexStart;
+        size_t indexStart;
+        size_t windowBase;
+        uint64_t hash;                      // geometry hash, filled in by the job that writes it
+    };
+
+    // One cross-section of a stroke (Draw::DrawPolyline...): its edges at half width w lie at
+    // (x, y) + (ax, ay) * w on one side and (x, y) + (bx, by) * w on the other. Along a straight
+    // run both are the segment normal with opposite signs; joins and caps turn them.
+    struct StrokeStation {
+        float x, y;
+        float ax, ay;
+        float bx, by;
+    };
+
+    // Everything one renderer owns: the frame being recorded, settings, statistics, frame change
+    // detection and the render backend. The free functions in Draw:: and Core:: work on the calling
+    // thread's current context, which is a process-wide default one until SetCurrentContext() picks
+    // another. Several overlays in one process, or recording on worker threads, each get their own
+    // context; a context may only be used by one thread at a time.
+    struct Context {
+        Context();
+        ~Context();
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+
+        // Recording
+        Draw::DrawList frameList;
+        Draw::DrawList* current;        // list the Draw* calls record into
+        float globalAlpha = 1.0f;
+        bool antiAlias = true;
+        bool shapeInstancing = true;
+        float curveTolerance = 0.25f;   // max pixel error of AutoSegments circles, curves and corners
+        Draw::LineJoin lineJoin = Draw::LineJoin::Miter;
+        Draw::LineCap lineCap = Draw::LineCap::Butt;
+        float miterLimit = 4.0f;
+        int displayWidth = 0;
+        int displayHeight = 0;
+
+        // Batches (Draw::DrawFilledCircles...) are tessellated on jobs when set, see Draw::SetJobSystem
+        Jobs::JobSystem* jobs = nullptr;
+
+        // Tessellation scratch (normals, stroke stations, batch plans, triangles...). Draw* calls
+        // release theirs on return with an ArenaScope; Render() and DiscardFrame() reset it, and
+        // so does Draw::EndRecordedFrame() for recording contexts.
+        Memory::FrameArena scratch;
+
+        // Concave Draw::DrawFilledPolygon outlines, see Polygon::TriangulationCache
+        Polygon::TriangulationCache triangulationCache;
+        size_t polygonCacheHits = 0;                // this frame, including merged recorder lists
+        size_t polygonCacheMisses = 0;
+
+        // Frame change detection and statistics
+        uint64_t lastFrameHash = 0;
+        bool hasLastFrame = false;
+        uint64_t skippedFrames = 0;
+        Draw::FrameStats frameStats = {};
+
+        // Lists published by other threads for the next frame. Publishers push onto the stack
+        // with a CAS, the rendering thread takes all of it with one exchange (no ABA, no locks).
+        std::atomic<PublishedList*> published{ nullptr };
+        std::atomic<uint32_t> publisherCount{ 0 };
+        std::vector<PublishedList*> mergeScratch;
+
+        // Render() goes through backend, which is nullBackend when none is set. Core::Initialize
+        // creates one the context owns; SetRenderBackend() ones stay owned by the caller.
+        Draw::NullBackend nullBackend;
+        Draw::RenderBackend* backend;
+        std::unique_ptr<Draw::RenderBackend> ownedBackend;
+
+        // Native handles of the host's device, set by Core::Initialize (ID3D11Device* and
+        // ID3D11DeviceContext* there)
+        void* device = nullptr;
+        void* deviceContext = nullptr;
+    };
+
+    // Makes ctx current on the calling thread; nullptr selects the default context
+    void SetCurrentContext(Context* ctx);
+    Context& GetCurrentContext();
+    Context& GetDefaultContext();
+
+    // Makes a context current for a scope and restores the previous one
+    class ContextScope {
+    public:
+        explicit ContextScope(Context& ctx) : m_Previous(&GetCurrentContext()) { SetCurrentContext(&ctx); }
+        ~ContextScope() { SetCurrentContext(m_Previous); }
+        ContextScope(const ContextScope&) = delete;
+        ContextScope& operator=(const ContextScope&) = delete;
+
+    private:
+        Context* m_Previous;
+    };
+
+    // Records the Draw* calls of one thread (telemetry, annotations, HUD...) for a context that
+    // renders on another thread. Between Begin() and End() the recorder's own context is current,
+    // so settings and geometry stay private to the thread. End() publishes the list without
+    // locking; the target's next FrameChanged() or Render() appends it after the target's own
+    // frame, ordered by `order` and then by recorder creation. Until then Begin() returns false
+    // and the thread skips the frame. The target must outlive the recorder, and a recorder must
+    // not be destroyed while IsPending().
+    class ThreadRecorder {
+    public:
+        ThreadRecorder(Context& target, int order);
+        ThreadRecorder(const ThreadRecorder&) = delete;
+        ThreadRecorder& operator=(const ThreadRecorder&) = delete;
+
+        bool Begin();
+        void End();
+        bool IsPending() const { return m_Node.pending.load(std::memory_order_acquire); }
+
+        // Settings (global alpha, anti-aliasing...) used while recording
+        Context& GetContext() { return m_Context; }
+
+    private:
+        Context& m_Target;
+        Context m_Context;
+        Context* m_Previous = nullptr;
+        Draw::DrawList m_List;
+        PublishedList m_Node;
+    };
+}
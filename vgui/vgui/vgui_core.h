@@ -11,12 +11,5 @@ namespace VGUI {
         ID3D11Device* GetDevice();
         ID3D11DeviceContext* GetContext();
         void GetWindowSize(int& width, int& height);
-
-        // Shader pipeline access
-        ID3D11InputLayout* GetInputLayout();
-        ID3D11VertexShader* GetVertexShader();
-        ID3D11PixelShader* GetPixelShader();
-        ID3D11BlendState* GetBlendState();
-        ID3D11RasterizerState* GetRasterizerState();
     }
 }
\ No newline at end of file
@@ -0,0 +1,941 @@
+#include "vgui_curves.h"
+#include <atomic>
+#include <cmath>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define VGUI_HAS_SSE2 1
+#else
+#define VGUI_HAS_SSE2 0
+#endif
+
+// AVX2 kernels are compiled for the function only and picked at runtime, so the rest of the
+// library keeps running on CPUs without AVX2
+#if VGUI_HAS_SSE2 && (defined(_MSC_VER) || defined(__GNUC__))
+#define VGUI_HAS_AVX2 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#define VGUI_TARGET_AVX2
+#else
+#define VGUI_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define VGUI_HAS_AVX2 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define VGUI_HAS_NEON 1
+#else
+#define VGUI_HAS_NEON 0
+#endif
+
+namespace VGUI {
+    namespace Curves {
+        // Range reduction to [-pi/4, pi/4] by multiples of pi/2, the constant split in three so
+        // j * PiOver2A is exact (Cody-Waite); then the Cephes single precision polynomials
+        constexpr float TwoOverPi = 0.636619772367581343f;
+        constexpr float PiOver2A = 1.5703125f;
+        constexpr float PiOver2B = 4.837512969970703125e-4f;
+        constexpr float PiOver2C = 7.54978995489188216e-8f;
+        constexpr float SinC1 = -1.6666654611e-1f;
+        constexpr float SinC2 = 8.3321608736e-3f;
+        constexpr float SinC3 = -1.9515295891e-4f;
+        constexpr float CosC1 = 4.166664568298827e-2f;
+        constexpr float CosC2 = -1.388731625493765e-3f;
+        constexpr float CosC3 = 2.443315711809948e-5f;
+
+        // Every kernel below mirrors this expression by expression so their results match bit for bit
+        static inline void SinCosOne(float x, float& cosOut, float& sinOut) {
+            int q = static_cast<int>(lrintf(x * TwoOverPi));
+            float j = static_cast<float>(q);
+            float y = ((x - j * PiOver2A) - j * PiOver2B) - j * PiOver2C;
+            float z = y * y;
+            float sp = ((SinC3 * z + SinC2) * z + SinC1) * (y * z) + y;
+            float cp = ((CosC3 * z + CosC2) * z + CosC1) * (z * z) + (1.0f - 0.5f * z);
+
+            // Quadrant: odd ones swap sin and cos, then the signs follow the quadrant
+            float s = (q & 1) ? cp : sp;
+            float c = (q & 1) ? sp : cp;
+            sinOut = (q & 2) ? -s : s;
+            cosOut = ((q + 1) & 2) ? -c : c;
+        }
+
+        // Compile-time twin of SinCosOne for the precomputed tables (lrintf is not constexpr)
+        static constexpr int RoundToEven(float v) {
+            int q = static_cast<int>(v);
+            if (static_cast<float>(q) > v) q--;
+            float frac = v - static_cast<float>(q);
+            if (frac > 0.5f || (frac == 0.5f && (q & 1))) q++;
+            return q;
+        }
+
+        static constexpr void SinCosConst(float x, float& cosOut, float& sinOut) {
+            int q = RoundToEven(x * TwoOverPi);
+            float j = static_cast<float>(q);
+            float y = ((x - j * PiOver2A) - j * PiOver2B) - j * PiOver2C;
+            float z = y * y;
+            float sp = ((SinC3 * z + SinC2) * z + SinC1) * (y * z) + y;
+            float cp = ((CosC3 * z + CosC2) * z + CosC1) * (z * z) + (1.0f - 0.5f * z);
+
+            float s = (q & 1) ? cp : sp;
+            float c = (q & 1) ? sp : cp;
+            sinOut = (q & 2) ? -s : s;
+            cosOut = ((q + 1) & 2) ? -c : c;
+        }
+
+        static inline void BezierOne(const float* p, int i, float n, float* out) {
+            float t = static_cast<float>(i) / n;
+            float t2 = t * t;
+            float t3 = t2 * t;
+            float mt = 1.0f - t;
+            float mt2 = mt * mt;
+            float mt3 = mt2 * mt;
+            out[0] = mt3 * p[0] + 3.0f * mt2 * t * p[2] + 3.0f * mt * t2 * p[4] + t3 * p[6];
+            out[1] = mt3 * p[1] + 3.0f * mt2 * t * p[3] + 3.0f * mt * t2 * p[5] + t3 * p[7];
+        }
+
+        static void SinCosScalar(float startAngle, float angleStep, int count, float* cosOut, float* sinOut) {
+            for (int i = 0; i < count; i++)
+                SinCosOne(startAngle + static_cast<float>(i) * angleStep, cosOut[i], sinOut[i]);
+        }
+
+        // p holds the 4 control points, point 0 is copied so the curve starts exactly on it
+        static void BezierScalar(const float* p, int segments, float* points) {
+            const float n = static_cast<float>(segments);
+            points[0] = p[0];
+            points[1] = p[1];
+            for (int i = 1; i <= segments; i++) BezierOne(p, i, n, points + i * 2);
+        }
+
+#if VGUI_HAS_SSE2
+        static inline void SinCos4(__m128 x, __m128& cosOut, __m128& sinOut) {
+            const __m128i one = _mm_set1_epi32(1);
+            const __m128i two = _mm_set1_epi32(2);
+            __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TwoOverPi)));
+            __m128 j = _mm_cvtepi32_ps(q);
+            __m128 y = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(PiOver2A))),
+                _mm_mul_ps(j, _mm_set1_ps(PiOver2B))), _mm_mul_ps(j, _mm_set1_ps(PiOver2C)));
+            __m128 z = _mm_mul_ps(y, y);
+            __m128 sp = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SinC3), z), _mm_set1_ps(SinC2));
+            sp = _mm_add_ps(_mm_mul_ps(sp, z), _mm_set1_ps(SinC1));
+            sp = _mm_add_ps(_mm_mul_ps(sp, _mm_mul_ps(y, z)), y);
+            __m128 cp = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(CosC3), z), _mm_set1_ps(CosC2));
+            cp = _mm_add_ps(_mm_mul_ps(cp, z), _mm_set1_ps(CosC1));
+            cp = _mm_add_ps(_mm_mul_ps(cp, _mm_mul_ps(z, z)), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)));
+
+            __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+            __m128 s = _mm_or_ps(_mm_and_ps(swap, cp), _mm_andnot_ps(swap, sp));
+            __m128 c = _mm_or_ps(_mm_and_ps(swap, sp), _mm_andnot_ps(swap, cp));
+            sinOut = _mm_xor_ps(s, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30)));
+            cosOut = _mm_xor_ps(c, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30)));
+        }
+
+        static void SinCosSSE2(float startAngle, float angleStep, int count, float* cosOut, float* sinOut) {
+            const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+            int i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128 index = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane);
+                __m128 c, s;
+                SinCos4(_mm_add_ps(_mm_set1_ps(startAngle), _mm_mul_ps(index, _mm_set1_ps(angleStep))), c, s);
+                _mm_storeu_ps(cosOut + i, c);
+                _mm_storeu_ps(sinOut + i, s);
+            }
+            for (; i < count; i++)
+                SinCosOne(startAngle + static_cast<float>(i) * angleStep, cosOut[i], sinOut[i]);
+        }
+
+        static void BezierSSE2(const float* p, int segments, float* points) {
+            const float n = static_cast<float>(segments);
+            const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 three = _mm_set1_ps(3.0f);
+            points[0] = p[0];
+            points[1] = p[1];
+            int i = 1;
+            for (; i + 4 <= segments + 1; i += 4) {
+                __m128 t = _mm_div_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane), _mm_set1_ps(n));
+                __m128 t2 = _mm_mul_ps(t, t);
+                __m128 t3 = _mm_mul_ps(t2, t);
+                __m128 mt = _mm_sub_ps(one, t);
+                __m128 mt2 = _mm_mul_ps(mt, mt);
+                __m128 mt3 = _mm_mul_ps(mt2, mt);
+                __m128 b1 = _mm_mul_ps(_mm_mul_ps(three, mt2), t);
+                __m128 b2 = _mm_mul_ps(_mm_mul_ps(three, mt), t2);
+                __m128 x = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(mt3, _mm_set1_ps(p[0])), _mm_mul_ps(b1, _mm_set1_ps(p[2]))),
+                    _mm_mul_ps(b2, _mm_set1_ps(p[4]))), _mm_mul_ps(t3, _mm_set1_ps(p[6])));
+                __m128 y = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(mt3, _mm_set1_ps(p[1])), _mm_mul_ps(b1, _mm_set1_ps(p[3]))),
+                    _mm_mul_ps(b2, _mm_set1_ps(p[5]))), _mm_mul_ps(t3, _mm_set1_ps(p[7])));
+                _mm_storeu_ps(points + i * 2, _mm_unpacklo_ps(x, y));
+                _mm_storeu_ps(points + i * 2 + 4, _mm_unpackhi_ps(x, y));
+            }
+            for (; i <= segments; i++) BezierOne(p, i, n, points + i * 2);
+        }
+#endif
+
+#if VGUI_HAS_AVX2
+        VGUI_TARGET_AVX2 static inline void SinCos8(__m256 x, __m256& cosOut, __m256& sinOut) {
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i two = _mm256_set1_epi32(2);
+            __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TwoOverPi)));
+            __m256 j = _mm256_cvtepi32_ps(q);
+            __m256 y = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(x, _mm256_mul_ps(j, _mm256_set1_ps(PiOver2A))),
+                _mm256_mul_ps(j, _mm256_set1_ps(PiOver2B))), _mm256_mul_ps(j, _mm256_set1_ps(PiOver2C)));
+            __m256 z = _mm256_mul_ps(y, y);
+            __m256 sp = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(SinC3), z), _mm256_set1_ps(SinC2));
+            sp = _mm256_add_ps(_mm256_mul_ps(sp, z), _mm256_set1_ps(SinC1));
+            sp = _mm256_add_ps(_mm256_mul_ps(sp, _mm256_mul_ps(y, z)), y);
+            __m256 cp = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(CosC3), z), _mm256_set1_ps(CosC2));
+            cp = _mm256_add_ps(_mm256_mul_ps(cp, z), _mm256_set1_ps(CosC1));
+            cp = _mm256_add_ps(_mm256_mul_ps(cp, _mm256_mul_ps(z, z)),
+                _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), z)));
+
+            __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+            __m256 s = _mm256_blendv_ps(sp, cp, swap);
+            __m256 c = _mm256_blendv_ps(cp, sp, swap);
+            sinOut = _mm256_xor_ps(s, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30)));
+            cosOut = _mm256_xor_ps(c, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30)));
+        }
+
+        VGUI_TARGET_AVX2 static void SinCosAVX2(float startAngle, float angleStep, int count, float* cosOut, float* sinOut) {
+            const __m256 lane = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+            int i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 index = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane);
+                __m256 c, s;
+                SinCos8(_mm256_add_ps(_mm256_set1_ps(startAngle), _mm256_mul_ps(index, _mm256_set1_ps(angleStep))), c, s);
+                _mm256_storeu_ps(cosOut + i, c);
+                _mm256_storeu_ps(sinOut + i, s);
+            }
+            for (; i < count; i++)
+                SinCosOne(startAngle + static_cast<float>(i) * angleStep, cosOut[i], sinOut[i]);
+        }
+
+        VGUI_TARGET_AVX2 static void BezierAVX2(const float* p, int segments, float* points) {
+            const float n = static_cast<float>(segments);
+            const __m256 lane = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 three = _mm256_set1_ps(3.0f);
+            points[0] = p[0];
+            points[1] = p[1];
+            int i = 1;
+            for (; i + 8 <= segments + 1; i += 8) {
+                __m256 t = _mm256_div_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane), _mm256_set1_ps(n));
+                __m256 t2 = _mm256_mul_ps(t, t);
+                __m256 t3 = _mm256_mul_ps(t2, t);
+                __m256 mt = _mm256_sub_ps(one, t);
+                __m256 mt2 = _mm256_mul_ps(mt, mt);
+                __m256 mt3 = _mm256_mul_ps(mt2, mt);
+                __m256 b1 = _mm256_mul_ps(_mm256_mul_ps(three, mt2), t);
+                __m256 b2 = _mm256_mul_ps(_mm256_mul_ps(three, mt), t2);
+                __m256 x = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(mt3, _mm256_set1_ps(p[0])),
+                    _mm256_mul_ps(b1, _mm256_set1_ps(p[2]))), _mm256_mul_ps(b2, _mm256_set1_ps(p[4]))),
+                    _mm256_mul_ps(t3, _mm256_set1_ps(p[6])));
+                __m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(mt3, _mm256_set1_ps(p[1])),
+                    _mm256_mul_ps(b1, _mm256_set1_ps(p[3]))), _mm256_mul_ps(b2, _mm256_set1_ps(p[5]))),
+                    _mm256_mul_ps(t3, _mm256_set1_ps(p[7])));
+
+                // Unpack interleaves within each 128-bit half, the permutes put the halves in order
+                __m256 lo = _mm256_unpacklo_ps(x, y);
+                __m256 hi = _mm256_unpackhi_ps(x, y);
+                _mm256_storeu_ps(points + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+                _mm256_storeu_ps(points + i * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+            }
+            for (; i <= segments; i++) BezierOne(p, i, n, points + i * 2);
+        }
+
+        static bool CpuHasAVX2() {
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+            __cpuid(info, 1);
+            const int osxsave = 1 << 27, avx = 1 << 28;
+            if ((info[2] & (osxsave | avx)) != (osxsave | avx)) return false;
+            if ((_xgetbv(0) & 6) != 6) return false;     // OS saves the YMM registers
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        }
+#endif
+
+#if VGUI_HAS_NEON
+        // vmulq + vaddq rather than vmlaq, which may be fused and round differently
+        static inline void SinCos4(float32x4_t x, float32x4_t& cosOut, float32x4_t& sinOut) {
+            const uint32x4_t one = vdupq_n_u32(1);
+            const uint32x4_t two = vdupq_n_u32(2);
+            int32x4_t qs = vcvtnq_s32_f32(vmulq_f32(x, vdupq_n_f32(TwoOverPi)));
+            uint32x4_t q = vreinterpretq_u32_s32(qs);
+            float32x4_t j = vcvtq_f32_s32(qs);
+            float32x4_t y = vsubq_f32(vsubq_f32(vsubq_f32(x, vmulq_f32(j, vdupq_n_f32(PiOver2A))),
+                vmulq_f32(j, vdupq_n_f32(PiOver2B))), vmulq_f32(j, vdupq_n_f32(PiOver2C)));
+            float32x4_t z = vmulq_f32(y, y);
+            float32x4_t sp = vaddq_f32(vmulq_f32(vdupq_n_f32(SinC3), z), vdupq_n_f32(SinC2));
+            sp = vaddq_f32(vmulq_f32(sp, z), vdupq_n_f32(SinC1));
+            sp = vaddq_f32(vmulq_f32(sp, vmulq_f32(y, z)), y);
+            float32x4_t cp = vaddq_f32(vmulq_f32(vdupq_n_f32(CosC3), z), vdupq_n_f32(CosC2));
+            cp = vaddq_f32(vmulq_f32(cp, z), vdupq_n_f32(CosC1));
+            cp = vaddq_f32(vmulq_f32(cp, vmulq_f32(z, z)), vsubq_f32(vdupq_n_f32(1.0f), vmulq_f32(vdupq_n_f32(0.5f), z)));
+
+            uint32x4_t swap = vceqq_u32(vandq_u32(q, one), one);
+            float32x4_t s = vbslq_f32(swap, cp, sp);
+            float32x4_t c = vbslq_f32(swap, sp, cp);
+            sinOut = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(s), vshlq_n_u32(vandq_u32(q, two), 30)));
+            cosOut = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(c), vshlq_n_u32(vandq_u32(vaddq_u32(q, one), two), 30)));
+        }
+
+        static void SinCosNEON(float startAngle, float angleStep, int count, float* cosOut, float* sinOut) {
+            const float laneValues[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+            const float32x4_t lane = vld1q_f32(laneValues);
+            int i = 0;
+            for (; i + 4 <= count; i += 4) {
+                float32x4_t index = vaddq_f32(vdupq_n_f32(static_cast<float>(i)), lane);
+                float32x4_t c, s;
+                SinCos4(vaddq_f32(vdupq_n_f32(startAngle), vmulq_f32(index, vdupq_n_f32(angleStep))), c, s);
+                vst1q_f32(cosOut + i, c);
+                vst1q_f32(sinOut + i, s);
+            }
+            for (; i < count; i++)
+                SinCosOne(startAngle + static_cast<float>(i) * angleStep, cosOut[i], sinOut[i]);
+        }
+
+        static void BezierNEON(const float* p, int segments, float* points) {
+            const float n = static_cast<float>(segments);
+            const float laneValues[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+            const float32x4_t lane = vld1q_f32(laneValues);
+            const float32x4_t one = vdupq_n_f32(1.0f);
+            const float32x4_t three = vdupq_n_f32(3.0f);
+            points[0] = p[0];
+            points[1] = p[1];
+            int i = 1;
+            for (; i + 4 <= segments + 1; i += 4) {
+                float32x4_t t = vdivq_f32(vaddq_f32(vdupq_n_f32(static_cast<float>(i)), lane), vdupq_n_f32(n));
+                float32x4_t t2 = vmulq_f32(t, t);
+                float32x4_t t3 = vmulq_f32(t2, t);
+                float32x4_t mt = vsubq_f32(one, t);
+                float32x4_t mt2 = vmulq_f32(mt, mt);
+                float32x4_t mt3 = vmulq_f32(mt2, mt);
+                float32x4_t b1 = vmulq_f32(vmulq_f32(three, mt2), t);
+                float32x4_t b2 = vmulq_f32(vmulq_f32(three, mt), t2);
+                float32x4x2_t xy;
+                xy.val[0] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(mt3, vdupq_n_f32(p[0])), vmulq_f32(b1, vdupq_n_f32(p[2]))),
+                    vmulq_f32(b2, vdupq_n_f32(p[4]))), vmulq_f32(t3, vdupq_n_f32(p[6])));
+                xy.val[1] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(mt3, vdupq_n_f32(p[1])), vmulq_f32(b1, vdupq_n_f32(p[3]))),
+                    vmulq_f32(b2, vdupq_n_f32(p[5]))), vmulq_f32(t3, vdupq_n_f32(p[7])));
+                vst2q_f32(points + i * 2, xy);      // stores x, y interleaved
+            }
+            for (; i <= segments; i++) BezierOne(p, i, n, points + i * 2);
+        }
+#endif
+
+        struct KernelTable {
+            void (*sinCos)(float startAngle, float angleStep, int count, float* cosOut, float* sinOut);
+            void (*bezier)(const float* p, int segments, float* points);
+        };
+
+        // Indexed by KernelSet; nullptr where the build has no such kernels
+        static const KernelTable g_Kernels[] = {
+            { SinCosScalar, BezierScalar },
+#if VGUI_HAS_SSE2
+            { SinCosSSE2, BezierSSE2 },
+#else
+            { nullptr, nullptr },
+#endif
+#if VGUI_HAS_AVX2
+            { SinCosAVX2, BezierAVX2 },
+#else
+            { nullptr, nullptr },
+#endif
+#if VGUI_HAS_NEON
+            { SinCosNEON, BezierNEON },
+#else
+            { nullptr, nullptr },
+#endif
+        };
+
+        static bool IsSupported(KernelSet set) {
+            if (!g_Kernels[static_cast<int>(set)].sinCos) return false;
+#if VGUI_HAS_AVX2
+            if (set == KernelSet::AVX2) {
+                static const bool hasAVX2 = CpuHasAVX2();
+                return hasAVX2;
+            }
+#endif
+            return true;
+        }
+
+        static KernelSet BestSupported(KernelSet set) {
+            // NEON and the x86 sets never coexist, so falling back one step at a time is enough
+            while (set != KernelSet::Scalar && !IsSupported(set))
+                set = static_cast<KernelSet>(static_cast<int>(set) - 1);
+            return set;
+        }
+
+        // -1 until the first call picks the best set
+        static std::atomic<int> g_KernelSet{ -1 };
+
+        static const KernelTable& ActiveKernels() {
+            int set = g_KernelSet.load(std::memory_order_relaxed);
+            if (set < 0) {
+                set = static_cast<int>(BestSupported(KernelSet::NEON));
+                g_KernelSet.store(set, std::memory_order_relaxed);
+            }
+            return g_Kernels[set];
+        }
+
+        KernelSet GetKernelSet() {
+            ActiveKernels();
+            return static_cast<KernelSet>(g_KernelSet.load(std::memory_order_relaxed));
+        }
+
+        KernelSet SetKernelSet(KernelSet set) {
+            set = BestSupported(set);
+            g_KernelSet.store(static_cast<int>(set), std::memory_order_relaxed);
+            return set;
+        }
+
+        const char* GetKernelSetName(KernelSet set) {
+            switch (set) {
+            case KernelSet::SSE2: return "sse2";
+            case KernelSet::AVX2: return "avx2";
+            case KernelSet::NEON: return "neon";
+            default: return "scalar";
+            }
+        }
+
+        void SinCos(float startAngle, float angleStep, int count, float* cosOut, float* sinOut) {
+            ActiveKernels().sinCos(startAngle, angleStep, count, cosOut, sinOut);
+        }
+
+        void CubicBezierPoints(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
+            int segments, float* points) {
+            const float p[8] = { x1, y1, x2, y2, x3, y3, x4, y4 };
+            ActiveKernels().bezier(p, segments, points);
+        }
+
+        // Flattening after R. Levien, "Fast, precise flattening of cubic Bezier path and offset curves"
+        // (2019). A quadratic is a segment of the parabola y = x^2, scaled. The points a polyline needs
+        // along it to stay within tolerance grow with the integral of the square root of its curvature,
+        // which has a closed-form approximation. Spacing the points evenly in that integral puts them
+        // where the curve bends and gives close to the minimum count. Cubics are first split into
+        // quadratics that stay within a fifth of the tolerance.
+        static inline float ApproxParabolaIntegral(float x) {
+            const float D = 0.67f;
+            return x / (1.0f - D + sqrtf(sqrtf(D * D * D * D + 0.25f * x * x)));
+        }
+
+        static inline float ApproxParabolaInvIntegral(float x) {
+            const float B = 0.39f;
+            return x * (1.0f - B + sqrtf(B * B + 0.25f * x * x));
+        }
+
+        struct QuadSubdivision {
+            float p[6];
+            float val;          // points needed, times 2 sqrt(tolerance)
+            float a0, a2;       // integral at the ends
+            float u0, uScale;   // set by PrepareQuadPoints
+        };
+
+        // q.p holds the control points
+        static void EstimateQuadSubdivision(QuadSubdivision& q, float sqrtTolerance) {
+            const float* p = q.p;
+            const float ddx = 2.0f * p[2] - p[0] - p[4];
+            const float ddy = 2.0f * p[3] - p[1] - p[5];
+            const float u0 = (p[2] - p[0]) * ddx + (p[3] - p[1]) * ddy;
+            const float u2 = (p[4] - p[2]) * ddx + (p[5] - p[3]) * ddy;
+            const float cross = (p[4] - p[0]) * ddy - (p[5] - p[1]) * ddx;
+            const float invCross = 1.0f / cross;
+            const float x0 = u0 * invCross;
+            const float x2 = u2 * invCross;
+            const float scale = cross * cross / (sqrtf(ddx * ddx + ddy * ddy) * fabsf(u2 - u0));
+
+            q.a0 = ApproxParabolaIntegral(x0);
+            q.a2 = ApproxParabolaIntegral(x2);
+            q.val = 0.0f;
+            // Not finite for straight lines and for quadratics collapsed to a point, which need no
+            // inner points
+            if (std::isfinite(x0) && std::isfinite(x2) && std::isfinite(scale)) {
+                const float da = fabsf(q.a2 - q.a0);
+                const float sqrtScale = sqrtf(scale);
+                if ((x0 < 0.0f) == (x2 < 0.0f)) {
+                    q.val = da * sqrtScale;
+                }
+                else {
+                    // The segment contains the vertex of the parabola, where the integral is steepest
+                    const float xMin = sqrtTolerance / sqrtScale;
+                    q.val = sqrtTolerance * da / ApproxParabolaIntegral(xMin);
+                }
+            }
+        }
+
+        // Only the quadratics that get points need the inverse integral
+        static inline void PrepareQuadPoints(QuadSubdivision& q) {
+            q.u0 = ApproxParabolaInvIntegral(q.a0);
+            q.uScale = 1.0f / (ApproxParabolaInvIntegral(q.a2) - q.u0);
+        }
+
+        // Point at fraction u of the quadratic's integral
+        static inline void QuadPointAt(const QuadSubdivision& q, float u, float* out) {
+            const float a = q.a0 + (q.a2 - q.a0) * u;
+            const float t = (ApproxParabolaInvIntegral(a) - q.u0) * q.uScale;
+            const float mt = 1.0f - t;
+            out[0] = mt * mt * q.p[0] + 2.0f * mt * t * q.p[2] + t * t * q.p[4];
+            out[1] = mt * mt * q.p[1] + 2.0f * mt * t * q.p[3] + t * t * q.p[5];
+        }
+
+        static inline int FlattenedCount(float val, float sqrtTolerance, int maxSegments) {
+            const float n = ceilf(0.5f * val / sqrtTolerance);
+            return (n >= static_cast<float>(maxSegments)) ? maxSegments : (n > 1.0f) ? static_cast<int>(n) : 1;
+        }
+
+        // Curves whose control points all lie within flatTolerance of the line through the end points
+        // (tolerance / 2 for quadratics, 2/3 tolerance for cubics: a polyline between points on them is
+        // then within tolerance) are drawn as lines. Only where the curve turns back along the line
+        // does it need points, at the zeros of the derivative's projection d0 + 2 d1 t + d2 t^2.
+        // Curves that end where they start are measured along their farthest control point instead.
+        // Returns the point count, or 0 when the curve is not flat.
+        static int FlattenFlatCurve(const float* p, int degree, float flatTolerance, float* points) {
+            const float* end = p + degree * 2;
+            float dx = end[0] - p[0], dy = end[1] - p[1];
+            float length2 = dx * dx + dy * dy;
+            if (!(length2 > 0.0f)) {
+                for (int i = 1; i < degree; i++) {
+                    const float cx = p[i * 2] - p[0], cy = p[i * 2 + 1] - p[1];
+                    if (cx * cx + cy * cy > length2) {
+                        dx = cx;
+                        dy = cy;
+                        length2 = cx * cx + cy * cy;
+                    }
+                }
+            }
+            if (!(length2 > 0.0f)) return 0;
+            const float limit2 = flatTolerance * flatTolerance * length2;
+            for (int i = 1; i < degree; i++) {
+                const float cross = (p[i * 2] - p[0]) * dy - (p[i * 2 + 1] - p[1]) * dx;
+                if (!(cross * cross <= limit2)) return 0;
+            }
+
+            float along[4];
+            for (int i = 0; i <= degree; i++) along[i] = (p[i * 2] - p[0]) * dx + (p[i * 2 + 1] - p[1]) * dy;
+            float roots[2];
+            int count = 0;
+            if (degree == 2) {
+                const float d0 = along[1] - along[0], d1 = along[2] - along[1];
+                if ((d0 < 0.0f) != (d1 < 0.0f)) roots[count++] = d0 / (d0 - d1);
+            }
+            else {
+                const float d0 = along[1] - along[0];
+                const float d1 = along[2] - 2.0f * along[1] + along[0];
+                const float d2 = along[3] - 3.0f * (along[2] - along[1]) - along[0];
+                if (fabsf(d2) <= 1e-6f * (fabsf(d0) + fabsf(d1))) {
+                    if (d1 != 0.0f) roots[count++] = -0.5f * d0 / d1;
+                }
+                else {
+                    const float discriminant = d1 * d1 - d0 * d2;
+                    if (discriminant > 0.0f) {
+                        const float root = sqrtf(discriminant);
+                        roots[count++] = (-d1 - root) / d2;
+                        roots[count++] = (-d1 + root) / d2;
+                    }
+                }
+            }
+
+            int turns = 0;
+            float t[2];
+            for (int i = 0; i < count; i++)
+                if (roots[i] > 0.0f && roots[i] < 1.0f) t[turns++] = roots[i];
+            if (turns == 2 && t[0] > t[1]) {
+                float swap = t[0];
+                t[0] = t[1];
+                t[1] = swap;
+            }
+            if (points) {
+                for (int i = 0; i < turns; i++) {
+                    const float u = t[i], mu = 1.0f - u;
+                    for (int axis = 0; axis < 2; axis++) {
+                        points[i * 2 + axis] = (degree == 2)
+                            ? mu * mu * p[axis] + 2.0f * mu * u * p[2 + axis] + u * u * p[4 + axis]
+                            : mu * mu * mu * p[axis] + 3.0f * mu * u * (mu * p[2 + axis] + u * p[4 + axis]) + u * u * u * p[6 + axis];
+                    }
+                }
+                points[turns * 2] = end[0];
+                points[turns * 2 + 1] = end[1];
+            }
+            return turns + 1;
+        }
+
+        int FlattenQuadraticBezier(float x1, float y1, float x2, float y2, float x3, float y3,
+            float tolerance, float* points, int maxSegments) {
+            const float flat[6] = { x1, y1, x2, y2, x3, y3 };
+            const int flatCount = FlattenFlatCurve(flat, 2, tolerance * 0.5f, points);
+            if (flatCount > 0) return flatCount;
+
+            const float sqrtTolerance = sqrtf(tolerance);
+            QuadSubdivision q = {};
+            for (int i = 0; i < 6; i++) q.p[i] = flat[i];
+            EstimateQuadSubdivision(q, sqrtTolerance);
+            const int n = FlattenedCount(q.val, sqrtTolerance, maxSegments);
+            if (points) {
+                PrepareQuadPoints(q);
+                for (int i = 1; i < n; i++) QuadPointAt(q, static_cast<float>(i) / static_cast<float>(n), points + (i - 1) * 2);
+                points[(n - 1) * 2] = x3;
+                points[(n - 1) * 2 + 1] = y3;
+            }
+            return n;
+        }
+
+        // The quadratic that best fits a cubic is off by at most sqrt(3) / 36 |p3 - 3 p2 + 3 p1 - p0|
+        // times the cube of the parameter span, so splitting the cubic into n even pieces divides the
+        // error by n^3
+        const float CubicToQuadTolerance = 0.2f;
+        const int MaxQuadsPerCubic = 32;
+
+        static inline void CubicPoint(const float* p, float t, float* out) {
+            const float mt = 1.0f - t;
+            out[0] = mt * mt * mt * p[0] + 3.0f * mt * t * (mt * p[2] + t * p[4]) + t * t * t * p[6];
+            out[1] = mt * mt * mt * p[1] + 3.0f * mt * t * (mt * p[3] + t * p[5]) + t * t * t * p[7];
+        }
+
+        static inline void CubicDerivative(const float* p, float t, float* out) {
+            const float mt = 1.0f - t;
+            out[0] = 3.0f * (mt * mt * (p[2] - p[0]) + 2.0f * mt * t * (p[4] - p[2]) + t * t * (p[6] - p[4]));
+            out[1] = 3.0f * (mt * mt * (p[3] - p[1]) + 2.0f * mt * t * (p[5] - p[3]) + t * t * (p[7] - p[5]));
+        }
+
+        // Parameters in (0, 1), ascending, where a cubic is split before quadratics are fitted to it;
+        // returns their count. First the inflections, where the curvature changes sign: a quadratic
+        // cannot bend both ways, so one fitted across an inflection comes out nearly straight and
+        // would claim no points for the bends on either side. Then the peak of cross(B', B''), about
+        // where the curve turns hardest, when it lies between two inflections or the curve is a
+        // near-cusp. Cusps and those peaks are the tips of hairpins, which must be points of the
+        // polyline; tip[i] tells them from plain inflections.
+        static int CubicSplits(const float* p, float* t, bool* tip) {
+            // B' / 3 = a + 2 b t + c t^2, B'' / 6 = b + c t; cross(B', B'') vanishes at the inflections
+            const float ax = p[2] - p[0], ay = p[3] - p[1];
+            const float bx = p[4] - 2.0f * p[2] + p[0], by = p[5] - 2.0f * p[3] + p[1];
+            const float cx = p[6] - 3.0f * (p[4] - p[2]) - p[0], cy = p[7] - 3.0f * (p[5] - p[3]) - p[1];
+            const float qa = bx * cy - by * cx;
+            const float qb = ax * cy - ay * cx;
+            const float qc = ax * by - ay * bx;
+
+            float roots[2];
+            int count = 0;
+            const bool quadratic = !(fabsf(qa) <= 1e-6f * (fabsf(qb) + fabsf(qc)));
+            const float discriminant = qb * qb - 4.0f * qa * qc;
+            if (!quadratic) {
+                if (qb != 0.0f) roots[count++] = -qc / qb;
+            }
+            else if (discriminant >= 0.0f) {
+                const float root = sqrtf(discriminant);
+                roots[count++] = (-qb - root) / (2.0f * qa);
+                roots[count++] = (-qb + root) / (2.0f * qa);
+            }
+
+            int inside = 0;
+            for (int i = 0; i < count; i++)
+                if (roots[i] > 0.001f && roots[i] < 0.999f) t[inside++] = roots[i];
+            if (inside == 2 && t[0] > t[1]) {
+                float swap = t[0];
+                t[0] = t[1];
+                t[1] = swap;
+            }
+            for (int i = 0; i < 3; i++) tip[i] = false;
+            // A cusp is a double root; keep one split there, not a span of no width
+            if (inside == 2 && t[1] - t[0] < 0.001f) {
+                inside = 1;
+                tip[0] = true;
+            }
+            else if (quadratic && inside != 1) {
+                // Without inflections, only near-cusps (a complex pair of inflections close to the real
+                // line) need it
+                const float peak = -qb / (2.0f * qa);
+                if (inside == 0 && discriminant > -0.01f * qb * qb && peak > 0.001f && peak < 0.999f) {
+                    tip[inside] = true;
+                    t[inside++] = peak;
+                }
+                else if (inside == 2 && peak - t[0] >= 0.001f && t[1] - peak >= 0.001f) {
+                    t[2] = t[1];
+                    t[1] = peak;
+                    tip[1] = true;
+                    inside = 3;
+                }
+            }
+            return inside;
+        }
+
+        int FlattenCubicBezier(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
+            float tolerance, float* points, int maxSegments) {
+            const float p[8] = { x1, y1, x2, y2, x3, y3, x4, y4 };
+            const int flatCount = FlattenFlatCurve(p, 3, tolerance * (2.0f / 3.0f), points);
+            if (flatCount > 0) return flatCount;
+
+            // Quadratics per unit of t, then each span between the splits below is cut evenly
+            const float ex = 3.0f * (x3 - x2) - x4 + x1;
+            const float ey = 3.0f * (y3 - y2) - y4 + y1;
+            const float quadTolerance = tolerance * CubicToQuadTolerance;
+            float quadDensity = powf((ex * ex + ey * ey) / (432.0f * quadTolerance * quadTolerance), 1.0f / 6.0f);
+            if (!(quadDensity <= static_cast<float>(MaxQuadsPerCubic))) quadDensity = static_cast<float>(MaxQuadsPerCubic);
+
+            float splits[5] = { 0.0f };
+            bool tips[3];
+            const int spans = CubicSplits(p, splits + 1, tips) + 1;
+            splits[spans] = 1.0f;
+
+            // The quadratics get what is left of the tolerance
+            const float sqrtTolerance = sqrtf(tolerance * (1.0f - CubicToQuadTolerance));
+            QuadSubdivision q[MaxQuadsPerCubic + 4];
+            int quads = 0;
+            int spanEnd[4];         // first quadratic after each span
+            float spanSum[4];
+            float start[2] = { x1, y1 }, startTangent[2];
+            CubicDerivative(p, 0.0f, startTangent);
+            for (int span = 0; span < spans; span++) {
+                const float t0 = splits[span];
+                const float width = splits[span + 1] - t0;
+                spanSum[span] = 0.0f;
+                spanEnd[span] = quads;
+                if (!(width > 0.0f)) continue;
+                const float spanQuads = ceilf(width * quadDensity);
+                const int pieces = (spanQuads > 1.0f) ? static_cast<int>(spanQuads) : 1;
+                const float step = width / static_cast<float>(pieces);
+                for (int i = 0; i < pieces; i++) {
+                    // Piece [t, t1] as a cubic, then its best quadratic: control point
+                    // (3 c1 - c0 + 3 c2 - c3) / 4
+                    const bool last = (span + 1 == spans) && (i + 1 == pieces);
+                    const float t1 = (i + 1 == pieces) ? splits[span + 1] : t0 + static_cast<float>(i + 1) * step;
+                    float end[2], endTangent[2];
+                    if (last) {
+                        end[0] = x4;
+                        end[1] = y4;
+                    }
+                    else {
+                        CubicPoint(p, t1, end);
+                    }
+                    CubicDerivative(p, t1, endTangent);
+                    const float third = step / 3.0f;
+                    const float c1x = start[0] + startTangent[0] * third, c1y = start[1] + startTangent[1] * third;
+                    const float c2x = end[0] - endTangent[0] * third, c2y = end[1] - endTangent[1] * third;
+                    QuadSubdivision& quad = q[quads++];
+                    quad.p[0] = start[0];
+                    quad.p[1] = start[1];
+                    quad.p[2] = (3.0f * (c1x + c2x) - start[0] - end[0]) * 0.25f;
+                    quad.p[3] = (3.0f * (c1y + c2y) - start[1] - end[1]) * 0.25f;
+                    quad.p[4] = end[0];
+                    quad.p[5] = end[1];
+                    EstimateQuadSubdivision(quad, sqrtTolerance);
+                    spanSum[span] += quad.val;
+                    start[0] = end[0];
+                    start[1] = end[1];
+                    startTangent[0] = endTangent[0];
+                    startTangent[1] = endTangent[1];
+                }
+                spanEnd[span] = quads;
+            }
+
+            // Spans are grouped at the tips, and each group gets its own points and ends on a point,
+            // so the polyline turns exactly at the tip of a hairpin. Were the points spread over the
+            // whole curve instead, the hairpin could fall between two of them and be cut off. When
+            // maxSegments has no room for that, the points are spread over one group.
+            int groups = 0;
+            int groupEnd[4];        // first quadratic after each group
+            float groupSum[4] = { 0.0f };
+            for (int span = 0; span < spans; span++) {
+                groupSum[groups] += spanSum[span];
+                if (span + 1 == spans || tips[span]) groupEnd[groups++] = spanEnd[span];
+            }
+            if (groups > maxSegments) {
+                for (int group = 1; group < groups; group++) groupSum[0] += groupSum[group];
+                groupEnd[0] = quads;
+                groups = 1;
+            }
+            int counts[4];
+            int n = 0;
+            for (int group = 0; group < groups; group++) {
+                counts[group] = FlattenedCount(groupSum[group], sqrtTolerance, maxSegments);
+                n += counts[group];
+            }
+            while (n > maxSegments) {
+                int largest = 0;
+                for (int group = 1; group < groups; group++)
+                    if (counts[group] > counts[largest]) largest = group;
+                counts[largest]--;
+                n--;
+            }
+            if (!points) return n;
+
+            // Spread each group's inner points evenly over its summed integral
+            int written = 0;
+            for (int group = 0, first = 0; group < groups; first = groupEnd[group++]) {
+                const int count = counts[group];
+                const float pointStep = groupSum[group] / static_cast<float>(count);
+                int inner = 0;
+                float valSum = 0.0f;
+                for (int i = first; i < groupEnd[group] && inner < count - 1; i++) {
+                    QuadSubdivision& quad = q[i];
+                    float target = static_cast<float>(inner + 1) * pointStep;
+                    if (target < valSum + quad.val) PrepareQuadPoints(quad);
+                    while (inner < count - 1 && target < valSum + quad.val) {
+                        QuadPointAt(quad, (target - valSum) / quad.val, points + (written + inner) * 2);
+                        inner++;
+                        target = static_cast<float>(inner + 1) * pointStep;
+                    }
+                    valSum += quad.val;
+                }
+                // Rounding can leave the last inner point out; the count must not change. A group
+                // ends where its last quadratic does, the last group on the end point itself.
+                const float* groupLast = (group + 1 < groups && groupEnd[group] > first) ? q[groupEnd[group] - 1].p + 4 : p + 6;
+                for (; inner < count; inner++) {
+                    points[(written + inner) * 2] = groupLast[0];
+                    points[(written + inner) * 2 + 1] = groupLast[1];
+                }
+                written += count;
+            }
+            return n;
+        }
+
+        constexpr float CircleStep(int segments) {
+            return 6.28318530718f / static_cast<float>(segments);   // 2 PI
+        }
+
+        constexpr float ArcStep(int segments) {
+            return 1.57079632679f / static_cast<float>(segments);   // PI / 2
+        }
+
+        // Angles 0 + i * angleStep, computed as the SinCos kernels do so cached and freshly computed
+        // points agree
+        template <int Count>
+        struct ArcTableData {
+            float cosTable[Count];
+            float sinTable[Count];
+            float edgeSecant;
+
+            constexpr explicit ArcTableData(float angleStep) : cosTable(), sinTable(), edgeSecant() {
+                for (int i = 0; i < Count; i++)
+                    SinCosConst(0.0f + static_cast<float>(i) * angleStep, cosTable[i], sinTable[i]);
+                float c = 0.0f, s = 0.0f;
+                SinCosConst(angleStep * 0.5f, c, s);
+                edgeSecant = 1.0f / c;
+            }
+        };
+
+        // Compile-time tables for the counts AutoSegments gives circles (multiples of 4) and corners of
+        // radius up to ~200 px at the default tolerance, plus the largest counts callers tend to pass
+        static constexpr ArcTableData<8> g_Circle8(CircleStep(8));
+        static constexpr ArcTableData<12> g_Circle12(CircleStep(12));
+        static constexpr ArcTableData<16> g_Circle16(CircleStep(16));
+        static constexpr ArcTableData<20> g_Circle20(CircleStep(20));
+        static constexpr ArcTableData<24> g_Circle24(CircleStep(24));
+        static constexpr ArcTableData<28> g_Circle28(CircleStep(28));
+        static constexpr ArcTableData<32> g_Circle32(CircleStep(32));
+        static constexpr ArcTableData<36> g_Circle36(CircleStep(36));
+        static constexpr ArcTableData<40> g_Circle40(CircleStep(40));
+        static constexpr ArcTableData<44> g_Circle44(CircleStep(44));
+        static constexpr ArcTableData<48> g_Circle48(CircleStep(48));
+        static constexpr ArcTableData<52> g_Circle52(CircleStep(52));
+        static constexpr ArcTableData<56> g_Circle56(CircleStep(56));
+        static constexpr ArcTableData<60> g_Circle60(CircleStep(60));
+        static constexpr ArcTableData<64> g_Circle64(CircleStep(64));
+        static constexpr ArcTableData<96> g_Circle96(CircleStep(96));
+        static constexpr ArcTableData<128> g_Circle128(CircleStep(128));
+
+        static constexpr ArcTableData<5> g_Arc4(ArcStep(4));
+        static constexpr ArcTableData<6> g_Arc5(ArcStep(5));
+        static constexpr ArcTableData<7> g_Arc6(ArcStep(6));
+        static constexpr ArcTableData<8> g_Arc7(ArcStep(7));
+        static constexpr ArcTableData<9> g_Arc8(ArcStep(8));
+        static constexpr ArcTableData<10> g_Arc9(ArcStep(9));
+        static constexpr ArcTableData<11> g_Arc10(ArcStep(10));
+        static constexpr ArcTableData<12> g_Arc11(ArcStep(11));
+        static constexpr ArcTableData<13> g_Arc12(ArcStep(12));
+        static constexpr ArcTableData<14> g_Arc13(ArcStep(13));
+        static constexpr ArcTableData<15> g_Arc14(ArcStep(14));
+        static constexpr ArcTableData<16> g_Arc15(ArcStep(15));
+        static constexpr ArcTableData<17> g_Arc16(ArcStep(16));
+        static constexpr ArcTableData<25> g_Arc24(ArcStep(24));
+        static constexpr ArcTableData<33> g_Arc32(ArcStep(32));
+
+        template <int Count>
+        static constexpr ArcTable MakeArcTable(const ArcTableData<Count>& data) {
+            return { data.cosTable, data.sinTable, Count, data.edgeSecant, true };
+        }
+
+        static const ArcTable g_PrecomputedCircles[] = {
+            MakeArcTable(g_Circle8), MakeArcTable(g_Circle12), MakeArcTable(g_Circle16), MakeArcTable(g_Circle20),
+            MakeArcTable(g_Circle24), MakeArcTable(g_Circle28), MakeArcTable(g_Circle32), MakeArcTable(g_Circle36),
+            MakeArcTable(g_Circle40), MakeArcTable(g_Circle44), MakeArcTable(g_Circle48), MakeArcTable(g_Circle52),
+            MakeArcTable(g_Circle56), MakeArcTable(g_Circle60), MakeArcTable(g_Circle64), MakeArcTable(g_Circle96),
+            MakeArcTable(g_Circle128)
+        };
+
+        static const ArcTable g_PrecomputedArcs[] = {
+            MakeArcTable(g_Arc4), MakeArcTable(g_Arc5), MakeArcTable(g_Arc6), MakeArcTable(g_Arc7),
+            MakeArcTable(g_Arc8), MakeArcTable(g_Arc9), MakeArcTable(g_Arc10), MakeArcTable(g_Arc11),
+            MakeArcTable(g_Arc12), MakeArcTable(g_Arc13), MakeArcTable(g_Arc14), MakeArcTable(g_Arc15),
+            MakeArcTable(g_Arc16), MakeArcTable(g_Arc24), MakeArcTable(g_Arc32)
+        };
+
+        // Slot per segment count, filled on first lookup: with the precomputed table, or with one
+        // built here and published by compare-exchange (a thread that loses the race drops its copy).
+        // Built tables live until exit.
+        static std::atomic<const ArcTable*> g_CircleTables[MaxCircleSegments + 1];
+        static std::atomic<const ArcTable*> g_ArcTables[MaxArcSegments + 1];
+        static std::atomic<size_t> g_LazyBytes{ 0 };
+        static std::atomic<unsigned> g_LazyTables{ 0 };
+
+        template <size_t N>
+        static const ArcTable& FindArcTable(std::atomic<const ArcTable*>& slot, const ArcTable (&precomputed)[N],
+            int count, float angleStep) {
+            const ArcTable* table = slot.load(std::memory_order_acquire);
+            if (table) return *table;
+
+            for (const ArcTable& candidate : precomputed) {
+                if (candidate.count == count) {
+                    slot.store(&candidate, std::memory_order_release);
+                    return candidate;
+                }
+            }
+
+            // Scalar kernel on purpose: it matches SinCosConst on every CPU
+            float* data = new float[count * 2];
+            SinCosScalar(0.0f, angleStep, count, data, data + count);
+            float c, s;
+            SinCosOne(angleStep * 0.5f, c, s);
+            ArcTable* built = new ArcTable{ data, data + count, count, 1.0f / c, false };
+
+            const ArcTable* expected = nullptr;
+            if (!slot.compare_exchange_strong(expected, built, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                delete[] data;
+                delete built;
+                return *expected;
+            }
+            g_LazyBytes.fetch_add(count * 2 * sizeof(float), std::memory_order_relaxed);
+            g_LazyTables.fetch_add(1, std::memory_order_relaxed);
+            return *built;
+        }
+
+        const ArcTable& UnitCircle(int segments) {
+            segments = (segments < MinCircleSegments) ? MinCircleSegments : (segments > MaxCircleSegments) ? MaxCircleSegments : segments;
+            return FindArcTable(g_CircleTables[segments], g_PrecomputedCircles, segments, CircleStep(segments));
+        }
+
+        const ArcTable& QuarterArc(int segments) {
+            segments = (segments < MinArcSegments) ? MinArcSegments : (segments > MaxArcSegments) ? MaxArcSegments : segments;
+            return FindArcTable(g_ArcTables[segments], g_PrecomputedArcs, segments + 1, ArcStep(segments));
+        }
+
+        ArcTableStats GetArcTableStats() {
+            ArcTableStats stats = {};
+            for (const ArcTable& table : g_PrecomputedCircles) stats.precomputedBytes += table.count * 2 * sizeof(float);
+            for (const ArcTable& table : g_PrecomputedArcs) stats.precomputedBytes += table.count * 2 * sizeof(float);
+            stats.precomputedTables = static_cast<unsigned>(std::size(g_PrecomputedCircles) + std::size(g_PrecomputedArcs));
+            stats.lazyBytes = g_LazyBytes.load(std::memory_order_relaxed);
+            stats.lazyTables = g_LazyTables.load(std::memory_order_relaxed);
+            return stats;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+
+namespace VGUI {
+    namespace Curves {
+        // Instruction sets the point kernels come in. The best one the CPU supports is picked on
+        // first use. Scalar, SSE2 and AVX2 run the same operations in the same order (no FMA), so
+        // they produce bit-identical points and frame hashes do not depend on the machine.
+        enum class KernelSet {
+            Scalar,
+            SSE2,
+            AVX2,
+            NEON
+        };
+
+        KernelSet GetKernelSet();
+        // Forces a kernel set, e.g. to compare them in a benchmark. A set the CPU lacks falls back to
+        // the best supported one below it; returns the set now in use.
+        KernelSet SetKernelSet(KernelSet set);
+        const char* GetKernelSetName(KernelSet set);
+
+        // cosOut[i] / sinOut[i] = cos / sin(startAngle + i * angleStep), i < count. Polynomial
+        // approximation, within 2 ulp of libm for angles in [-8 pi, 8 pi].
+        void SinCos(float startAngle, float angleStep, int count, float* cosOut, float* sinOut);
+
+        // segments + 1 points (x, y interleaved) on the cubic Bezier, at t = i / segments
+        void CubicBezierPoints(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
+            int segments, float* points);
+
+        // Adaptive flattening: the fewest points whose polyline stays within tolerance pixels of the
+        // curve, spaced by curvature. Writes the points after the start point (x, y interleaved), at most
+        // maxSegments of them, the last one the end point, and returns their count. points may be
+        // nullptr to only count them.
+        int FlattenQuadraticBezier(float x1, float y1, float x2, float y2, float x3, float y3,
+            float tolerance, float* points, int maxSegments);
+        int FlattenCubicBezier(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
+            float tolerance, float* points, int maxSegments);
+
+        // Segment counts the cached tables cover
+        const int MinCircleSegments = 8;
+        const int MaxCircleSegments = 128;
+        const int MinArcSegments = 4;
+        const int MaxArcSegments = 32;
+
+        // cos / sin of evenly spaced angles, shared by every curved primitive so tessellation is
+        // scale and translate only. Tables for common segment counts are generated at compile time,
+        // the others on first use; both are immutable afterwards and may be read from any thread.
+        struct ArcTable {
+            const float* cosTable;
+            const float* sinTable;
+            int count;                  // entries in each table
+            float edgeSecant;           // 1 / cos(angleStep / 2): circumradius of the polygon's edges
+            bool precomputed;           // generated at compile time
+        };
+
+        // Angles 2 pi * i / segments, i < segments; segments in [MinCircleSegments, MaxCircleSegments]
+        const ArcTable& UnitCircle(int segments);
+        // Angles pi / 2 * i / segments, i <= segments; segments in [MinArcSegments, MaxArcSegments]
+        const ArcTable& QuarterArc(int segments);
+
+        struct ArcTableStats {
+            size_t precomputedBytes;    // compile-time tables, in the binary
+            size_t lazyBytes;           // tables generated at runtime so far
+            unsigned precomputedTables;
+            unsigned lazyTables;
+        };
+
+        ArcTableStats GetArcTableStats();
+    }
+}
@@ -1,186 +1,825 @@
 #include "vgui_draw.h"
-#include "vgui_core.h"
-#include <d3d11.h>
+#include "vgui_render.h"
+#include "vgui_context.h"
+#include "vgui_curves.h"
+#include "vgui_jobs.h"
+#include "vgui_polygon.h"
 #include <vector>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VGUI_HAS_SSE2 1
+#else
+#define VGUI_HAS_SSE2 0
+#endif
 
 namespace VGUI {
     namespace Draw {
-        struct Vertex {
-            float x, y, z;
-            float r, g, b, a;
+        // Order-dependent 64-bit mix (hash_combine style); meant for change detection, not security
+        inline uint64_t HashValue(uint64_t h, uint64_t v) {
+            return h ^ (v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2));
+        }
+
+        static uint64_t HashBytes(uint64_t h, const void* data, size_t size) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (; size >= 8; p += 8, size -= 8) {
+                uint64_t word;
+                memcpy(&word, p, 8);
+                h = HashValue(h, word);
+            }
+            if (size > 0) {
+                uint64_t word = 0;
+                memcpy(&word, p, size);
+                h = HashValue(h, word);
+            }
+            return h;
+        }
+
+        // Hash of one primitive's geometry. Primitives are hashed on their own and then chained, so
+        // batches can hash them in parallel and still match the same shapes recorded one by one.
+        static uint64_t HashGeometry(const Vertex* vertices, size_t vertexCount, const DrawIndex* indices, size_t indexCount) {
+            return HashBytes(HashBytes(0, vertices, vertexCount * sizeof(Vertex)), indices, indexCount * sizeof(DrawIndex));
+        }
+
+        // Folds the vertices and indices added since the last call into the list hash
+        static void HashPending(DrawList& list) {
+            if (list.vertices.size() == list.hashedVertices && list.indices.size() == list.hashedIndices) return;
+            list.hash = HashValue(list.hash, HashGeometry(list.vertices.data() + list.hashedVertices,
+                list.vertices.size() - list.hashedVertices, list.indices.data() + list.hashedIndices,
+                list.indices.size() - list.hashedIndices));
+            list.hashedVertices = list.vertices.size();
+            list.hashedIndices = list.indices.size();
+        }
+
+        // Shape color with the global alpha applied, converted once per shape
+        inline VertexColor ShapeColor(const Context& ctx, float r, float g, float b, float a) {
+            return MakeVertexColor(r, g, b, a * ctx.globalAlpha);
+        }
+
+        // Opens room for vertexCount vertices and returns the window-relative index of the first one.
+        // Indices are relative to the list's windowBase, a new window starts when 16 bits would overflow.
+        inline DrawIndex PrimReserve(DrawList& list, size_t vertexCount) {
+            if (list.vertices.size() + vertexCount - list.windowBase > MaxVerticesPerWindow)
+                list.windowBase = list.vertices.size();
+            return static_cast<DrawIndex>(list.vertices.size() - list.windowBase);
+        }
+
+        // Closes the primitive started at indexStart into a command
+        inline void AddCommand(DrawList& list, DrawCommandType type, size_t indexStart, bool antiAlias) {
+            list.commands.push_back({ type, list.windowBase, list.vertices.size() - list.windowBase,
+                indexStart, list.indices.size() - indexStart, antiAlias });
+
+            // Hash while the data is still in cache; index ranges follow from the hashed indices
+            HashPending(list);
+            list.hash = HashValue(list.hash, static_cast<uint64_t>(type) | (static_cast<uint64_t>(list.windowBase) << 8));
+        }
+
+        // Records one SDF shape instance
+        static void AddShape(Context& ctx, float x, float y, float w, float h, float radius, float borderWidth, VertexColor col) {
+            DrawList& list = *ctx.current;
+            float maxRadius = ((w < h) ? w : h) * 0.5f;
+            if (radius > maxRadius) radius = maxRadius;
+            if (radius < 0.0f) radius = 0.0f;
+
+            size_t instanceStart = list.instances.size();
+            list.instances.push_back({ x, y, w, h, radius, borderWidth, ctx.antiAlias ? 1.0f : 0.0f, col });
+            list.commands.push_back({ DrawCommandType::Shapes, 0, 0, instanceStart, 1, ctx.antiAlias });
+            list.hash = HashBytes(HashValue(list.hash, static_cast<uint64_t>(DrawCommandType::Shapes)),
+                &list.instances.back(), sizeof(ShapeInstance));
+        }
+
+        // Output of one primitive whose vertices and indices were reserved up front, so the same
+        // tessellation code serves single calls and batches filled in parallel. Vertices stay in
+        // pixel space, the vertex shader applies the projection.
+        struct PrimWriter {
+            Vertex* vtx;
+            DrawIndex* idx;
+
+            void AddVertex(float x, float y, VertexColor col) {
+                *vtx++ = { x, y, col };
+            }
+            void AddIndex(unsigned int i) {
+                *idx++ = static_cast<DrawIndex>(i);
+            }
+            void AddTriangle(unsigned int a, unsigned int b, unsigned int c) {
+                idx[0] = static_cast<DrawIndex>(a);
+                idx[1] = static_cast<DrawIndex>(b);
+                idx[2] = static_cast<DrawIndex>(c);
+                idx += 3;
+            }
         };
 
-        enum class DrawCommandType {
-            Lines,
-            Triangles,
-            TriangleStrip,
-            LineStrip
+        // Reserves a primitive at the end of the list; base receives its window-relative first vertex
+        static PrimWriter PrimAppend(DrawList& list, size_t vertexCount, size_t indexCount, DrawIndex& base) {
+            base = PrimReserve(list, vertexCount);
+            size_t vertexStart = list.vertices.size();
+            size_t indexStart = list.indices.size();
+            list.vertices.resize(vertexStart + vertexCount);
+            list.indices.resize(indexStart + indexCount);
+            return { list.vertices.data() + vertexStart, list.indices.data() + indexStart };
+        }
+
+        // Width of the alpha ramp extruded around anti-aliased geometry, in pixels
+        const float FringeWidth = 1.0f;
+
+        // Same color with zero alpha, for the outer edge of a fringe
+        inline VertexColor TransparentColor(VertexColor col) {
+#ifdef VGUI_VERTEX_FLOAT_COLOR
+            col.a = 0.0f;
+            return col;
+#else
+            return col & 0x00FFFFFFu;
+#endif
+        }
+
+        // Twice the signed area; positive when the points run clockwise on screen (y down)
+        static float SignedArea2(const float* points, int pointCount) {
+            float area = 0.0f;
+            for (int i = 0, j = pointCount - 1; i < pointCount; j = i++)
+                area += points[j * 2] * points[i * 2 + 1] - points[i * 2] * points[j * 2 + 1];
+            return area;
+        }
+
+        // Unit normal (dy, -dx) of the segment from point i to the next one (mod pointCount), outward for
+        // clockwise shapes; false, leaving nx / ny alone, when it has no length
+        static bool SegmentNormal(const float* points, int pointCount, int i, float& nx, float& ny) {
+            int j = (i + 1) % pointCount;
+            float dx = points[j * 2] - points[i * 2];
+            float dy = points[j * 2 + 1] - points[i * 2 + 1];
+            float len2 = dx * dx + dy * dy;
+            if (!(len2 > 0.0f)) return false;
+            float inv = 1.0f / sqrtf(len2);
+            nx = dy * inv;
+            ny = -dx * inv;
+            return true;
+        }
+
+        // Per-point extrusion directions: the average of the adjacent segment normals, rescaled so an
+        // offset of d stays d away from both segments (miter, length capped for sharp corners).
+        // Open polylines use the single segment normal at their end points. Zero-length segments keep
+        // the previous direction, as in strokes (BuildStrokeStations).
+        static void ComputeNormals(const float* points, int pointCount, bool closed, float* normals) {
+            const float maxInvLength2 = 100.0f;
+            const int segments = closed ? pointCount : pointCount - 1;
+
+            // The segment before point 0: the last one with a length when closed, otherwise the first
+            // one, so the end point gets its normal. Normals are zero when no segment has a length.
+            float prevX = 0.0f, prevY = 0.0f;
+            for (int k = 0; k < segments; k++)
+                if (SegmentNormal(points, pointCount, closed ? segments - 1 - k : k, prevX, prevY)) break;
+            for (int i = 0; i < pointCount; i++) {
+                float nx = prevX, ny = prevY;
+                if (i < segments) SegmentNormal(points, pointCount, i, nx, ny);
+
+                float mx = (prevX + nx) * 0.5f;
+                float my = (prevY + ny) * 0.5f;
+                float d2 = mx * mx + my * my;
+                if (d2 > 0.000001f) {
+                    float inv = 1.0f / d2;
+                    if (inv > maxInvLength2) inv = maxInvLength2;
+                    mx *= inv;
+                    my *= inv;
+                }
+                normals[i * 2] = mx;
+                normals[i * 2 + 1] = my;
+                prevX = nx;
+                prevY = ny;
+            }
+        }
+
+        // Vertices and indices of one line strip chunk of count points starting at first. A closing
+        // chunk that does not start at point 0 repeats point 0 to wrap back to it.
+        inline size_t LineChunkVertices(int first, int count, bool closes) {
+            return count + ((closes && first > 0) ? 1 : 0);
+        }
+        inline size_t LineChunkIndices(int count, bool closes) {
+            return count + (closes ? 1 : 0) + 1;
+        }
+
+        // Every strip ends with StripRestartIndex, so strip commands concatenate like lists
+        static void WriteLineChunk(PrimWriter& out, unsigned int base, const float* points, int first, int count,
+            bool closes, VertexColor col) {
+            for (int i = 0; i < count; i++) {
+                int p = first + i;
+                out.AddVertex(points[p * 2], points[p * 2 + 1], col);
+                out.AddIndex(base + i);
+            }
+            if (closes) {
+                if (first == 0) {
+                    out.AddIndex(base);
+                }
+                else {
+                    // Wrap back to point 0, which lives in an earlier window
+                    out.AddVertex(points[0], points[1], col);
+                    out.AddIndex(base + count);
+                }
+            }
+            out.AddIndex(StripRestartIndex);
+        }
+
+        // Hard-edged 1px stroke through the points, as line strips
+        static void AddLineStrip(DrawList& list, const float* points, int pointCount, bool closed, VertexColor col) {
+            // Chunk huge outlines so each chunk fits a 16-bit window; the last point of a chunk
+            // is repeated as the first point of the next one
+            const int maxChunk = static_cast<int>(MaxVerticesPerWindow) - 1;
+            for (int first = 0; first < pointCount - 1; first += maxChunk) {
+                int last = first + maxChunk;
+                bool isLast = last >= pointCount;
+                if (isLast) last = pointCount;
+                bool closes = closed && isLast;
+
+                size_t indexStart = list.indices.size();
+                int count = last - first + (isLast ? 0 : 1);
+                DrawIndex base;
+                PrimWriter out = PrimAppend(list, LineChunkVertices(first, count, closes), LineChunkIndices(count, closes), base);
+                WriteLineChunk(out, base, points, first, count, closes, col);
+                AddCommand(list, DrawCommandType::LineStrip, indexStart, false);
+            }
+        }
+
+        // Rows of vertices a stroke puts at every station (StrokeStation), and the pairs of rows each
+        // strip band runs between. Without anti-aliasing that is the two edges. Anti-aliased strokes
+        // up to FringeWidth thick are an opaque center row between two transparent rows, thicker ones
+        // an opaque core between two transparent fringes. The bands split their quads along the same
+        // diagonals the triangle lists used before.
+        struct StrokeRows {
+            int count;
+            float offset[4];        // distance from the center, > 0 along the station's a, < 0 along b
+            bool fringe[4];
+            int bands;
+            int band[3][2];
         };
 
-        struct DrawCommand {
-            DrawCommandType type;
-            size_t vertexStart;
-            size_t vertexCount;
-            bool antiAlias;
+        static StrokeRows GetStrokeRows(float thickness, bool antiAlias) {
+            if (!antiAlias) {
+                const float half = thickness * 0.5f;
+                return { 2, { half, -half }, { false, false }, 1, { { 0, 1 } } };
+            }
+            if (thickness <= FringeWidth)
+                return { 3, { 0.0f, FringeWidth, -FringeWidth }, { false, true, true }, 2, { { 1, 0 }, { 0, 2 } } };
+            const float halfInner = (thickness - FringeWidth) * 0.5f;
+            const float halfOuter = halfInner + FringeWidth;
+            return { 4, { halfOuter, halfInner, -halfInner, -halfOuter }, { true, false, false, true }, 3,
+                { { 1, 2 }, { 1, 0 }, { 2, 3 } } };
+        }
+
+        // Vertices and indices of one stroke chunk of count stations: one strip per band
+        inline size_t StrokeChunkVertices(int count, const StrokeRows& rows) {
+            return static_cast<size_t>(count) * rows.count;
+        }
+        inline size_t StrokeChunkIndices(int count, const StrokeRows& rows) {
+            return static_cast<size_t>(rows.bands) * (count * 2 + 1);
+        }
+
+        static void WriteStrokeChunk(PrimWriter& out, unsigned int base, const StrokeStation* stations, int count,
+            const StrokeRows& rows, VertexColor col) {
+            const VertexColor fringeCol = TransparentColor(col);
+            for (int i = 0; i < count; i++) {
+                const StrokeStation& s = stations[i];
+                for (int r = 0; r < rows.count; r++) {
+                    const float o = rows.offset[r];
+                    const float ox = (o >= 0.0f) ? s.ax * o : -s.bx * o;
+                    const float oy = (o >= 0.0f) ? s.ay * o : -s.by * o;
+                    out.AddVertex(s.x + ox, s.y + oy, rows.fringe[r] ? fringeCol : col);
+                }
+            }
+            for (int band = 0; band < rows.bands; band++) {
+                for (int i = 0; i < count; i++) {
+                    unsigned int v = base + i * rows.count;
+                    out.AddIndex(v + rows.band[band][0]);
+                    out.AddIndex(v + rows.band[band][1]);
+                }
+                out.AddIndex(StripRestartIndex);
+            }
+        }
+
+        // One station per point on the mitered normals of ComputeNormals; closed strokes repeat
+        // point 0 at the end. Writes pointCount (+ 1 when closed) stations.
+        static void MiterStations(const float* points, const float* normals, int pointCount, bool closed,
+            StrokeStation* stations) {
+            const int total = closed ? pointCount + 1 : pointCount;
+            for (int i = 0; i < total; i++) {
+                int p = i % pointCount;
+                float nx = normals[p * 2], ny = normals[p * 2 + 1];
+                stations[i] = { points[p * 2], points[p * 2 + 1], nx, ny, -nx, -ny };
+            }
+        }
+
+        // Segments for an arc of `angle` radians whose chords stay within tolerance pixels of it: the
+        // chord spanning a radians lies r (1 - cos(a / 2)) <= r a^2 / 8 inside the arc
+        static int ArcSegmentsForError(float radius, float angle, float tolerance) {
+            float n = angle * sqrtf(fabsf(radius) / (8.0f * tolerance));
+            return (n < 4096.0f) ? static_cast<int>(ceilf(n)) : 4096;
+        }
+
+        struct StrokeStyle {
+            LineJoin join;
+            LineCap cap;
+            float miterLimit;
+            float halfWidth;        // half the stroke width, for square caps and round segment counts
+            float tolerance;
         };
 
-        static std::vector<Vertex> g_VertexBuffer;
-        static std::vector<DrawCommand> g_CommandBuffer;
-        static ID3D11Buffer* g_D3DVertexBuffer = nullptr;
-        static bool g_AntiAliasEnabled = true;
-        static float g_GlobalAlpha = 1.0f;
+        const int MaxRoundJoinSegments = 32;
+
+        // Join at (x, y) from a segment with normal n0 to one with normal n1. Straight runs and miters
+        // within the limit are one station on the miter. Otherwise the outer edge turns from n0 to n1
+        // (two stations for a bevel, an arc for a round join) while the inner edge stays on the miter.
+        static void AddJoin(Memory::ArenaVector<StrokeStation>& out, float x, float y, float n0x, float n0y, float n1x, float n1y,
+            const StrokeStyle& style) {
+            const float maxMiterScale = 100.0f;     // inner miters up to 10x the half width, as ComputeNormals
+            float mx = (n0x + n1x) * 0.5f;
+            float my = (n0y + n1y) * 0.5f;
+            const float d2 = mx * mx + my * my;
+            const float cross = n0x * n1y - n0y * n1x;
+            if (d2 > 0.000001f) {
+                float scale = 1.0f / d2;
+                if (cross == 0.0f || (style.join == LineJoin::Miter && scale <= style.miterLimit * style.miterLimit)) {
+                    out.push_back({ x, y, mx * scale, my * scale, -mx * scale, -my * scale });
+                    return;
+                }
+                if (scale > maxMiterScale) scale = maxMiterScale;
+                mx *= scale;
+                my *= scale;
+            }
+            else {
+                // Turning straight back: the inner edges meet at the point itself
+                mx = my = 0.0f;
+            }
 
-        // Advanced vertex manipulation
-        void ToNDC(float x, float y, float& ndcX, float& ndcY) {
-            int width, height;
-            Core::GetWindowSize(width, height);
-            ndcX = (x / static_cast<float>(width)) * 2.0f - 1.0f;
-            ndcY = 1.0f - (y / static_cast<float>(height)) * 2.0f;
+            // A positive angle turns through the forward direction, so the a side is the outer one
+            const float angle = atan2f(cross, n0x * n1x + n0y * n1y);
+            int steps = 1;
+            if (style.join == LineJoin::Round) {
+                steps = ArcSegmentsForError(style.halfWidth, fabsf(angle), style.tolerance);
+                steps = (steps < 1) ? 1 : (steps > MaxRoundJoinSegments) ? MaxRoundJoinSegments : steps;
+            }
+            const float c = cosf(angle / static_cast<float>(steps));
+            const float s = sinf(angle / static_cast<float>(steps));
+            float rx = n0x, ry = n0y;
+            for (int i = 0; i <= steps; i++) {
+                if (i == steps) {
+                    rx = n1x;
+                    ry = n1y;
+                }
+                if (angle > 0.0f) out.push_back({ x, y, rx, ry, -mx, -my });
+                else out.push_back({ x, y, mx, my, -rx, -ry });
+                const float next = rx * c - ry * s;
+                ry = rx * s + ry * c;
+                rx = next;
+            }
+        }
+
+        // Cap of an open stroke at (x, y), whose end segment has normal n. Round caps are a quarter arc
+        // per side from the tip, sharing the rounded-rect corner tables.
+        static void AddCap(Memory::ArenaVector<StrokeStation>& out, float x, float y, float nx, float ny, bool start,
+            const StrokeStyle& style) {
+            // Outward direction: back along the stroke at its start, forward at its end
+            const float sign = start ? -1.0f : 1.0f;
+            const float dx = -ny * sign, dy = nx * sign;
+            if (style.cap == LineCap::Round) {
+                int steps = ArcSegmentsForError(style.halfWidth, 1.57079632679f, style.tolerance);  // PI / 2
+                steps = (steps < Curves::MinArcSegments) ? Curves::MinArcSegments :
+                    (steps > Curves::MaxArcSegments) ? Curves::MaxArcSegments : steps;
+                const Curves::ArcTable& arc = Curves::QuarterArc(steps);
+                for (int i = 0; i <= steps; i++) {
+                    // Tip first at the start, sides first at the end
+                    const int j = start ? i : steps - i;
+                    const float c = arc.cosTable[j], s = arc.sinTable[j];
+                    out.push_back({ x, y, nx * s + dx * c, ny * s + dy * c, -nx * s + dx * c, -ny * s + dy * c });
+                }
+                return;
+            }
+            const float extend = (style.cap == LineCap::Square) ? style.halfWidth : 0.0f;
+            out.push_back({ x + dx * extend, y + dy * extend, nx, ny, -nx, -ny });
+        }
+
+        // Stations of a stroke with joins and caps; closed strokes end on their first station again.
+        // Zero-length segments keep the previous direction; a stroke without any length gets none.
+        static void BuildStrokeStations(const float* points, int pointCount, bool closed, const StrokeStyle& style,
+            Memory::ArenaVector<StrokeStation>& out) {
+            out.clear();
+            const int segments = closed ? pointCount : pointCount - 1;
+            float firstX = 0.0f, firstY = 0.0f;
+            int first = 0;
+            while (first < segments && !SegmentNormal(points, pointCount, first, firstX, firstY)) first++;
+            if (first == segments) return;
+
+            float prevX = firstX, prevY = firstY;
+            if (closed) {
+                for (int i = segments - 1; i >= 0; i--)
+                    if (SegmentNormal(points, pointCount, i, prevX, prevY)) break;
+            }
+            else {
+                AddCap(out, points[0], points[1], firstX, firstY, true, style);
+            }
+
+            for (int i = closed ? 0 : 1; i < segments; i++) {
+                float nx = prevX, ny = prevY;
+                SegmentNormal(points, pointCount, i, nx, ny);
+                AddJoin(out, points[i * 2], points[i * 2 + 1], prevX, prevY, nx, ny, style);
+                prevX = nx;
+                prevY = ny;
+            }
+
+            if (closed) out.push_back(out.front());
+            else AddCap(out, points[(pointCount - 1) * 2], points[(pointCount - 1) * 2 + 1], prevX, prevY, false, style);
+        }
+
+        // Stroke through the points as triangle strips. Strokes up to 1px thick keep their mitered
+        // normals (ComputeNormals); thicker ones get the context's joins and caps. Without
+        // anti-aliasing thin strokes are line strips.
+        static void AddPolyline(Context& ctx, const float* points, int pointCount, bool closed, float thickness, VertexColor col) {
+            DrawList& list = *ctx.current;
+            if (pointCount < 2) return;
+            if (!ctx.antiAlias && thickness <= 1.0f) {
+                AddLineStrip(list, points, pointCount, closed, col);
+                return;
+            }
+
+            Memory::ArenaScope scope(ctx.scratch);
+            Memory::ArenaVector<StrokeStation> stations(ctx.scratch);
+            if (thickness > FringeWidth) {
+                const StrokeStyle style = { ctx.lineJoin, ctx.lineCap, ctx.miterLimit, thickness * 0.5f, ctx.curveTolerance };
+                BuildStrokeStations(points, pointCount, closed, style, stations);
+            }
+            else {
+                stations.resize(closed ? pointCount + 1 : pointCount);
+                float* normals = ctx.scratch.AllocateArray<float>(static_cast<size_t>(pointCount) * 2);
+                ComputeNormals(points, pointCount, closed, normals);
+                MiterStations(points, normals, pointCount, closed, stations.data());
+            }
+
+            // Long strokes are chunked per index window with the boundary station repeated
+            const StrokeRows rows = GetStrokeRows(thickness, ctx.antiAlias);
+            const int total = static_cast<int>(stations.size());
+            const int maxChunk = static_cast<int>(MaxVerticesPerWindow) / rows.count;
+            for (int first = 0; first < total - 1; first += maxChunk - 1) {
+                int count = total - first;
+                if (count > maxChunk) count = maxChunk;
+
+                size_t indexStart = list.indices.size();
+                DrawIndex base;
+                PrimWriter out = PrimAppend(list, StrokeChunkVertices(count, rows), StrokeChunkIndices(count, rows), base);
+                WriteStrokeChunk(out, base, stations.data() + first, count, rows, col);
+                if (ctx.antiAlias) list.fringeVertices += count * 2;
+                AddCommand(list, DrawCommandType::TriangleStrip, indexStart, ctx.antiAlias);
+            }
+        }
+
+        // Vertices and indices of a convex fill of pointCount points
+        inline size_t ConvexFillVertices(int pointCount, bool antiAlias) {
+            return static_cast<size_t>(pointCount) * (antiAlias ? 2 : 1);
+        }
+        inline size_t ConvexFillIndices(int pointCount, bool antiAlias) {
+            return static_cast<size_t>(pointCount - 2) * 3 + (antiAlias ? static_cast<size_t>(pointCount) * 6 : 0);
+        }
+
+        // One quad per edge joining the interleaved inner and outer rings of an anti-aliased fill
+        static void WriteFillFringeIndices(PrimWriter& out, unsigned int base, int pointCount) {
+            for (int i = 0, j = pointCount - 1; i < pointCount; j = i++) {
+                out.AddTriangle(base + i * 2, base + j * 2, base + j * 2 + 1);
+                out.AddTriangle(base + j * 2 + 1, base + i * 2 + 1, base + i * 2);
+            }
+        }
+
+        // Fan around vertex 0 and, with anti-aliasing, one quad per edge joining the interleaved inner and
+        // outer rings
+        static void WriteConvexFillIndices(PrimWriter& out, unsigned int base, int pointCount, bool antiAlias) {
+            if (!antiAlias) {
+                for (int i = 2; i < pointCount; i++)
+                    out.AddTriangle(base, base + i - 1, base + i);
+                return;
+            }
+            for (int i = 2; i < pointCount; i++)
+                out.AddTriangle(base, base + (i - 1) * 2, base + i * 2);
+            WriteFillFringeIndices(out, base, pointCount);
         }
 
-        inline void AddVertex(float x, float y, float r, float g, float b, float a) {
-            float ndcX, ndcY;
-            ToNDC(x, y, ndcX, ndcY);
-            g_VertexBuffer.push_back({ ndcX, ndcY, 0.0f, r, g, b, a * g_GlobalAlpha });
+        // Distance along ComputeNormals' normals from a fill's outline to its outer fringe edge; the
+        // inner edge lies the same distance the other way
+        static float FillFringeOffset(const float* points, int pointCount) {
+            float offset = FringeWidth * 0.5f;
+            return (SignedArea2(points, pointCount) < 0.0f) ? -offset : offset; // normals point inward
+        }
+
+        // The points of a fill, or with anti-aliasing the inner (opaque) and outer (transparent) vertex
+        // of each point, interleaved; normals is scratch for pointCount * 2 floats
+        static void WriteFillVertices(PrimWriter& out, const float* points, int pointCount, bool antiAlias,
+            float* normals, VertexColor col) {
+            if (!antiAlias) {
+                for (int i = 0; i < pointCount; i++)
+                    out.AddVertex(points[i * 2], points[i * 2 + 1], col);
+                return;
+            }
+
+            ComputeNormals(points, pointCount, true, normals);
+            const float offset = FillFringeOffset(points, pointCount);
+            const VertexColor fringeCol = TransparentColor(col);
+            for (int i = 0; i < pointCount; i++) {
+                float x = points[i * 2], y = points[i * 2 + 1];
+                float ox = normals[i * 2] * offset, oy = normals[i * 2 + 1] * offset;
+                out.AddVertex(x - ox, y - oy, col);
+                out.AddVertex(x + ox, y + oy, fringeCol);
+            }
+        }
+
+        // Convex fan around vertex 0 of the points, meant for small point counts (one index window).
+        // With anti-aliasing the fan is inset by half the fringe and a transparent ring is added the
+        // same distance outside, joined by one quad per edge; normals is scratch for pointCount * 2 floats.
+        static void WriteConvexFill(PrimWriter& out, unsigned int base, const float* points, int pointCount,
+            bool antiAlias, float* normals, VertexColor col) {
+            WriteFillVertices(out, points, pointCount, antiAlias, normals, col);
+            WriteConvexFillIndices(out, base, pointCount, antiAlias);
+        }
+
+        // Segment counts are clamped to the kernels' stack buffers. Counts <= 0 (AutoSegments) follow
+        // the curve tolerance; circles round them up to a multiple of 4 to stay symmetric about both axes.
+        static int CircleSegments(int segments, float radius, float tolerance) {
+            if (segments <= 0) segments = (ArcSegmentsForError(radius, 6.28318530718f, tolerance) + 3) & ~3; // 2 PI
+            return (segments < Curves::MinCircleSegments) ? Curves::MinCircleSegments :
+                (segments > Curves::MaxCircleSegments) ? Curves::MaxCircleSegments : segments;
+        }
+
+        const int MaxCurveSegments = 64;
+
+        // Cubic Bezier as a polyline (at most MaxCurveSegments + 1 points, x, y interleaved), returns
+        // the point count. AutoSegments flattens adaptively, fewer points where the curve is straight;
+        // explicit counts are even steps in t. points == nullptr only counts.
+        static int CubicBezierPolyline(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
+            int segments, float tolerance, float* points) {
+            if (segments <= 0) {
+                if (points) {
+                    points[0] = x1;
+                    points[1] = y1;
+                }
+                return Curves::FlattenCubicBezier(x1, y1, x2, y2, x3, y3, x4, y4, tolerance, points ? points + 2 : nullptr,
+                    MaxCurveSegments) + 1;
+            }
+            segments = (segments < 4) ? 4 : (segments > MaxCurveSegments) ? MaxCurveSegments : segments;
+            if (points) Curves::CubicBezierPoints(x1, y1, x2, y2, x3, y3, x4, y4, segments, points);
+            return segments + 1;
+        }
+
+        static void CountArcTable(DrawList& list, const Curves::ArcTable& table) {
+            if (table.precomputed) list.arcTableHits++;
+            else list.arcTableMisses++;
+        }
+
+        // Filled circle written straight from the unit circle table. The fringe offsets are radial: for
+        // a regular polygon the mitered normal of ComputeNormals is the radius direction scaled by
+        // 1 / cos(pi / segments), so no normals pass is needed.
+        static void WriteCircleFill(PrimWriter& out, unsigned int base, float cx, float cy, float radius,
+            const Curves::ArcTable& table, bool antiAlias, VertexColor col) {
+            const float* cosTable = table.cosTable;
+            const float* sinTable = table.sinTable;
+            const int segments = table.count;
+            if (!antiAlias) {
+                for (int i = 0; i < segments; i++)
+                    out.AddVertex(cx + radius * cosTable[i], cy + radius * sinTable[i], col);
+                WriteConvexFillIndices(out, base, segments, false);
+                return;
+            }
+
+            radius = fabsf(radius);
+            const float miter = FringeWidth * 0.5f * table.edgeSecant;
+            const float inner = (radius > miter) ? radius - miter : 0.0f;
+            const float outer = radius + miter;
+            const VertexColor fringeCol = TransparentColor(col);
+            for (int i = 0; i < segments; i++) {
+                out.AddVertex(cx + inner * cosTable[i], cy + inner * sinTable[i], col);
+                out.AddVertex(cx + outer * cosTable[i], cy + outer * sinTable[i], fringeCol);
+            }
+            WriteConvexFillIndices(out, base, segments, true);
+        }
+
+        static void AddConvexFill(Context& ctx, const float* points, int pointCount, VertexColor col) {
+            DrawList& list = *ctx.current;
+            size_t indexStart = list.indices.size();
+            Memory::ArenaScope scope(ctx.scratch);
+            float* normals = ctx.antiAlias ? ctx.scratch.AllocateArray<float>(static_cast<size_t>(pointCount) * 2) : nullptr;
+            DrawIndex base;
+            PrimWriter out = PrimAppend(list, ConvexFillVertices(pointCount, ctx.antiAlias),
+                ConvexFillIndices(pointCount, ctx.antiAlias), base);
+            WriteConvexFill(out, base, points, pointCount, ctx.antiAlias, normals, col);
+            if (ctx.antiAlias) list.fringeVertices += pointCount;
+            AddCommand(list, DrawCommandType::Triangles, indexStart, ctx.antiAlias);
+        }
+
+        static inline float Saturate(float v) {
+            return (v < 0.0f) ? 0.0f : (v > 1.0f) ? 1.0f : v;
+        }
+
+        VertexColor MakeVertexColor(float r, float g, float b, float a) {
+#ifdef VGUI_VERTEX_FLOAT_COLOR
+            return { Saturate(r), Saturate(g), Saturate(b), Saturate(a) };
+#else
+            unsigned int ir = static_cast<unsigned int>(Saturate(r) * 255.0f + 0.5f);
+            unsigned int ig = static_cast<unsigned int>(Saturate(g) * 255.0f + 0.5f);
+            unsigned int ib = static_cast<unsigned int>(Saturate(b) * 255.0f + 0.5f);
+            unsigned int ia = static_cast<unsigned int>(Saturate(a) * 255.0f + 0.5f);
+            return ir | (ig << 8) | (ib << 16) | (ia << 24);
+#endif
+        }
+
+        void PackColors(const float* rgba, unsigned int* out, size_t count) {
+            size_t i = 0;
+#if VGUI_HAS_SSE2
+            // 4 colors per iteration: scale, round to int, then saturate down to bytes.
+            // packs/packus clamp out-of-range values, NaN ends up as 0.
+            const __m128 scale = _mm_set1_ps(255.0f);
+            for (; i + 4 <= count; i += 4) {
+                __m128i c0 = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(rgba + i * 4 + 0), scale));
+                __m128i c1 = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(rgba + i * 4 + 4), scale));
+                __m128i c2 = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(rgba + i * 4 + 8), scale));
+                __m128i c3 = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(rgba + i * 4 + 12), scale));
+                __m128i lo = _mm_packs_epi32(c0, c1);
+                __m128i hi = _mm_packs_epi32(c2, c3);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+            }
+#endif
+            for (; i < count; i++) {
+                const float* c = rgba + i * 4;
+                unsigned int ir = static_cast<unsigned int>(Saturate(c[0]) * 255.0f + 0.5f);
+                unsigned int ig = static_cast<unsigned int>(Saturate(c[1]) * 255.0f + 0.5f);
+                unsigned int ib = static_cast<unsigned int>(Saturate(c[2]) * 255.0f + 0.5f);
+                unsigned int ia = static_cast<unsigned int>(Saturate(c[3]) * 255.0f + 0.5f);
+                out[i] = ir | (ig << 8) | (ib << 16) | (ia << 24);
+            }
         }
 
         void SetGlobalAlpha(float alpha) {
-            g_GlobalAlpha = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
+            Context& ctx = GetCurrentContext();
+            ctx.globalAlpha = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
         }
 
         void EnableAntiAliasing(bool enable) {
-            g_AntiAliasEnabled = enable;
+            Context& ctx = GetCurrentContext();
+            ctx.antiAlias = enable;
         }
 
-        // Basic primitives
-        void DrawLine(float x1, float y1, float x2, float y2, float r, float g, float b, float a) {
-            size_t startIdx = g_VertexBuffer.size();
-            AddVertex(x1, y1, r, g, b, a);
-            AddVertex(x2, y2, r, g, b, a);
-            g_CommandBuffer.push_back({ DrawCommandType::Lines, startIdx, 2, g_AntiAliasEnabled });
+        void SetDisplaySize(int width, int height) {
+            Context& ctx = GetCurrentContext();
+            ctx.displayWidth = width;
+            ctx.displayHeight = height;
         }
 
-        void DrawThickLine(float x1, float y1, float x2, float y2, float thickness, float r, float g, float b, float a) {
-            float dx = x2 - x1;
-            float dy = y2 - y1;
-            float len = sqrtf(dx * dx + dy * dy);
-            if (len < 0.001f) return;
+        void EnableShapeInstancing(bool enable) {
+            Context& ctx = GetCurrentContext();
+            ctx.shapeInstancing = enable;
+        }
+
+        void SetCurveTolerance(float maxPixelError) {
+            Context& ctx = GetCurrentContext();
+            ctx.curveTolerance = (maxPixelError >= MinCurveTolerance) ? maxPixelError : MinCurveTolerance;
+        }
+
+        void SetLineJoin(LineJoin join, float miterLimit) {
+            Context& ctx = GetCurrentContext();
+            ctx.lineJoin = join;
+            ctx.miterLimit = (miterLimit > 1.0f) ? miterLimit : 1.0f;
+        }
 
-            float nx = -dy / len;
-            float ny = dx / len;
-            float halfThick = thickness * 0.5f;
+        void SetLineCap(LineCap cap) {
+            GetCurrentContext().lineCap = cap;
+        }
 
-            float ox1 = nx * halfThick;
-            float oy1 = ny * halfThick;
+        void SetJobSystem(Jobs::JobSystem* jobs) {
+            Context& ctx = GetCurrentContext();
+            ctx.jobs = jobs;
+        }
 
-            size_t startIdx = g_VertexBuffer.size();
+        float EvaluateShapeCoverage(const ShapeInstance& shape, float px, float py) {
+            float halfW = shape.w * 0.5f;
+            float halfH = shape.h * 0.5f;
+            float lx = px - (shape.x + halfW);
+            float ly = py - (shape.y + halfH);
+
+            float qx = fabsf(lx) - halfW + shape.radius;
+            float qy = fabsf(ly) - halfH + shape.radius;
+            float ox = (qx > 0.0f) ? qx : 0.0f;
+            float oy = (qy > 0.0f) ? qy : 0.0f;
+            float inside = (qx > qy) ? qx : qy;
+            if (inside > 0.0f) inside = 0.0f;
+            float d = sqrtf(ox * ox + oy * oy) + inside - shape.radius;
+
+            if (shape.borderWidth > 0.0f)
+                d = fabsf(d + shape.borderWidth * 0.5f) - shape.borderWidth * 0.5f;
+
+            if (shape.feather > 0.0f)
+                return Saturate(0.5f - d / shape.feather);
+            return (d <= 0.0f) ? 1.0f : 0.0f;
+        }
 
-            // Create quad as two triangles
-            AddVertex(x1 - ox1, y1 - oy1, r, g, b, a);
-            AddVertex(x1 + ox1, y1 + oy1, r, g, b, a);
-            AddVertex(x2 + ox1, y2 + oy1, r, g, b, a);
+        // Basic primitives
+        void DrawLine(float x1, float y1, float x2, float y2, float r, float g, float b, float a) {
+            Context& ctx = GetCurrentContext();
+            const float points[4] = { x1, y1, x2, y2 };
+            AddPolyline(ctx, points, 2, false, 1.0f, ShapeColor(ctx, r, g, b, a));
+        }
 
-            AddVertex(x1 - ox1, y1 - oy1, r, g, b, a);
-            AddVertex(x2 + ox1, y2 + oy1, r, g, b, a);
-            AddVertex(x2 - ox1, y2 - oy1, r, g, b, a);
+        void DrawThickLine(float x1, float y1, float x2, float y2, float thickness, float r, float g, float b, float a) {
+            Context& ctx = GetCurrentContext();
+            float dx = x2 - x1;
+            float dy = y2 - y1;
+            if (dx * dx + dy * dy < 0.000001f) return;
 
-            g_CommandBuffer.push_back({ DrawCommandType::Triangles, startIdx, 6, false });
+            const float points[4] = { x1, y1, x2, y2 };
+            AddPolyline(ctx, points, 2, false, thickness, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawRect(float x, float y, float w, float h, float r, float g, float b, float a) {
-            DrawLine(x, y, x + w, y, r, g, b, a);
-            DrawLine(x + w, y, x + w, y + h, r, g, b, a);
-            DrawLine(x + w, y + h, x, y + h, r, g, b, a);
-            DrawLine(x, y + h, x, y, r, g, b, a);
+            Context& ctx = GetCurrentContext();
+            if (ctx.shapeInstancing) {
+                // 1px border centered on the edges, as DrawRectThick and the stroked outline below
+                AddShape(ctx, x - 0.5f, y - 0.5f, w + 1.0f, h + 1.0f, 0.0f, 1.0f, ShapeColor(ctx, r, g, b, a));
+                return;
+            }
+
+            const float points[8] = { x, y, x + w, y, x + w, y + h, x, y + h };
+            AddPolyline(ctx, points, 4, true, 1.0f, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawRectThick(float x, float y, float w, float h, float thickness, float r, float g, float b, float a) {
-            DrawThickLine(x, y, x + w, y, thickness, r, g, b, a);
-            DrawThickLine(x + w, y, x + w, y + h, thickness, r, g, b, a);
-            DrawThickLine(x + w, y + h, x, y + h, thickness, r, g, b, a);
-            DrawThickLine(x, y + h, x, y, thickness, r, g, b, a);
+            Context& ctx = GetCurrentContext();
+            if (ctx.shapeInstancing) {
+                // Border centered on the edges, like the stroked outline below
+                float half = thickness * 0.5f;
+                AddShape(ctx, x - half, y - half, w + thickness, h + thickness, 0.0f, thickness, ShapeColor(ctx, r, g, b, a));
+                return;
+            }
+
+            // One closed strip: corners are mitered (within any miter limit >= sqrt 2), not overlapped
+            const float points[8] = { x, y, x + w, y, x + w, y + h, x, y + h };
+            AddPolyline(ctx, points, 4, true, thickness, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawFilledRect(float x, float y, float w, float h, float r, float g, float b, float a) {
-            float ndcX1, ndcY1, ndcX2, ndcY2;
-            ToNDC(x, y, ndcX1, ndcY1);
-            ToNDC(x + w, y + h, ndcX2, ndcY2);
-
-            size_t startIdx = g_VertexBuffer.size();
-
-            // Triangle 1
-            g_VertexBuffer.push_back({ ndcX1, ndcY1, 0.0f, r, g, b, a * g_GlobalAlpha });
-            g_VertexBuffer.push_back({ ndcX2, ndcY1, 0.0f, r, g, b, a * g_GlobalAlpha });
-            g_VertexBuffer.push_back({ ndcX2, ndcY2, 0.0f, r, g, b, a * g_GlobalAlpha });
-
-            // Triangle 2
-            g_VertexBuffer.push_back({ ndcX1, ndcY1, 0.0f, r, g, b, a * g_GlobalAlpha });
-            g_VertexBuffer.push_back({ ndcX2, ndcY2, 0.0f, r, g, b, a * g_GlobalAlpha });
-            g_VertexBuffer.push_back({ ndcX1, ndcY2, 0.0f, r, g, b, a * g_GlobalAlpha });
+            Context& ctx = GetCurrentContext();
+            if (ctx.shapeInstancing) {
+                AddShape(ctx, x, y, w, h, 0.0f, 0.0f, ShapeColor(ctx, r, g, b, a));
+                return;
+            }
 
-            g_CommandBuffer.push_back({ DrawCommandType::Triangles, startIdx, 6, false });
+            const float points[8] = { x, y, x + w, y, x + w, y + h, x, y + h };
+            AddConvexFill(ctx, points, 4, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawRoundedRect(float x, float y, float w, float h, float radius, float r, float g, float b, float a) {
+            Context& ctx = GetCurrentContext();
+            if (ctx.shapeInstancing) {
+                AddShape(ctx, x, y, w, h, radius, 0.0f, ShapeColor(ctx, r, g, b, a));
+                return;
+            }
+
             float minDim = (w < h) ? w : h;
             float maxRadius = minDim * 0.5f;
             if (radius > maxRadius) radius = maxRadius;
 
-            int segments = (int)(radius * 0.5f + 8.0f);
-            if (segments < 4) segments = 4;
-            if (segments > 32) segments = 32;
+            int segments = ArcSegmentsForError(radius, 1.57079632679f, ctx.curveTolerance); // PI/2
+            if (segments < Curves::MinArcSegments) segments = Curves::MinArcSegments;
+            if (segments > Curves::MaxArcSegments) segments = Curves::MaxArcSegments;
 
-            size_t startIdx = g_VertexBuffer.size();
-            float angleStep = 1.57079632679f / (float)segments; // PI/2
+            // One quarter arc, shared by the four corners
+            const Curves::ArcTable& arc = Curves::QuarterArc(segments);
+            const float* cosTable = arc.cosTable;
+            const float* sinTable = arc.sinTable;
+            CountArcTable(*ctx.current, arc);
 
-            // Center point for triangle fan
-            float cx = x + w * 0.5f;
-            float cy = y + h * 0.5f;
-
-            // We'll build this as a filled polygon using triangle fan from center
-            std::vector<std::pair<float, float>> points;
+            // Outline points, filled as a convex fan
+            float points[(32 + 1) * 8];
+            float* p = points;
+            const float left = x + radius, right = x + w - radius;
+            const float top = y + radius, bottom = y + h - radius;
 
             // Top-right corner
-            for (int i = 0; i <= segments; i++) {
-                float angle = (float)i * angleStep;
-                float px = x + w - radius + radius * cosf(angle);
-                float py = y + radius - radius * sinf(angle);
-                points.push_back({ px, py });
+            for (int i = 0; i <= segments; i++, p += 2) {
+                p[0] = right + radius * cosTable[i];
+                p[1] = top - radius * sinTable[i];
             }
 
             // Bottom-right corner
-            for (int i = 0; i <= segments; i++) {
-                float angle = (float)i * angleStep;
-                float px = x + w - radius + radius * sinf(angle);
-                float py = y + h - radius + radius * cosf(angle);
-                points.push_back({ px, py });
+            for (int i = 0; i <= segments; i++, p += 2) {
+                p[0] = right + radius * sinTable[i];
+                p[1] = bottom + radius * cosTable[i];
             }
 
             // Bottom-left corner
-            for (int i = 0; i <= segments; i++) {
-                float angle = (float)i * angleStep;
-                float px = x + radius - radius * cosf(angle);
-                float py = y + h - radius + radius * sinf(angle);
-                points.push_back({ px, py });
+            for (int i = 0; i <= segments; i++, p += 2) {
+                p[0] = left - radius * cosTable[i];
+                p[1] = bottom + radius * sinTable[i];
             }
 
             // Top-left corner
-            for (int i = 0; i <= segments; i++) {
-                float angle = (float)i * angleStep;
-                float px = x + radius - radius * sinf(angle);
-                float py = y + radius - radius * cosf(angle);
-                points.push_back({ px, py });
-            }
-
-            // Create triangles from center
-            for (size_t i = 0; i < points.size(); i++) {
-                AddVertex(cx, cy, r, g, b, a);
-                AddVertex(points[i].first, points[i].second, r, g, b, a);
-                AddVertex(points[(i + 1) % points.size()].first, points[(i + 1) % points.size()].second, r, g, b, a);
+            for (int i = 0; i <= segments; i++, p += 2) {
+                p[0] = left - radius * sinTable[i];
+                p[1] = top - radius * cosTable[i];
             }
 
-            g_CommandBuffer.push_back({ DrawCommandType::Triangles, startIdx, g_VertexBuffer.size() - startIdx, false });
+            AddConvexFill(ctx, points, (segments + 1) * 4, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawFilledRoundedRect(float x, float y, float w, float h, float radius, float r, float g, float b, float a) {
@@ -188,235 +827,722 @@ namespace VGUI {
         }
 
         void DrawCircle(float cx, float cy, float radius, int segments, float r, float g, float b, float a) {
-            if (segments < 8) segments = 8;
-            if (segments > 128) segments = 128;
-
-            float angleStep = 6.28318530718f / (float)segments;
+            Context& ctx = GetCurrentContext();
+            if (ctx.shapeInstancing) {
+                // 1px ring centered on the radius
+                float outer = radius + 0.5f;
+                AddShape(ctx, cx - outer, cy - outer, outer * 2.0f, outer * 2.0f, outer, 1.0f, ShapeColor(ctx, r, g, b, a));
+                return;
+            }
 
-            size_t startIdx = g_VertexBuffer.size();
+            const Curves::ArcTable& circle = Curves::UnitCircle(CircleSegments(segments, radius, ctx.curveTolerance));
+            CountArcTable(*ctx.current, circle);
+            segments = circle.count;
+            float points[128 * 2];
             for (int i = 0; i < segments; i++) {
-                float angle1 = (float)i * angleStep;
-                float angle2 = (float)(i + 1) * angleStep;
-                float x1 = cx + radius * cosf(angle1);
-                float y1 = cy + radius * sinf(angle1);
-                float x2 = cx + radius * cosf(angle2);
-                float y2 = cy + radius * sinf(angle2);
-
-                AddVertex(x1, y1, r, g, b, a);
-                AddVertex(x2, y2, r, g, b, a);
+                points[i * 2] = cx + radius * circle.cosTable[i];
+                points[i * 2 + 1] = cy + radius * circle.sinTable[i];
             }
-            g_CommandBuffer.push_back({ DrawCommandType::Lines, startIdx, (size_t)(segments * 2), g_AntiAliasEnabled });
+            AddPolyline(ctx, points, segments, true, 1.0f, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawFilledCircle(float cx, float cy, float radius, int segments, float r, float g, float b, float a) {
-            if (segments < 8) segments = 8;
-            if (segments > 128) segments = 128;
-
-            float angleStep = 6.28318530718f / (float)segments;
-
-            size_t startIdx = g_VertexBuffer.size();
-            for (int i = 0; i < segments; i++) {
-                float angle1 = (float)i * angleStep;
-                float angle2 = (float)(i + 1) * angleStep;
-                float x1 = cx + radius * cosf(angle1);
-                float y1 = cy + radius * sinf(angle1);
-                float x2 = cx + radius * cosf(angle2);
-                float y2 = cy + radius * sinf(angle2);
-
-                AddVertex(cx, cy, r, g, b, a);
-                AddVertex(x1, y1, r, g, b, a);
-                AddVertex(x2, y2, r, g, b, a);
+            Context& ctx = GetCurrentContext();
+            if (ctx.shapeInstancing) {
+                AddShape(ctx, cx - radius, cy - radius, radius * 2.0f, radius * 2.0f, radius, 0.0f, ShapeColor(ctx, r, g, b, a));
+                return;
             }
-            g_CommandBuffer.push_back({ DrawCommandType::Triangles, startIdx, (size_t)(segments * 3), false });
+
+            DrawList& list = *ctx.current;
+            const Curves::ArcTable& circle = Curves::UnitCircle(CircleSegments(segments, radius, ctx.curveTolerance));
+            CountArcTable(list, circle);
+            segments = circle.count;
+            size_t indexStart = list.indices.size();
+            DrawIndex base;
+            PrimWriter out = PrimAppend(list, ConvexFillVertices(segments, ctx.antiAlias),
+                ConvexFillIndices(segments, ctx.antiAlias), base);
+            WriteCircleFill(out, base, cx, cy, radius, circle, ctx.antiAlias, ShapeColor(ctx, r, g, b, a));
+            if (ctx.antiAlias) list.fringeVertices += segments;
+            AddCommand(list, DrawCommandType::Triangles, indexStart, ctx.antiAlias);
         }
 
         void DrawTriangle(float x1, float y1, float x2, float y2, float x3, float y3, float r, float g, float b, float a) {
-            DrawLine(x1, y1, x2, y2, r, g, b, a);
-            DrawLine(x2, y2, x3, y3, r, g, b, a);
-            DrawLine(x3, y3, x1, y1, r, g, b, a);
+            Context& ctx = GetCurrentContext();
+            const float points[6] = { x1, y1, x2, y2, x3, y3 };
+            AddPolyline(ctx, points, 3, true, 1.0f, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawFilledTriangle(float x1, float y1, float x2, float y2, float x3, float y3, float r, float g, float b, float a) {
-            size_t startIdx = g_VertexBuffer.size();
-            AddVertex(x1, y1, r, g, b, a);
-            AddVertex(x2, y2, r, g, b, a);
-            AddVertex(x3, y3, r, g, b, a);
-            g_CommandBuffer.push_back({ DrawCommandType::Triangles, startIdx, 3, false });
+            Context& ctx = GetCurrentContext();
+            const float points[6] = { x1, y1, x2, y2, x3, y3 };
+            AddConvexFill(ctx, points, 3, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawGradientRect(float x, float y, float w, float h,
             float r1, float g1, float b1, float a1,
             float r2, float g2, float b2, float a2, bool horizontal) {
-            float ndcX1, ndcY1, ndcX2, ndcY2;
-            ToNDC(x, y, ndcX1, ndcY1);
-            ToNDC(x + w, y + h, ndcX2, ndcY2);
-
-            size_t startIdx = g_VertexBuffer.size();
+            Context& ctx = GetCurrentContext();
+            DrawList& list = *ctx.current;
+            VertexColor col1 = ShapeColor(ctx, r1, g1, b1, a1);
+            VertexColor col2 = ShapeColor(ctx, r2, g2, b2, a2);
+            size_t indexStart = list.indices.size();
+            DrawIndex base;
+            PrimWriter out = PrimAppend(list, 4, 6, base);
 
             if (horizontal) {
                 // Gradient left to right
-                g_VertexBuffer.push_back({ ndcX1, ndcY1, 0.0f, r1, g1, b1, a1 * g_GlobalAlpha });
-                g_VertexBuffer.push_back({ ndcX2, ndcY1, 0.0f, r2, g2, b2, a2 * g_GlobalAlpha });
-                g_VertexBuffer.push_back({ ndcX2, ndcY2, 0.0f, r2, g2, b2, a2 * g_GlobalAlpha });
-
-                g_VertexBuffer.push_back({ ndcX1, ndcY1, 0.0f, r1, g1, b1, a1 * g_GlobalAlpha });
-                g_VertexBuffer.push_back({ ndcX2, ndcY2, 0.0f, r2, g2, b2, a2 * g_GlobalAlpha });
-                g_VertexBuffer.push_back({ ndcX1, ndcY2, 0.0f, r1, g1, b1, a1 * g_GlobalAlpha });
+                out.AddVertex(x, y, col1);
+                out.AddVertex(x + w, y, col2);
+                out.AddVertex(x + w, y + h, col2);
+                out.AddVertex(x, y + h, col1);
             }
             else {
                 // Gradient top to bottom
-                g_VertexBuffer.push_back({ ndcX1, ndcY1, 0.0f, r1, g1, b1, a1 * g_GlobalAlpha });
-                g_VertexBuffer.push_back({ ndcX2, ndcY1, 0.0f, r1, g1, b1, a1 * g_GlobalAlpha });
-                g_VertexBuffer.push_back({ ndcX2, ndcY2, 0.0f, r2, g2, b2, a2 * g_GlobalAlpha });
+                out.AddVertex(x, y, col1);
+                out.AddVertex(x + w, y, col1);
+                out.AddVertex(x + w, y + h, col2);
+                out.AddVertex(x, y + h, col2);
+            }
+            out.AddTriangle(base, base + 1, base + 2);
+            out.AddTriangle(base, base + 2, base + 3);
+
+            AddCommand(list, DrawCommandType::Triangles, indexStart, false);
+        }
+
+        // Outlines with at least this many points keep their triangles in the context's cache; for
+        // smaller ones clipping again costs about as much as the lookup
+        const int MinCachedPolygonPoints = 64;
+
+        // Hash of an outline relative to its first point, the key of the triangulation cache
+        static uint64_t OutlineHash(const float* points, int pointCount) {
+            uint64_t h = HashValue(0, static_cast<uint64_t>(pointCount));
+            for (int i = 0; i < pointCount; i++) {
+                float d[2] = { points[i * 2] - points[0], points[i * 2 + 1] - points[1] };
+                uint64_t word;
+                memcpy(&word, d, 8);
+                h = HashValue(h, word);
+            }
+            return h;
+        }
 
-                g_VertexBuffer.push_back({ ndcX1, ndcY1, 0.0f, r1, g1, b1, a1 * g_GlobalAlpha });
-                g_VertexBuffer.push_back({ ndcX2, ndcY2, 0.0f, r2, g2, b2, a2 * g_GlobalAlpha });
-                g_VertexBuffer.push_back({ ndcX1, ndcY2, 0.0f, r2, g2, b2, a2 * g_GlobalAlpha });
+        // Triangles of a concave outline as index triples into points, from the cache when possible.
+        // Uncached ones are in ctx.scratch, so the caller holds an ArenaScope around their use.
+        static const uint32_t* TriangulateOutline(Context& ctx, const float* points, int pointCount, size_t& indexCount) {
+            uint64_t hash = 0;
+            if (pointCount >= MinCachedPolygonPoints) {
+                hash = OutlineHash(points, pointCount);
+                if (const std::vector<uint32_t>* cached = ctx.triangulationCache.Find(hash, pointCount)) {
+                    ctx.polygonCacheHits++;
+                    indexCount = cached->size();
+                    return cached->data();
+                }
             }
+            ctx.polygonCacheMisses++;
+            Memory::ArenaVector<uint32_t> triangles(ctx.scratch);
+            Polygon::Triangulator triangulator(ctx.scratch);
+            triangulator.Triangulate(points, pointCount, triangles);
+            indexCount = triangles.size();
+            if (pointCount < MinCachedPolygonPoints) return triangles.data();
+            return ctx.triangulationCache.Insert(hash, pointCount, triangles.data(), triangles.size()).data();
+        }
+
+        // Fill of an outline too large for one index window. The triangles go out in chunks that fit
+        // a window each and share vertices within it; with anti-aliasing (normals set) they are inset
+        // and the fringe follows as strips of quads.
+        static void AddLargeFill(Context& ctx, const float* points, int pointCount, const uint32_t* triangles,
+            size_t triangleCount, const float* normals, float offset, VertexColor col) {
+            DrawList& list = *ctx.current;
+
+            // remap[p * 2] is the stamp of the last pass that saw point p, remap[p * 2 + 1] its vertex
+            Memory::ArenaScope scope(ctx.scratch);
+            uint32_t* remap = ctx.scratch.AllocateArray<uint32_t>(static_cast<size_t>(pointCount) * 2);
+            memset(remap, 0, static_cast<size_t>(pointCount) * 2 * sizeof(uint32_t));
+            uint32_t stamp = 0;
+            for (size_t first = 0; first < triangleCount;) {
+                // Count pass: take triangles while their vertices fit the window
+                const uint32_t countStamp = ++stamp;
+                size_t vertexCount = 0, last = first;
+                for (; last < triangleCount && vertexCount + 3 <= MaxVerticesPerWindow; last++) {
+                    for (int k = 0; k < 3; k++) {
+                        uint32_t p = triangles[last * 3 + k];
+                        if (remap[p * 2] != countStamp) {
+                            remap[p * 2] = countStamp;
+                            vertexCount++;
+                        }
+                    }
+                }
 
-            g_CommandBuffer.push_back({ DrawCommandType::Triangles, startIdx, 6, false });
+                const uint32_t writeStamp = ++stamp;
+                size_t indexStart = list.indices.size();
+                DrawIndex base;
+                PrimWriter out = PrimAppend(list, vertexCount, (last - first) * 3, base);
+                unsigned int next = base;
+                for (size_t t = first; t < last; t++) {
+                    for (int k = 0; k < 3; k++) {
+                        uint32_t p = triangles[t * 3 + k];
+                        if (remap[p * 2] != writeStamp) {
+                            remap[p * 2] = writeStamp;
+                            remap[p * 2 + 1] = next++;
+                            float x = points[p * 2], y = points[p * 2 + 1];
+                            if (normals) {
+                                x -= normals[p * 2] * offset;
+                                y -= normals[p * 2 + 1] * offset;
+                            }
+                            out.AddVertex(x, y, col);
+                        }
+                        out.AddIndex(remap[p * 2 + 1]);
+                    }
+                }
+                AddCommand(list, DrawCommandType::Triangles, indexStart, normals != nullptr);
+                first = last;
+            }
+            if (!normals) return;
+
+            const VertexColor fringeCol = TransparentColor(col);
+            const int maxChunk = static_cast<int>(MaxVerticesPerWindow / 2) - 1;
+            for (int first = 0; first < pointCount; first += maxChunk) {
+                int count = std::min(pointCount - first, maxChunk);
+                size_t indexStart = list.indices.size();
+                DrawIndex base;
+                PrimWriter out = PrimAppend(list, (count + 1) * 2, count * 6, base);
+                for (int i = 0; i <= count; i++) {
+                    int p = (first + i) % pointCount;
+                    float x = points[p * 2], y = points[p * 2 + 1];
+                    float ox = normals[p * 2] * offset, oy = normals[p * 2 + 1] * offset;
+                    out.AddVertex(x - ox, y - oy, col);
+                    out.AddVertex(x + ox, y + oy, fringeCol);
+                }
+                for (int i = 0; i < count; i++) {
+                    unsigned int i1 = base + i * 2;
+                    unsigned int i2 = i1 + 2;
+                    out.AddTriangle(i2, i1, i1 + 1);
+                    out.AddTriangle(i1 + 1, i2 + 1, i2);
+                }
+                list.fringeVertices += count + 1;
+                AddCommand(list, DrawCommandType::Triangles, indexStart, true);
+            }
         }
 
         void DrawPolygon(const float* points, int pointCount, float r, float g, float b, float a) {
+            Context& ctx = GetCurrentContext();
             if (pointCount < 3) return;
+            AddPolyline(ctx, points, pointCount, true, 1.0f, ShapeColor(ctx, r, g, b, a));
+        }
 
-            size_t startIdx = g_VertexBuffer.size();
-            for (int i = 0; i < pointCount; i++) {
-                int next = (i + 1) % pointCount;
-                AddVertex(points[i * 2], points[i * 2 + 1], r, g, b, a);
-                AddVertex(points[next * 2], points[next * 2 + 1], r, g, b, a);
-            }
-            g_CommandBuffer.push_back({ DrawCommandType::Lines, startIdx, (size_t)(pointCount * 2), g_AntiAliasEnabled });
+        void DrawPolyline(const float* points, int pointCount, bool closed, float thickness,
+            float r, float g, float b, float a) {
+            Context& ctx = GetCurrentContext();
+            if (thickness <= 0.0f) return;
+            AddPolyline(ctx, points, pointCount, closed, thickness, ShapeColor(ctx, r, g, b, a));
         }
 
         void DrawFilledPolygon(const float* points, int pointCount, float r, float g, float b, float a) {
+            Context& ctx = GetCurrentContext();
+            DrawList& list = *ctx.current;
             if (pointCount < 3) return;
+            VertexColor col = ShapeColor(ctx, r, g, b, a);
+            const bool convex = Polygon::IsConvex(points, pointCount);
 
-            // Calculate centroid
-            float cx = 0, cy = 0;
-            for (int i = 0; i < pointCount; i++) {
-                cx += points[i * 2];
-                cy += points[i * 2 + 1];
+            if (ConvexFillVertices(pointCount, ctx.antiAlias) <= MaxVerticesPerWindow) {
+                if (convex) {
+                    AddConvexFill(ctx, points, pointCount, col);
+                    return;
+                }
+
+                // Same vertices as a convex fill, the triangles index them
+                Memory::ArenaScope scope(ctx.scratch);
+                size_t indexCount;
+                const uint32_t* triangles = TriangulateOutline(ctx, points, pointCount, indexCount);
+                if (indexCount == 0 && !ctx.antiAlias) return;
+                float* normals = ctx.antiAlias ? ctx.scratch.AllocateArray<float>(static_cast<size_t>(pointCount) * 2) : nullptr;
+                const unsigned int stride = ctx.antiAlias ? 2 : 1;
+                size_t indexStart = list.indices.size();
+                DrawIndex base;
+                PrimWriter out = PrimAppend(list, ConvexFillVertices(pointCount, ctx.antiAlias),
+                    indexCount + (ctx.antiAlias ? static_cast<size_t>(pointCount) * 6 : 0), base);
+                WriteFillVertices(out, points, pointCount, ctx.antiAlias, normals, col);
+                for (size_t k = 0; k < indexCount; k++)
+                    out.AddIndex(base + triangles[k] * stride);
+                if (ctx.antiAlias) {
+                    WriteFillFringeIndices(out, base, pointCount);
+                    list.fringeVertices += pointCount;
+                }
+                AddCommand(list, DrawCommandType::Triangles, indexStart, ctx.antiAlias);
+                return;
             }
-            cx /= (float)pointCount;
-            cy /= (float)pointCount;
 
-            size_t startIdx = g_VertexBuffer.size();
-            for (int i = 0; i < pointCount; i++) {
-                int next = (i + 1) % pointCount;
-                AddVertex(cx, cy, r, g, b, a);
-                AddVertex(points[i * 2], points[i * 2 + 1], r, g, b, a);
-                AddVertex(points[next * 2], points[next * 2 + 1], r, g, b, a);
+            // Huge outlines: a fan around point 0 when convex, then split across windows
+            Memory::ArenaScope scope(ctx.scratch);
+            size_t indexCount;
+            const uint32_t* triangles;
+            if (convex) {
+                uint32_t* fan = ctx.scratch.AllocateArray<uint32_t>(static_cast<size_t>(pointCount - 2) * 3);
+                for (int i = 2; i < pointCount; i++) {
+                    fan[(i - 2) * 3] = 0;
+                    fan[(i - 2) * 3 + 1] = static_cast<uint32_t>(i - 1);
+                    fan[(i - 2) * 3 + 2] = static_cast<uint32_t>(i);
+                }
+                triangles = fan;
+                indexCount = static_cast<size_t>(pointCount - 2) * 3;
+            }
+            else {
+                triangles = TriangulateOutline(ctx, points, pointCount, indexCount);
+            }
+            float* normals = nullptr;
+            float offset = 0.0f;
+            if (ctx.antiAlias) {
+                normals = ctx.scratch.AllocateArray<float>(static_cast<size_t>(pointCount) * 2);
+                ComputeNormals(points, pointCount, true, normals);
+                offset = FillFringeOffset(points, pointCount);
             }
-            g_CommandBuffer.push_back({ DrawCommandType::Triangles, startIdx, (size_t)(pointCount * 3), false });
+            AddLargeFill(ctx, points, pointCount, triangles, indexCount / 3, normals, offset, col);
         }
 
         void DrawBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
             int segments, float r, float g, float b, float a) {
-            if (segments < 4) segments = 4;
-            if (segments > 64) segments = 64;
-
-            size_t startIdx = g_VertexBuffer.size();
+            Context& ctx = GetCurrentContext();
+            float points[(MaxCurveSegments + 1) * 2];
+            int pointCount = CubicBezierPolyline(x1, y1, x2, y2, x3, y3, x4, y4, segments, ctx.curveTolerance, points);
+            AddPolyline(ctx, points, pointCount, false, 1.0f, ShapeColor(ctx, r, g, b, a));
+        }
 
-            float prevX = x1, prevY = y1;
-            for (int i = 1; i <= segments; i++) {
-                float t = (float)i / (float)segments;
-                float t2 = t * t;
-                float t3 = t2 * t;
-                float mt = 1.0f - t;
-                float mt2 = mt * mt;
-                float mt3 = mt2 * mt;
+        void DrawQuadraticBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3,
+            int segments, float r, float g, float b, float a) {
+            Context& ctx = GetCurrentContext();
+            float points[(MaxCurveSegments + 1) * 2];
+            int pointCount;
+            if (segments <= 0) {
+                points[0] = x1;
+                points[1] = y1;
+                pointCount = Curves::FlattenQuadraticBezier(x1, y1, x2, y2, x3, y3, ctx.curveTolerance, points + 2,
+                    MaxCurveSegments) + 1;
+            }
+            else {
+                // Degree elevation: the same curve as a cubic with controls 2/3 of the way to (x2, y2)
+                const float cx1 = x1 + (x2 - x1) * (2.0f / 3.0f), cy1 = y1 + (y2 - y1) * (2.0f / 3.0f);
+                const float cx2 = x3 + (x2 - x3) * (2.0f / 3.0f), cy2 = y3 + (y2 - y3) * (2.0f / 3.0f);
+                pointCount = CubicBezierPolyline(x1, y1, cx1, cy1, cx2, cy2, x3, y3, segments, ctx.curveTolerance, points);
+            }
+            AddPolyline(ctx, points, pointCount, false, 1.0f, ShapeColor(ctx, r, g, b, a));
+        }
 
-                float x = mt3 * x1 + 3.0f * mt2 * t * x2 + 3.0f * mt * t2 * x3 + t3 * x4;
-                float y = mt3 * y1 + 3.0f * mt2 * t * y2 + 3.0f * mt * t2 * y3 + t3 * y4;
+        void DrawCatmullRomSpline(const float* points, int pointCount, bool closed, int segments,
+            float r, float g, float b, float a) {
+            Context& ctx = GetCurrentContext();
+            if (pointCount < 2) return;
+
+            // Span i runs from point i to point i + 1 as the cubic with controls
+            // p[i] + (p[i + 1] - p[i - 1]) / 6 and p[i + 1] - (p[i + 2] - p[i]) / 6. Open splines
+            // repeat their end points as the missing neighbours.
+            const int spans = closed ? pointCount : pointCount - 1;
+            auto point = [&](int i) {
+                if (closed) i = (i + pointCount) % pointCount;
+                else i = (i < 0) ? 0 : (i >= pointCount) ? pointCount - 1 : i;
+                return points + i * 2;
+            };
+
+            Memory::ArenaScope scope(ctx.scratch);
+            Memory::ArenaVector<float> out(ctx.scratch);
+            size_t used = 2;
+            out.resize(2);
+            out[0] = points[0];
+            out[1] = points[1];
+            for (int i = 0; i < spans; i++) {
+                const float* p0 = point(i - 1);
+                const float* p1 = point(i);
+                const float* p2 = point(i + 1);
+                const float* p3 = point(i + 2);
+                const float c1x = p1[0] + (p2[0] - p0[0]) * (1.0f / 6.0f), c1y = p1[1] + (p2[1] - p0[1]) * (1.0f / 6.0f);
+                const float c2x = p2[0] - (p3[0] - p1[0]) * (1.0f / 6.0f), c2y = p2[1] - (p3[1] - p1[1]) * (1.0f / 6.0f);
+
+                // Each span's first point is the previous span's last, written over in place
+                out.resize(used + MaxCurveSegments * 2);
+                int spanPoints = CubicBezierPolyline(p1[0], p1[1], c1x, c1y, c2x, c2y, p2[0], p2[1], segments,
+                    ctx.curveTolerance, out.data() + used - 2);
+                used += static_cast<size_t>(spanPoints - 1) * 2;
+            }
 
-                AddVertex(prevX, prevY, r, g, b, a);
-                AddVertex(x, y, r, g, b, a);
+            // The last span ended on point 0, which a closed polyline joins back to on its own
+            int outCount = static_cast<int>(used / 2);
+            if (closed) outCount--;
+            AddPolyline(ctx, out.data(), outCount, closed, 1.0f, ShapeColor(ctx, r, g, b, a));
+        }
 
-                prevX = x;
-                prevY = y;
+        // Batches smaller than this are tessellated on the calling thread, and a job covers at
+        // least BatchGrain shapes, so the per-range overhead stays small next to the work
+        const size_t MinParallelBatch = 1024;
+        const size_t BatchGrain = 256;
+
+        // Records count primitives of one type in a single pass. size(i, vertexCount, indexCount)
+        // gives each primitive's output size, write(i, out, base) tessellates it. Index windows are
+        // planned first exactly like PrimReserve() would place the primitives one by one, the
+        // vertex and index arrays are grown once, and the primitives are written and hashed into
+        // their disjoint ranges on the job system. Commands and the list hash are then chained in
+        // submission order, so the list is the same as if every primitive had been added alone.
+        template <typename SizeFunction, typename WriteFunction>
+        static void AddBatch(Context& ctx, size_t count, DrawCommandType type, bool antiAlias,
+            const SizeFunction& size, const WriteFunction& write) {
+            DrawList& list = *ctx.current;
+            HashPending(list);
+
+            Memory::ArenaScope scope(ctx.scratch);
+            BatchPrimitive* plan = ctx.scratch.AllocateArray<BatchPrimitive>(count);
+            size_t vertexEnd = list.vertices.size();
+            size_t indexEnd = list.indices.size();
+            size_t windowBase = list.windowBase;
+            for (size_t i = 0; i < count; i++) {
+                size_t vertexCount, indexCount;
+                size(i, vertexCount, indexCount);
+                if (vertexEnd + vertexCount - windowBase > MaxVerticesPerWindow)
+                    windowBase = vertexEnd;
+                plan[i] = { vertexEnd, indexEnd, windowBase, 0 };
+                vertexEnd += vertexCount;
+                indexEnd += indexCount;
             }
-            g_CommandBuffer.push_back({ DrawCommandType::Lines, startIdx, (size_t)(segments * 2), g_AntiAliasEnabled });
+            list.vertices.resize(vertexEnd);
+            list.indices.resize(indexEnd);
+
+            auto writeRange = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    BatchPrimitive& prim = plan[i];
+                    size_t primVertexEnd = (i + 1 < count) ? plan[i + 1].vertexStart : vertexEnd;
+                    size_t primIndexEnd = (i + 1 < count) ? plan[i + 1].indexStart : indexEnd;
+                    PrimWriter out = { list.vertices.data() + prim.vertexStart, list.indices.data() + prim.indexStart };
+                    write(i, out, static_cast<unsigned int>(prim.vertexStart - prim.windowBase));
+                    prim.hash = HashGeometry(list.vertices.data() + prim.vertexStart, primVertexEnd - prim.vertexStart,
+                        list.indices.data() + prim.indexStart, primIndexEnd - prim.indexStart);
+                }
+            };
+            if (ctx.jobs && count >= MinParallelBatch) ctx.jobs->ParallelFor(count, BatchGrain, writeRange);
+            else writeRange(0, count);
+
+            list.commands.reserve(list.commands.size() + count);
+            for (size_t i = 0; i < count; i++) {
+                const BatchPrimitive& prim = plan[i];
+                size_t primVertexEnd = (i + 1 < count) ? plan[i + 1].vertexStart : vertexEnd;
+                size_t primIndexEnd = (i + 1 < count) ? plan[i + 1].indexStart : indexEnd;
+                list.commands.push_back({ type, prim.windowBase, primVertexEnd - prim.windowBase,
+                    prim.indexStart, primIndexEnd - prim.indexStart, antiAlias });
+                list.hash = HashValue(HashValue(list.hash, prim.hash),
+                    static_cast<uint64_t>(type) | (static_cast<uint64_t>(prim.windowBase) << 8));
+            }
+            list.windowBase = windowBase;
+            list.hashedVertices = vertexEnd;
+            list.hashedIndices = indexEnd;
         }
 
-        void Render() {
-            if (g_VertexBuffer.empty() || g_CommandBuffer.empty()) {
-                g_VertexBuffer.clear();
-                g_CommandBuffer.clear();
+        void DrawFilledCircles(const CircleDesc* circles, size_t count) {
+            Context& ctx = GetCurrentContext();
+            if (ctx.shapeInstancing) {
+                for (size_t i = 0; i < count; i++) {
+                    const CircleDesc& c = circles[i];
+                    DrawFilledCircle(c.cx, c.cy, c.radius, c.segments, c.r, c.g, c.b, c.a);
+                }
                 return;
             }
 
-            ID3D11Device* device = Core::GetDevice();
-            ID3D11DeviceContext* context = Core::GetContext();
+            const bool antiAlias = ctx.antiAlias;
+            const float tolerance = ctx.curveTolerance;
+            size_t fringeVertices = 0;
+            DrawList& list = *ctx.current;
+            auto size = [&](size_t i, size_t& vertexCount, size_t& indexCount) {
+                const CircleDesc& c = circles[i];
+                const Curves::ArcTable& circle = Curves::UnitCircle(CircleSegments(c.segments, c.radius, tolerance));
+                CountArcTable(list, circle);
+                vertexCount = ConvexFillVertices(circle.count, antiAlias);
+                indexCount = ConvexFillIndices(circle.count, antiAlias);
+                if (antiAlias) fringeVertices += circle.count;
+            };
+            auto write = [&](size_t i, PrimWriter& out, unsigned int base) {
+                const CircleDesc& c = circles[i];
+                WriteCircleFill(out, base, c.cx, c.cy, c.radius, Curves::UnitCircle(CircleSegments(c.segments, c.radius, tolerance)),
+                    antiAlias,
+                    ShapeColor(ctx, c.r, c.g, c.b, c.a));
+            };
+            AddBatch(ctx, count, DrawCommandType::Triangles, antiAlias, size, write);
+            list.fringeVertices += fringeVertices;
+        }
 
-            if (!device || !context) {
-                g_VertexBuffer.clear();
-                g_CommandBuffer.clear();
-                return;
-            }
+        void DrawBezierCurves(const BezierDesc* curves, size_t count) {
+            Context& ctx = GetCurrentContext();
+            const bool antiAlias = ctx.antiAlias;
+            const float tolerance = ctx.curveTolerance;
+            const StrokeRows rows = GetStrokeRows(1.0f, antiAlias);
+            size_t fringeVertices = 0;
+            auto size = [&](size_t i, size_t& vertexCount, size_t& indexCount) {
+                const BezierDesc& c = curves[i];
+                int pointCount = CubicBezierPolyline(c.x1, c.y1, c.x2, c.y2, c.x3, c.y3, c.x4, c.y4, c.segments, tolerance, nullptr);
+                vertexCount = antiAlias ? StrokeChunkVertices(pointCount, rows) : LineChunkVertices(0, pointCount, false);
+                indexCount = antiAlias ? StrokeChunkIndices(pointCount, rows) : LineChunkIndices(pointCount, false);
+                if (antiAlias) fringeVertices += pointCount * 2;
+            };
+            auto write = [&](size_t i, PrimWriter& out, unsigned int base) {
+                const BezierDesc& c = curves[i];
+                float points[(MaxCurveSegments + 1) * 2];
+                int pointCount = CubicBezierPolyline(c.x1, c.y1, c.x2, c.y2, c.x3, c.y3, c.x4, c.y4, c.segments, tolerance, points);
+
+                VertexColor col = ShapeColor(ctx, c.r, c.g, c.b, c.a);
+                if (antiAlias) {
+                    float normals[(MaxCurveSegments + 1) * 2];
+                    StrokeStation stations[MaxCurveSegments + 1];
+                    ComputeNormals(points, pointCount, false, normals);
+                    MiterStations(points, normals, pointCount, false, stations);
+                    WriteStrokeChunk(out, base, stations, pointCount, rows, col);
+                }
+                else {
+                    WriteLineChunk(out, base, points, 0, pointCount, false, col);
+                }
+            };
+            AddBatch(ctx, count, antiAlias ? DrawCommandType::TriangleStrip : DrawCommandType::LineStrip, antiAlias, size, write);
+            ctx.current->fringeVertices += fringeVertices;
+        }
+
+        DrawData GetDrawData(const DrawList& list) {
+            DrawData data;
+            data.vertices = list.vertices.data();
+            data.vertexCount = list.vertices.size();
+            data.indices = list.indices.data();
+            data.indexCount = list.indices.size();
+            data.commands = list.commands.data();
+            data.commandCount = list.commands.size();
+            data.instances = list.instances.data();
+            data.instanceCount = list.instances.size();
+            return data;
+        }
+
+        DrawData GetDrawData() {
+            return GetDrawData(GetCurrentContext().frameList);
+        }
 
-            // Release old buffer
-            if (g_D3DVertexBuffer) {
-                g_D3DVertexBuffer->Release();
-                g_D3DVertexBuffer = nullptr;
+        // Coalesces runs of adjacent commands with the same topology and index window into one draw.
+        // Fringes are plain geometry, so anti-aliased and hard-edged commands batch together, and
+        // strips end with StripRestartIndex, so they concatenate like lists.
+        // Indices of a run are already contiguous, so this is a linear in-place compaction.
+        static void MergeCommands(std::vector<DrawCommand>& commands) {
+            if (commands.empty()) return;
+
+            size_t out = 0;
+            for (size_t i = 1; i < commands.size(); i++) {
+                DrawCommand& last = commands[out];
+                const DrawCommand& cmd = commands[i];
+                if (cmd.type == last.type &&
+                    cmd.vertexStart == last.vertexStart &&
+                    cmd.indexStart == last.indexStart + last.indexCount) {
+                    last.indexCount += cmd.indexCount;
+                    last.antiAlias = last.antiAlias || cmd.antiAlias;
+                    if (cmd.vertexCount > last.vertexCount) last.vertexCount = cmd.vertexCount;
+                }
+                else {
+                    commands[++out] = cmd;
+                }
             }
+            commands.resize(out + 1);
+        }
 
-            // Create vertex buffer
-            D3D11_BUFFER_DESC bd = {};
-            bd.Usage = D3D11_USAGE_DEFAULT;
-            bd.ByteWidth = sizeof(Vertex) * static_cast<UINT>(g_VertexBuffer.size());
-            bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-            bd.CPUAccessFlags = 0;
+        void DrawList::Clear() {
+            vertices.clear();
+            indices.clear();
+            commands.clear();
+            instances.clear();
+            windowBase = 0;
+            fringeVertices = 0;
+            arcTableHits = 0;
+            arcTableMisses = 0;
+            hash = 0;
+            hashedVertices = 0;
+            hashedIndices = 0;
+        }
 
-            D3D11_SUBRESOURCE_DATA initData = {};
-            initData.pSysMem = g_VertexBuffer.data();
+        void BeginDrawList(DrawList& list) {
+            list.Clear();
+            GetCurrentContext().current = &list;
+        }
 
-            if (FAILED(device->CreateBuffer(&bd, &initData, &g_D3DVertexBuffer))) {
-                g_VertexBuffer.clear();
-                g_CommandBuffer.clear();
-                return;
+        void EndDrawList() {
+            Context& ctx = GetCurrentContext();
+            if (ctx.current == &ctx.frameList) return;
+            // Merge once here so every replay copies the batched commands
+            MergeCommands(ctx.current->commands);
+            ctx.current = &ctx.frameList;
+        }
+
+        // Appends a recorded list to dst with one copy per stream
+        static void AppendDrawList(DrawList& dst, const DrawList& list, float offsetX, float offsetY) {
+            HashPending(dst);
+            size_t vertexBase = dst.vertices.size();
+            size_t indexBase = dst.indices.size();
+            size_t instanceBase = dst.instances.size();
+
+            // Indices are window-relative, so they copy verbatim; only the commands are rebased
+            dst.indices.insert(dst.indices.end(), list.indices.begin(), list.indices.end());
+            dst.vertices.insert(dst.vertices.end(), list.vertices.begin(), list.vertices.end());
+            dst.instances.insert(dst.instances.end(), list.instances.begin(), list.instances.end());
+            if (offsetX != 0.0f || offsetY != 0.0f) {
+                for (size_t i = vertexBase; i < dst.vertices.size(); i++) {
+                    dst.vertices[i].x += offsetX;
+                    dst.vertices[i].y += offsetY;
+                }
+                for (size_t i = instanceBase; i < dst.instances.size(); i++) {
+                    dst.instances[i].x += offsetX;
+                    dst.instances[i].y += offsetY;
+                }
             }
 
-            // Set vertex buffer
-            UINT stride = sizeof(Vertex);
-            UINT offset = 0;
-            context->IASetVertexBuffers(0, 1, &g_D3DVertexBuffer, &stride, &offset);
-
-            // Set shader pipeline
-            context->IASetInputLayout(Core::GetInputLayout());
-            context->VSSetShader(Core::GetVertexShader(), nullptr, 0);
-            context->PSSetShader(Core::GetPixelShader(), nullptr, 0);
-            context->OMSetBlendState(Core::GetBlendState(), nullptr, 0xffffffff);
-            context->RSSetState(Core::GetRasterizerState());
-
-            // Execute draw commands
-            for (const auto& cmd : g_CommandBuffer) {
-                switch (cmd.type) {
-                case DrawCommandType::Lines:
-                    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
-                    context->Draw(static_cast<UINT>(cmd.vertexCount), static_cast<UINT>(cmd.vertexStart));
-                    break;
-
-                case DrawCommandType::Triangles:
-                    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-                    context->Draw(static_cast<UINT>(cmd.vertexCount), static_cast<UINT>(cmd.vertexStart));
-                    break;
-
-                case DrawCommandType::TriangleStrip:
-                    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-                    context->Draw(static_cast<UINT>(cmd.vertexCount), static_cast<UINT>(cmd.vertexStart));
-                    break;
-
-                case DrawCommandType::LineStrip:
-                    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP);
-                    context->Draw(static_cast<UINT>(cmd.vertexCount), static_cast<UINT>(cmd.vertexStart));
-                    break;
+            size_t commandBase = dst.commands.size();
+            dst.commands.insert(dst.commands.end(), list.commands.begin(), list.commands.end());
+            for (size_t i = commandBase; i < dst.commands.size(); i++) {
+                DrawCommand& cmd = dst.commands[i];
+                if (cmd.type == DrawCommandType::Shapes) {
+                    cmd.indexStart += instanceBase;
+                }
+                else {
+                    cmd.vertexStart += vertexBase;
+                    cmd.indexStart += indexBase;
                 }
             }
+            dst.fringeVertices += list.fringeVertices;
+            dst.arcTableHits += list.arcTableHits;
+            dst.arcTableMisses += list.arcTableMisses;
+
+            // The copied data is covered by the list hash; the rebasing follows from what dst held before
+            uint32_t ox, oy;
+            memcpy(&ox, &offsetX, 4);
+            memcpy(&oy, &offsetY, 4);
+            dst.hash = HashValue(HashValue(dst.hash, list.hash), ox | (static_cast<uint64_t>(oy) << 32));
+            dst.hashedVertices = dst.vertices.size();
+            dst.hashedIndices = dst.indices.size();
+        }
+
+        void SubmitDrawList(const DrawList& list, float offsetX, float offsetY) {
+            DrawList& dst = *GetCurrentContext().current;
+            if (&list == &dst || list.commands.empty()) return;
+            AppendDrawList(dst, list, offsetX, offsetY);
+        }
+
+        // Appends the lists other threads published (ThreadRecorder) to the frame, sorted so the
+        // result does not depend on which thread published first. The frame's streams are grown
+        // once for all of them, so each payload is copied a single time before the upload.
+        static void MergePublished(Context& ctx) {
+            PublishedList* node = ctx.published.exchange(nullptr, std::memory_order_acquire);
+            if (!node) return;
+
+            std::vector<PublishedList*>& lists = ctx.mergeScratch;
+            lists.clear();
+            size_t vertexCount = 0, indexCount = 0, instanceCount = 0, commandCount = 0;
+            for (; node; node = node->next) {
+                lists.push_back(node);
+                vertexCount += node->list->vertices.size();
+                indexCount += node->list->indices.size();
+                instanceCount += node->list->instances.size();
+                commandCount += node->list->commands.size();
+            }
+            std::sort(lists.begin(), lists.end(), [](const PublishedList* a, const PublishedList* b) {
+                return (a->order != b->order) ? a->order < b->order : a->sequence < b->sequence;
+            });
+
+            DrawList& dst = ctx.frameList;
+            dst.vertices.reserve(dst.vertices.size() + vertexCount);
+            dst.indices.reserve(dst.indices.size() + indexCount);
+            dst.instances.reserve(dst.instances.size() + instanceCount);
+            dst.commands.reserve(dst.commands.size() + commandCount);
+            for (PublishedList* published : lists) {
+                AppendDrawList(dst, *published->list, 0.0f, 0.0f);
+                ctx.polygonCacheHits += published->stats.polygonCacheHits;
+                ctx.polygonCacheMisses += published->stats.polygonCacheMisses;
+                // Hands the list back to its thread; nothing below may touch it
+                published->pending.store(false, std::memory_order_release);
+            }
+        }
+
+        // Hash of the frame recorded so far, including the output size the projection depends on
+        static uint64_t CurrentFrameHash(Context& ctx) {
+            HashPending(ctx.frameList);
+            return HashValue(ctx.frameList.hash,
+                static_cast<uint32_t>(ctx.displayWidth) | (static_cast<uint64_t>(static_cast<uint32_t>(ctx.displayHeight)) << 32));
+        }
+
+        uint64_t GetFrameHash() {
+            Context& ctx = GetCurrentContext();
+            MergePublished(ctx);
+            return CurrentFrameHash(ctx);
+        }
+
+        bool FrameChanged() {
+            Context& ctx = GetCurrentContext();
+            MergePublished(ctx);
+            return !ctx.hasLastFrame || CurrentFrameHash(ctx) != ctx.lastFrameHash;
+        }
+
+        // Per-frame bookkeeping outside the frame list: triangulations not used lately are dropped
+        static void EndCacheFrame(Context& ctx) {
+            ctx.triangulationCache.EndFrame();
+            ctx.scratch.Reset();
+            ctx.polygonCacheHits = 0;
+            ctx.polygonCacheMisses = 0;
+        }
+
+        static void EndFrame(Context& ctx) {
+            ctx.frameList.Clear();
+            EndCacheFrame(ctx);
+        }
+
+        RecordedFrameStats EndRecordedFrame() {
+            Context& ctx = GetCurrentContext();
+            EndDrawList();
+            RecordedFrameStats stats = { ctx.polygonCacheHits, ctx.polygonCacheMisses };
+            EndCacheFrame(ctx);
+            return stats;
+        }
+
+        void DiscardFrame() {
+            Context& ctx = GetCurrentContext();
+            ctx.skippedFrames++;
+            ctx.frameStats.skippedFrames = ctx.skippedFrames;
+            EndFrame(ctx);
+        }
+
+        static void ResetFrame(Context& ctx) {
+            ctx.lastFrameHash = CurrentFrameHash(ctx);
+            ctx.hasLastFrame = true;
+            EndFrame(ctx);
+        }
+
+        void Render() {
+            Context& ctx = GetCurrentContext();
+            MergePublished(ctx);
+            DrawList& list = ctx.frameList;
+            FrameStats& stats = ctx.frameStats;
+            stats.commandsRecorded = list.commands.size();
+            stats.vertices = list.vertices.size();
+            stats.indices = list.indices.size();
+            stats.instances = list.instances.size();
+            stats.fringeVertices = list.fringeVertices;
+            stats.arcTableHits = list.arcTableHits;
+            stats.arcTableMisses = list.arcTableMisses;
+            stats.polygonCacheHits = ctx.polygonCacheHits;
+            stats.polygonCacheMisses = ctx.polygonCacheMisses;
+            stats.scratchBytes = ctx.scratch.GetStats().frameBytes;
+            stats.scratchCapacity = ctx.scratch.GetStats().capacity;
+            stats.skippedFrames = ctx.skippedFrames;
+            stats.drawCalls = 0;
+
+            if (list.commands.empty()) {
+                ResetFrame(ctx);
+                return;
+            }
+
+            MergeCommands(list.commands);
+            stats.drawCalls = list.commands.size();
+
+            RenderDrawData(*ctx.backend, GetDrawData(list), ctx.displayWidth, ctx.displayHeight);
 
             // Clear buffers for next frame
-            g_VertexBuffer.clear();
-            g_CommandBuffer.clear();
+            ResetFrame(ctx);
+        }
+
+        const FrameStats& GetFrameStats() {
+            return GetCurrentContext().frameStats;
         }
+
     }
 }
\ No newline at end of file
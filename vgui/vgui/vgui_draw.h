@@ -1,10 +1,158 @@
 #pragma once
+#include "vgui_config.h"
+#include "vgui_upload.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace VGUI {
+    namespace Jobs {
+        class JobSystem;
+    }
+
     namespace Draw {
-        // Global settings
+#ifdef VGUI_VERTEX_FLOAT_COLOR
+        struct VertexColor {
+            float r, g, b, a;
+        };
+#else
+        // R8G8B8A8_UNORM, red in the lowest byte
+        typedef unsigned int VertexColor;
+#endif
+
+        struct Vertex {
+            float x, y;
+            VertexColor col;
+        };
+
+        // Counters of the last Render()
+        struct FrameStats {
+            size_t commandsRecorded;    // draw commands before batching
+            size_t drawCalls;           // draw calls issued after batching
+            size_t vertices;
+            size_t indices;
+            size_t instances;
+            size_t fringeVertices;      // transparent edge vertices added by anti-aliasing
+            size_t arcTableHits;        // circles and rounded rects tessellated from compile-time tables
+            size_t arcTableMisses;      // ... and from tables generated at runtime (Curves::UnitCircle)
+            size_t polygonCacheHits;    // concave DrawFilledPolygon outlines reusing cached triangles
+            size_t polygonCacheMisses;  // ... and ones ear-clipped this frame
+            size_t scratchBytes;        // high-water mark of the context's scratch arena this frame
+            size_t scratchCapacity;     // ... and its size; steady when no Draw* call allocates
+            uint64_t skippedFrames;     // frames dropped with DiscardFrame since startup
+        };
+
+        // Counts a context that records frames for another one hands over with the list, see EndRecordedFrame
+        struct RecordedFrameStats {
+            size_t polygonCacheHits;
+            size_t polygonCacheMisses;
+        };
+
+        // Clamps to [0, 1] and converts to the vertex color format
+        VertexColor MakeVertexColor(float r, float g, float b, float a);
+        // Bulk RGBA float -> packed RGBA8 conversion (SSE2 when available).
+        // rgba holds count * 4 floats, out receives count packed colors.
+        void PackColors(const float* rgba, unsigned int* out, size_t count);
+
+        // Indices are relative to DrawCommand::vertexStart, so 16 bits are enough:
+        // a new index window starts whenever one would overflow
+        typedef unsigned short DrawIndex;
+        // Ends every strip (TriangleStrip / LineStrip), so strip commands concatenate like lists;
+        // backends enable primitive restart on it. It is never a vertex, hence 65535 per window.
+        const DrawIndex StripRestartIndex = 0xFFFF;
+        const size_t MaxVerticesPerWindow = 65535;
+
+        // One rect, rounded rect, circle or ring, rendered as an instanced quad whose pixel shader
+        // evaluates a rounded-box signed distance field. A circle is a square with radius = w / 2,
+        // a ring / outline is any shape with borderWidth > 0.
+        struct ShapeInstance {
+            float x, y, w, h;       // bounds in pixels
+            float radius;           // corner radius, clamped to half the smaller side
+            float borderWidth;      // 0 = filled, otherwise stroke width inside the bounds
+            float feather;          // anti-aliasing width in pixels, 0 = hard edge
+            VertexColor col;
+        };
+
+        enum class DrawCommandType {
+            Lines,
+            Triangles,
+            TriangleStrip,
+            LineStrip,
+            Shapes      // indexStart / indexCount address DrawData::instances
+        };
+
+        struct DrawCommand {
+            DrawCommandType type;
+            size_t vertexStart;     // base vertex the indices are relative to
+            size_t vertexCount;     // vertices reachable from vertexStart
+            size_t indexStart;
+            size_t indexCount;
+            bool antiAlias;         // geometry carries an alpha fringe (or the shapes a feather)
+        };
+
+        // Read-only view of the geometry recorded since the last Render()
+        struct DrawData {
+            const Vertex* vertices;
+            size_t vertexCount;
+            const DrawIndex* indices;
+            size_t indexCount;
+            const DrawCommand* commands;
+            size_t commandCount;
+            const ShapeInstance* instances;
+            size_t instanceCount;
+        };
+
+        // Geometry recorded by the Draw* calls. The current frame is a DrawList too; user lists capture
+        // static content once between BeginDrawList/EndDrawList and are replayed with SubmitDrawList.
+        // Colors, global alpha and anti-aliasing are baked in when the list is recorded.
+        struct DrawList {
+            std::vector<Vertex> vertices;
+            std::vector<DrawIndex> indices;
+            std::vector<DrawCommand> commands;
+            std::vector<ShapeInstance> instances;
+            size_t windowBase = 0;          // first vertex of the open 16-bit index window
+            size_t fringeVertices = 0;
+            size_t arcTableHits = 0;
+            size_t arcTableMisses = 0;
+
+            // Incremental content hash, updated as commands are recorded
+            uint64_t hash = 0;
+            size_t hashedVertices = 0;
+            size_t hashedIndices = 0;
+
+            void Clear();
+        };
+
+        // Settings, kept per VGUI::Context (vgui_context.h) like everything below
         void SetGlobalAlpha(float alpha);
+        // Anti-aliased strokes and fills get a 1px alpha fringe extruded on the CPU (no MSAA needed)
         void EnableAntiAliasing(bool enable);
+        // Output size in pixels, part of the frame hash (kept in sync by Core::SetWindowSize)
+        void SetDisplaySize(int width, int height);
+        // Route rects, rounded rects and circles through the instanced SDF renderer (default on)
+        void EnableShapeInstancing(bool enable);
+        // Largest distance in pixels between a curve and its segments, for DrawRoundedRect and for
+        // circles and Bezier curves drawn with AutoSegments (default 0.25). Lower is smoother and costs
+        // more vertices; values below MinCurveTolerance are raised to it.
+        void SetCurveTolerance(float maxPixelError);
+        const float MinCurveTolerance = 0.01f;
+        // How strokes thicker than 1px turn corners and end (default Miter with limit 4, Butt). Miters
+        // longer than miterLimit times the stroke width become bevels.
+        enum class LineJoin {
+            Miter,
+            Bevel,
+            Round
+        };
+        enum class LineCap {
+            Butt,
+            Square,
+            Round
+        };
+        void SetLineJoin(LineJoin join, float miterLimit = 4.0f);
+        void SetLineCap(LineCap cap);
+        // Job system that tessellates large batches (DrawFilledCircles...) in parallel; nullptr,
+        // the default, keeps everything on the recording thread. The caller owns it.
+        void SetJobSystem(Jobs::JobSystem* jobs);
 
         // Basic shapes
         void DrawLine(float x1, float y1, float x2, float y2, float r, float g, float b, float a = 1.0f);
@@ -17,6 +165,9 @@ namespace VGUI {
         void DrawRoundedRect(float x, float y, float w, float h, float radius, float r, float g, float b, float a = 1.0f);
         void DrawFilledRoundedRect(float x, float y, float w, float h, float radius, float r, float g, float b, float a = 1.0f);
 
+        // segments <= 0 (AutoSegments) picks the count from the radius so the shape stays within the
+        // curve tolerance; curves are flattened adaptively, with few segments where they are straight
+        const int AutoSegments = 0;
         void DrawCircle(float cx, float cy, float radius, int segments, float r, float g, float b, float a = 1.0f);
         void DrawFilledCircle(float cx, float cy, float radius, int segments, float r, float g, float b, float a = 1.0f);
 
@@ -31,11 +182,69 @@ namespace VGUI {
 
         void DrawPolygon(const float* points, int pointCount, float r, float g, float b, float a = 1.0f);
         void DrawFilledPolygon(const float* points, int pointCount, float r, float g, float b, float a = 1.0f);
+        // Stroke through the points as one triangle strip, with the current joins and caps; closed
+        // joins the last point back to the first
+        void DrawPolyline(const float* points, int pointCount, bool closed, float thickness,
+            float r, float g, float b, float a = 1.0f);
 
         void DrawBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4,
             int segments, float r, float g, float b, float a = 1.0f);
+        void DrawQuadraticBezierCurve(float x1, float y1, float x2, float y2, float x3, float y3,
+            int segments, float r, float g, float b, float a = 1.0f);
+        // Smooth curve through every point (x, y interleaved); segments is per span between two points
+        void DrawCatmullRomSpline(const float* points, int pointCount, bool closed, int segments,
+            float r, float g, float b, float a = 1.0f);
+
+        // Batches: the same output as drawing every shape on its own, in order, but tessellated in
+        // parallel when a job system is set and the batch is large
+        struct CircleDesc {
+            float cx, cy, radius;
+            int segments;
+            float r, g, b, a;
+        };
+
+        struct BezierDesc {
+            float x1, y1, x2, y2, x3, y3, x4, y4;
+            int segments;
+            float r, g, b, a;
+        };
 
-        // Rendering
+        void DrawFilledCircles(const CircleDesc* circles, size_t count);
+        void DrawBezierCurves(const BezierDesc* curves, size_t count);
+
+        // CPU reference of the shape pixel shader: coverage (0..1) of the pixel centered at (px, py)
+        float EvaluateShapeCoverage(const ShapeInstance& shape, float px, float py);
+
+        // Retained draw lists: Draw* calls between Begin/End record into 'list' instead of the frame
+        void BeginDrawList(DrawList& list);
+        void EndDrawList();
+        // Appends a recorded list to the frame (or to the list being recorded), translated by the offset
+        void SubmitDrawList(const DrawList& list, float offsetX = 0.0f, float offsetY = 0.0f);
+        // EndDrawList() for a context that records whole frames another context renders (FramePipeline,
+        // ThreadRecorder): also ends the frame for its caches, as Render() does, and returns the counts
+        // that belong in the rendering context's FrameStats
+        RecordedFrameStats EndRecordedFrame();
+
+        // Rendering. Render(), FrameChanged() and GetFrameHash() first append the lists other
+        // threads published to the context (ThreadRecorder in vgui_context.h).
+        DrawData GetDrawData();
+        DrawData GetDrawData(const DrawList& list);
         void Render();
+
+        const FrameStats& GetFrameStats();
+
+        // Frame change detection. Call after recording and before Render(): when the frame hashes the
+        // same as the last rendered one, DiscardFrame() drops it and the host can skip Present.
+        bool FrameChanged();
+        void DiscardFrame();
+        uint64_t GetFrameHash();
+
+        // Upload statistics of the active backend's vertex, index and shape instance rings (all zero
+        // when the backend does not stream through rings, e.g. the null backend)
+        const Upload::RingStats& GetVertexRingStats();
+        const Upload::RingStats& GetIndexRingStats();
+        const Upload::RingStats& GetInstanceRingStats();
+        // Releases the device buffers of the active backend; they are recreated by the next frame
+        void ReleaseResources();
     }
 }
\ No newline at end of file
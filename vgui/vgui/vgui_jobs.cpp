@@ -0,0 +1,137 @@
+#include "vgui_jobs.h"
+
+namespace VGUI {
+    namespace Jobs {
+        JobSystem::JobSystem(unsigned threadCount)
+            : m_Function(nullptr), m_Fn(nullptr), m_Grain(1), m_Remaining(0),
+            m_Generation(0), m_Busy(0), m_Quit(false), m_ParallelFors(0), m_Ranges(0), m_Steals(0) {
+            if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+            if (threadCount == 0) threadCount = 1;
+            m_Queues.reset(new Queue[threadCount]);
+            for (unsigned i = 1; i < threadCount; i++)
+                m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+        }
+
+        JobSystem::~JobSystem() {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Quit = true;
+            }
+            m_WakeWorkers.notify_all();
+            for (auto& worker : m_Workers) worker.join();
+        }
+
+        JobStats JobSystem::GetStats() const {
+            JobStats stats;
+            stats.parallelFors = m_ParallelFors.load(std::memory_order_relaxed);
+            stats.ranges = m_Ranges.load(std::memory_order_relaxed);
+            stats.steals = m_Steals.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void JobSystem::Run(size_t count, size_t grain, RangeFunction function, const void* fn) {
+            if (count == 0) return;
+            if (grain == 0) grain = 1;
+            if (m_Workers.empty() || count <= grain) {
+                function(fn, 0, count);
+                return;
+            }
+
+            std::lock_guard<std::mutex> run(m_RunMutex);
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Function = function;
+                m_Fn = fn;
+                m_Grain = grain;
+                m_Remaining.store(count, std::memory_order_relaxed);
+                m_Busy = static_cast<unsigned>(m_Workers.size());
+                m_Generation++;
+            }
+            m_ParallelFors.fetch_add(1, std::memory_order_relaxed);
+            Push(0, { 0, count });
+            m_WakeWorkers.notify_all();
+
+            Work(0);
+
+            // Workers may still be returning from their last range; fn must outlive them
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkersDone.wait(lock, [this] { return m_Busy == 0; });
+        }
+
+        // Runs ranges until every item of the loop is done, not just until the queues look empty:
+        // a thief may be splitting a range it just took
+        void JobSystem::Work(unsigned self) {
+            Range range;
+            while (m_Remaining.load(std::memory_order_acquire) != 0) {
+                if (Pop(self, range) || Steal(self, range))
+                    Execute(self, range);
+                else
+                    std::this_thread::yield();
+            }
+        }
+
+        void JobSystem::Execute(unsigned self, Range range) {
+            while (range.end - range.begin > m_Grain) {
+                size_t mid = range.begin + (range.end - range.begin) / 2;
+                Push(self, { mid, range.end });
+                range.end = mid;
+            }
+            m_Function(m_Fn, range.begin, range.end);
+            m_Ranges.fetch_add(1, std::memory_order_relaxed);
+            m_Remaining.fetch_sub(range.end - range.begin, std::memory_order_acq_rel);
+        }
+
+        void JobSystem::Push(unsigned self, Range range) {
+            Queue& queue = m_Queues[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.ranges.push_back(range);
+        }
+
+        bool JobSystem::Pop(unsigned self, Range& range) {
+            Queue& queue = m_Queues[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.front == queue.ranges.size()) return false;
+            range = queue.ranges.back();
+            queue.ranges.pop_back();
+            if (queue.front == queue.ranges.size()) {
+                queue.ranges.clear();
+                queue.front = 0;
+            }
+            return true;
+        }
+
+        bool JobSystem::Steal(unsigned self, Range& range) {
+            const unsigned threadCount = GetThreadCount();
+            for (unsigned i = 1; i < threadCount; i++) {
+                Queue& queue = m_Queues[(self + i) % threadCount];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.front == queue.ranges.size()) continue;
+                range = queue.ranges[queue.front++];
+                if (queue.front == queue.ranges.size()) {
+                    queue.ranges.clear();
+                    queue.front = 0;
+                }
+                m_Steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        void JobSystem::WorkerLoop(unsigned self) {
+            uint64_t seen = 0;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(m_Mutex);
+                    m_WakeWorkers.wait(lock, [&] { return m_Quit || m_Generation != seen; });
+                    if (m_Quit) return;
+                    seen = m_Generation;
+                }
+
+                Work(self);
+
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (--m_Busy == 0) m_WorkersDone.notify_one();
+            }
+        }
+    }
+}
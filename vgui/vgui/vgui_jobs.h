@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VGUI {
+    namespace Jobs {
+        // Totals since the job system was created
+        struct JobStats {
+            uint64_t parallelFors;      // ParallelFor() calls that went wide
+            uint64_t ranges;            // ranges executed, after splitting
+            uint64_t steals;            // ranges taken from another thread's queue
+        };
+
+        // Work-stealing thread pool for data-parallel loops. ParallelFor() puts the whole range on
+        // the calling thread's queue; a thread that runs a range larger than the grain splits it in
+        // half, queues the upper half and continues with the lower one. Owners take from the back
+        // of their queue (the small, cache-warm pieces), idle threads steal from the front of
+        // another queue (the big pieces), so the load balances itself without a central counter.
+        class JobSystem {
+        public:
+            // threadCount = 0 uses every hardware thread. The calling thread is one of them.
+            explicit JobSystem(unsigned threadCount = 0);
+            ~JobSystem();
+            JobSystem(const JobSystem&) = delete;
+            JobSystem& operator=(const JobSystem&) = delete;
+
+            // Calls fn(begin, end) on disjoint ranges covering [0, count), none larger than grain,
+            // and returns once all of them ran. Calls from several threads are serialized.
+            template <typename Function>
+            void ParallelFor(size_t count, size_t grain, const Function& fn) {
+                Run(count, grain, &Invoke<Function>, &fn);
+            }
+
+            unsigned GetThreadCount() const { return static_cast<unsigned>(m_Workers.size()) + 1; }
+            JobStats GetStats() const;
+
+        private:
+            typedef void (*RangeFunction)(const void* fn, size_t begin, size_t end);
+
+            struct Range {
+                size_t begin, end;
+            };
+
+            // One per thread, index 0 belongs to the thread calling ParallelFor()
+            struct Queue {
+                std::mutex mutex;
+                std::vector<Range> ranges;  // front is stolen, back is popped by the owner
+                size_t front = 0;
+            };
+
+            template <typename Function>
+            static void Invoke(const void* fn, size_t begin, size_t end) {
+                (*static_cast<const Function*>(fn))(begin, end);
+            }
+
+            void Run(size_t count, size_t grain, RangeFunction function, const void* fn);
+            void Work(unsigned self);
+            void Execute(unsigned self, Range range);
+            void Push(unsigned self, Range range);
+            bool Pop(unsigned self, Range& range);
+            bool Steal(unsigned self, Range& range);
+            void WorkerLoop(unsigned self);
+
+            std::unique_ptr<Queue[]> m_Queues;
+            std::mutex m_RunMutex;
+
+            // Current loop, published to the workers under m_Mutex with the generation
+            RangeFunction m_Function;
+            const void* m_Fn;
+            size_t m_Grain;
+            std::atomic<size_t> m_Remaining;
+
+            // Persistent workers, woken once per ParallelFor()
+            std::vector<std::thread> m_Workers;
+            std::mutex m_Mutex;
+            std::condition_variable m_WakeWorkers;
+            std::condition_variable m_WorkersDone;
+            uint64_t m_Generation;
+            unsigned m_Busy;
+            bool m_Quit;
+
+            std::atomic<uint64_t> m_ParallelFors;
+            std::atomic<uint64_t> m_Ranges;
+            std::atomic<uint64_t> m_Steals;
+        };
+    }
+}
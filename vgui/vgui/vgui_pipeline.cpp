@@ -0,0 +1,112 @@
+#include "vgui_pipeline.h"
+#include <utility>
+
+namespace VGUI {
+    FramePipeline::FramePipeline(Context& target) : m_Target(target) {
+    }
+
+    uint64_t FramePipeline::Nanoseconds(Clock::time_point start, Clock::time_point end) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    // Taking the mutex orders the index store before a waiter's predicate check, so a thread that
+    // is about to sleep cannot miss the notification
+    void FramePipeline::Wake(std::condition_variable& cv) {
+        { std::lock_guard<std::mutex> lock(m_Mutex); }
+        cv.notify_one();
+    }
+
+    bool FramePipeline::BeginFrame() {
+        Clock::time_point start = Clock::now();
+        const uint64_t written = m_Written.load(std::memory_order_relaxed);
+
+        // The slot is free once the frame recorded SlotCount frames ago has been released
+        if (written - m_Released.load(std::memory_order_acquire) >= SlotCount) {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_SlotFreed.wait(lock, [&] {
+                return m_Stopped.load(std::memory_order_relaxed) ||
+                    written - m_Released.load(std::memory_order_acquire) < SlotCount;
+            });
+        }
+        if (m_Stopped.load(std::memory_order_relaxed)) return false;
+
+        m_RecordStart = Clock::now();
+        m_RecordWaitNs.fetch_add(Nanoseconds(start, m_RecordStart), std::memory_order_relaxed);
+        m_Previous = &GetCurrentContext();
+        SetCurrentContext(&m_Recorder);
+        Draw::BeginDrawList(m_Slots[written % SlotCount].list);
+        return true;
+    }
+
+    void FramePipeline::EndFrame(int displayWidth, int displayHeight) {
+        const uint64_t written = m_Written.load(std::memory_order_relaxed);
+        Slot& slot = m_Slots[written % SlotCount];
+        slot.stats = Draw::EndRecordedFrame();
+        SetCurrentContext(m_Previous);
+
+        slot.displayWidth = displayWidth;
+        slot.displayHeight = displayHeight;
+        slot.recorded = Clock::now();
+        m_RecordNs.fetch_add(Nanoseconds(m_RecordStart, slot.recorded), std::memory_order_relaxed);
+
+        m_Written.store(written + 1, std::memory_order_release);
+        Wake(m_FrameWritten);
+    }
+
+    bool FramePipeline::AcquireFrame() {
+        Clock::time_point start = Clock::now();
+        if (m_Acquired == m_Written.load(std::memory_order_acquire)) {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_FrameWritten.wait(lock, [&] {
+                return m_Stopped.load(std::memory_order_relaxed) ||
+                    m_Acquired != m_Written.load(std::memory_order_acquire);
+            });
+        }
+        if (m_Stopped.load(std::memory_order_relaxed)) return false;
+
+        m_RenderStart = Clock::now();
+        m_RenderWaitNs.fetch_add(Nanoseconds(start, m_RenderStart), std::memory_order_relaxed);
+
+        // The target's frame was cleared by the last Render(), so the slot gets empty buffers with
+        // their capacity and the target gets the recorded frame, without copying either
+        Slot& slot = m_Slots[m_Acquired % SlotCount];
+        std::swap(m_Target.frameList, slot.list);
+        m_Target.displayWidth = slot.displayWidth;
+        m_Target.displayHeight = slot.displayHeight;
+        m_Target.polygonCacheHits += slot.stats.polygonCacheHits;
+        m_Target.polygonCacheMisses += slot.stats.polygonCacheMisses;
+        m_RenderRecorded = slot.recorded;
+        m_Acquired++;
+        return true;
+    }
+
+    void FramePipeline::ReleaseFrame() {
+        Clock::time_point end = Clock::now();
+        m_RenderNs.fetch_add(Nanoseconds(m_RenderStart, end), std::memory_order_relaxed);
+        m_LatencyNs.fetch_add(Nanoseconds(m_RenderRecorded, end), std::memory_order_relaxed);
+
+        m_Released.store(m_Acquired, std::memory_order_release);
+        Wake(m_SlotFreed);
+    }
+
+    void FramePipeline::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopped.store(true, std::memory_order_relaxed);
+        }
+        m_SlotFreed.notify_all();
+        m_FrameWritten.notify_all();
+    }
+
+    FramePipelineStats FramePipeline::GetStats() const {
+        FramePipelineStats stats;
+        stats.framesRecorded = m_Written.load(std::memory_order_relaxed);
+        stats.framesRendered = m_Released.load(std::memory_order_relaxed);
+        stats.recordMilliseconds = m_RecordNs.load(std::memory_order_relaxed) * 1e-6;
+        stats.recordWaitMilliseconds = m_RecordWaitNs.load(std::memory_order_relaxed) * 1e-6;
+        stats.renderMilliseconds = m_RenderNs.load(std::memory_order_relaxed) * 1e-6;
+        stats.renderWaitMilliseconds = m_RenderWaitNs.load(std::memory_order_relaxed) * 1e-6;
+        stats.latencyMilliseconds = m_LatencyNs.load(std::memory_order_relaxed) * 1e-6;
+        return stats;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "vgui_context.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace VGUI {
+    // Totals since the pipeline was created; the difference between two reads gives averages and
+    // frames per second for that interval
+    struct FramePipelineStats {
+        uint64_t framesRecorded;
+        uint64_t framesRendered;
+        double recordMilliseconds;      // BeginFrame() to EndFrame(), waiting excluded
+        double recordWaitMilliseconds;  // BeginFrame() blocked until the render thread freed a slot
+        double renderMilliseconds;      // AcquireFrame() to ReleaseFrame(): upload, draw and present
+        double renderWaitMilliseconds;  // AcquireFrame() blocked until a frame was recorded
+        double latencyMilliseconds;     // EndFrame() to ReleaseFrame(): recorded until presented
+    };
+
+    // Lets the application record frame N + 1 while a render thread uploads and presents frame N.
+    // Frames are recorded into two slots, each with its own DrawList. The slots are handed over
+    // through a single-producer single-consumer ring: publishing and taking a frame are a store and
+    // a load of an index, and a thread only sleeps when the other one is a whole frame behind.
+    //
+    // Recording thread:  BeginFrame(), Draw* calls, EndFrame(width, height)
+    // Render thread:     with target current: AcquireFrame(), Render(), Present, ReleaseFrame()
+    //
+    // AcquireFrame() swaps the slot's buffers into the target's frame, so vertices are never copied
+    // between the threads. Draw on the render thread only between AcquireFrame() and Render().
+    class FramePipeline {
+    public:
+        static const uint32_t SlotCount = 2;
+
+        explicit FramePipeline(Context& target);
+        FramePipeline(const FramePipeline&) = delete;
+        FramePipeline& operator=(const FramePipeline&) = delete;
+
+        // Waits for a free slot and makes the recording context current; false once stopped
+        bool BeginFrame();
+        // Hands the frame and the display size it was recorded for to the render thread
+        void EndFrame(int displayWidth, int displayHeight);
+        // Settings (global alpha, anti-aliasing...) used while recording
+        Context& GetRecordContext() { return m_Recorder; }
+
+        // Waits for the oldest recorded frame and moves it into the target; false once stopped
+        bool AcquireFrame();
+        // Frees the acquired frame's slot for recording
+        void ReleaseFrame();
+
+        // Wakes both threads; BeginFrame() and AcquireFrame() return false from then on
+        void Stop();
+        FramePipelineStats GetStats() const;
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Slot {
+            Draw::DrawList list;
+            int displayWidth = 0;
+            int displayHeight = 0;
+            Draw::RecordedFrameStats stats = {};
+            Clock::time_point recorded;
+        };
+
+        static uint64_t Nanoseconds(Clock::time_point start, Clock::time_point end);
+        void Wake(std::condition_variable& cv);
+
+        Context& m_Target;
+        Context m_Recorder;
+        Slot m_Slots[SlotCount];
+
+        // Frames published by EndFrame() and freed by ReleaseFrame(); each written by one thread
+        std::atomic<uint64_t> m_Written{ 0 };
+        std::atomic<uint64_t> m_Released{ 0 };
+        std::atomic<bool> m_Stopped{ false };
+        uint64_t m_Acquired = 0;            // render thread only
+
+        // Only for sleeping; the handoff itself is the indices above
+        std::mutex m_Mutex;
+        std::condition_variable m_SlotFreed;
+        std::condition_variable m_FrameWritten;
+
+        Context* m_Previous = nullptr;      // recording thread only
+        Clock::time_point m_RecordStart;
+        Clock::time_point m_RenderStart;    // render thread only
+        Clock::time_point m_RenderRecorded;
+
+        std::atomic<uint64_t> m_RecordNs{ 0 };
+        std::atomic<uint64_t> m_RecordWaitNs{ 0 };
+        std::atomic<uint64_t> m_RenderNs{ 0 };
+        std::atomic<uint64_t> m_RenderWaitNs{ 0 };
+        std::atomic<uint64_t> m_LatencyNs{ 0 };
+    };
+}
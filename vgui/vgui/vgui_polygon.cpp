@@ -0,0 +1,451 @@
+#include "vgui_polygon.h"
+#include <algorithm>
+
+namespace VGUI {
+    namespace Polygon {
+        // -1, 0 or 1
+        static int Sign(float v) {
+            return (v > 0.0f) - (v < 0.0f);
+        }
+
+        bool IsConvex(const float* points, int pointCount) {
+            if (pointCount < 4) return true;
+
+            // Last non-degenerate edge, into point 0, and the last nonzero sign of each axis
+            float prevDx = 0.0f, prevDy = 0.0f;
+            int xSign = 0, ySign = 0;
+            for (int i = pointCount - 1, j = 0; i >= 0 && (xSign == 0 || ySign == 0); j = i--) {
+                float dx = points[j * 2] - points[i * 2];
+                float dy = points[j * 2 + 1] - points[i * 2 + 1];
+                if (prevDx == 0.0f && prevDy == 0.0f) {
+                    prevDx = dx;
+                    prevDy = dy;
+                }
+                if (xSign == 0) xSign = Sign(dx);
+                if (ySign == 0) ySign = Sign(dy);
+            }
+            if (prevDx == 0.0f && prevDy == 0.0f) return true;
+
+            // A convex outline turns one way only and its edges sweep each axis direction once,
+            // i.e. dx and dy change sign exactly twice; stars that loop around twice fail the latter.
+            // Float rounding may call a nearly straight corner concave; it is then ear-clipped instead.
+            int turn = 0, xFlips = 0, yFlips = 0;
+            for (int i = 0; i < pointCount; i++) {
+                const float* p = points + i * 2;
+                const float* q = (i + 1 < pointCount) ? p + 2 : points;
+                float dx = q[0] - p[0];
+                float dy = q[1] - p[1];
+                if (dx == 0.0f && dy == 0.0f) continue;
+
+                int cross = Sign(prevDx * dy - prevDy * dx);
+                if (cross == 0) {
+                    if (prevDx * dx + prevDy * dy < 0.0f) return false; // doubles back
+                }
+                else if (turn == 0) turn = cross;
+                else if (cross != turn) return false;
+
+                int sx = Sign(dx), sy = Sign(dy);
+                if (sx != 0) {
+                    if (sx != xSign && ++xFlips > 2) return false;
+                    xSign = sx;
+                }
+                if (sy != 0) {
+                    if (sy != ySign && ++yFlips > 2) return false;
+                    ySign = sy;
+                }
+                prevDx = dx;
+                prevDy = dy;
+            }
+            return true;
+        }
+
+        // Twice the signed area of triangle p, q, r; negative for an ear of the list's winding
+        double Triangulator::Area(int p, int q, int r) const {
+            const Node& a = m_Nodes[p];
+            const Node& b = m_Nodes[q];
+            const Node& c = m_Nodes[r];
+            return (b.y - a.y) * (c.x - b.x) - (b.x - a.x) * (c.y - b.y);
+        }
+
+        bool Triangulator::Equals(int a, int b) const {
+            return m_Nodes[a].x == m_Nodes[b].x && m_Nodes[a].y == m_Nodes[b].y;
+        }
+
+        static bool PointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py) {
+            return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+                (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+                (bx - px) * (cy - py) >= (cx - px) * (by - py);
+        }
+
+        // Interleaves the bits of the 15-bit grid coordinates
+        uint32_t Triangulator::ZOrder(double x, double y) const {
+            uint32_t ix = static_cast<uint32_t>((x - m_MinX) * m_InvSize);
+            uint32_t iy = static_cast<uint32_t>((y - m_MinY) * m_InvSize);
+            ix = (ix | (ix << 8)) & 0x00FF00FFu;
+            ix = (ix | (ix << 4)) & 0x0F0F0F0Fu;
+            ix = (ix | (ix << 2)) & 0x33333333u;
+            ix = (ix | (ix << 1)) & 0x55555555u;
+            iy = (iy | (iy << 8)) & 0x00FF00FFu;
+            iy = (iy | (iy << 4)) & 0x0F0F0F0Fu;
+            iy = (iy | (iy << 2)) & 0x33333333u;
+            iy = (iy | (iy << 1)) & 0x55555555u;
+            return ix | (iy << 1);
+        }
+
+        int Triangulator::Insert(uint32_t i, double x, double y, int last) {
+            int p = static_cast<int>(m_Nodes.size());
+            m_Nodes.push_back({ i, x, y, p, p, -1, -1, 0 });
+            if (last >= 0) {
+                Node& node = m_Nodes[p];
+                node.next = m_Nodes[last].next;
+                node.prev = last;
+                m_Nodes[m_Nodes[last].next].prev = p;
+                m_Nodes[last].next = p;
+            }
+            return p;
+        }
+
+        void Triangulator::Remove(int p) {
+            const Node& node = m_Nodes[p];
+            m_Nodes[node.next].prev = node.prev;
+            m_Nodes[node.prev].next = node.next;
+            if (node.prevZ >= 0) m_Nodes[node.prevZ].nextZ = node.nextZ;
+            if (node.nextZ >= 0) m_Nodes[node.nextZ].prevZ = node.prevZ;
+        }
+
+        // Drops repeated and collinear points between start and end (the whole list when end < 0)
+        int Triangulator::FilterPoints(int start, int end) {
+            if (end < 0) end = start;
+            int p = start;
+            bool again;
+            do {
+                again = false;
+                if (Equals(p, m_Nodes[p].next) || Area(m_Nodes[p].prev, p, m_Nodes[p].next) == 0.0) {
+                    Remove(p);
+                    p = end = m_Nodes[p].prev;
+                    if (p == m_Nodes[p].next) break;
+                    again = true;
+                }
+                else {
+                    p = m_Nodes[p].next;
+                }
+            } while (again || p != end);
+            return end;
+        }
+
+        // Links the list in z-order; a sort of the node indices replaces earcut's linked merge sort
+        void Triangulator::IndexCurve(int start) {
+            m_ZScratch.clear();
+            int p = start;
+            do {
+                Node& node = m_Nodes[p];
+                node.z = ZOrder(node.x, node.y);
+                m_ZScratch.push_back(p);
+                p = node.next;
+            } while (p != start);
+
+            std::sort(m_ZScratch.begin(), m_ZScratch.end(), [this](int a, int b) { return m_Nodes[a].z < m_Nodes[b].z; });
+            for (size_t k = 0; k < m_ZScratch.size(); k++) {
+                Node& node = m_Nodes[m_ZScratch[k]];
+                node.prevZ = (k > 0) ? m_ZScratch[k - 1] : -1;
+                node.nextZ = (k + 1 < m_ZScratch.size()) ? m_ZScratch[k + 1] : -1;
+            }
+        }
+
+        // No point of the outline inside the triangle; only reflex points can be, so the others are skipped
+        bool Triangulator::IsEar(int ear) const {
+            const Node& a = m_Nodes[m_Nodes[ear].prev];
+            const Node& b = m_Nodes[ear];
+            const Node& c = m_Nodes[b.next];
+            if (Area(b.prev, ear, b.next) >= 0.0) return false;
+
+            double x0 = std::min(a.x, std::min(b.x, c.x)), x1 = std::max(a.x, std::max(b.x, c.x));
+            double y0 = std::min(a.y, std::min(b.y, c.y)), y1 = std::max(a.y, std::max(b.y, c.y));
+            for (int p = c.next; p != b.prev; p = m_Nodes[p].next) {
+                const Node& n = m_Nodes[p];
+                if (n.x >= x0 && n.x <= x1 && n.y >= y0 && n.y <= y1 && !(n.x == a.x && n.y == a.y) &&
+                    PointInTriangle(a.x, a.y, b.x, b.y, c.x, c.y, n.x, n.y) && Area(n.prev, p, n.next) >= 0.0)
+                    return false;
+            }
+            return true;
+        }
+
+        // Same test, visiting only the points whose z-order falls within the triangle's bounds
+        bool Triangulator::IsEarHashed(int ear) const {
+            const int ia = m_Nodes[ear].prev, ic = m_Nodes[ear].next;
+            const Node& a = m_Nodes[ia];
+            const Node& b = m_Nodes[ear];
+            const Node& c = m_Nodes[ic];
+            if (Area(ia, ear, ic) >= 0.0) return false;
+
+            double x0 = std::min(a.x, std::min(b.x, c.x)), x1 = std::max(a.x, std::max(b.x, c.x));
+            double y0 = std::min(a.y, std::min(b.y, c.y)), y1 = std::max(a.y, std::max(b.y, c.y));
+            const uint32_t minZ = ZOrder(x0, y0), maxZ = ZOrder(x1, y1);
+
+            auto blocks = [&](int p) {
+                const Node& n = m_Nodes[p];
+                return n.x >= x0 && n.x <= x1 && n.y >= y0 && n.y <= y1 && p != ia && p != ic &&
+                    !(n.x == a.x && n.y == a.y) && PointInTriangle(a.x, a.y, b.x, b.y, c.x, c.y, n.x, n.y) &&
+                    Area(n.prev, p, n.next) >= 0.0;
+            };
+
+            // Walk both directions from the ear at once, then finish whichever side is left
+            int p = b.prevZ, n = b.nextZ;
+            while (p >= 0 && m_Nodes[p].z >= minZ && n >= 0 && m_Nodes[n].z <= maxZ) {
+                if (blocks(p)) return false;
+                p = m_Nodes[p].prevZ;
+                if (blocks(n)) return false;
+                n = m_Nodes[n].nextZ;
+            }
+            for (; p >= 0 && m_Nodes[p].z >= minZ; p = m_Nodes[p].prevZ)
+                if (blocks(p)) return false;
+            for (; n >= 0 && m_Nodes[n].z <= maxZ; n = m_Nodes[n].nextZ)
+                if (blocks(n)) return false;
+            return true;
+        }
+
+        // Pass 0 cuts ears. When a full loop finds none, pass 1 retries without collinear points and
+        // pass 2 after cutting off local self-intersections; after that the outline is split in two.
+        void Triangulator::CutEars(int ear, int pass) {
+            if (ear < 0) return;
+            if (pass == 0 && m_InvSize != 0.0) IndexCurve(ear);
+
+            int stop = ear;
+            while (m_Nodes[ear].prev != m_Nodes[ear].next) {
+                const int prev = m_Nodes[ear].prev, next = m_Nodes[ear].next;
+                if ((m_InvSize != 0.0) ? IsEarHashed(ear) : IsEar(ear)) {
+                    m_Triangles->push_back(m_Nodes[prev].i);
+                    m_Triangles->push_back(m_Nodes[ear].i);
+                    m_Triangles->push_back(m_Nodes[next].i);
+                    Remove(ear);
+                    // Skipping the next vertex gives fewer sliver triangles
+                    ear = stop = m_Nodes[next].next;
+                    continue;
+                }
+
+                ear = next;
+                if (ear == stop) {
+                    if (pass == 0) CutEars(FilterPoints(ear, -1), 1);
+                    else if (pass == 1) CutEars(CureLocalIntersections(FilterPoints(ear, -1)), 2);
+                    else SplitAndCut(ear);
+                    return;
+                }
+            }
+        }
+
+        static bool OnSegment(double px, double py, double qx, double qy, double rx, double ry) {
+            return qx <= std::max(px, rx) && qx >= std::min(px, rx) && qy <= std::max(py, ry) && qy >= std::min(py, ry);
+        }
+
+        // Segments p1-q1 and p2-q2 cross or touch
+        static bool Intersects(double p1x, double p1y, double q1x, double q1y, double p2x, double p2y, double q2x, double q2y) {
+            auto area = [](double ax, double ay, double bx, double by, double cx, double cy) {
+                return Sign((by - ay) * (cx - bx) - (bx - ax) * (cy - by));
+            };
+            int o1 = area(p1x, p1y, q1x, q1y, p2x, p2y);
+            int o2 = area(p1x, p1y, q1x, q1y, q2x, q2y);
+            int o3 = area(p2x, p2y, q2x, q2y, p1x, p1y);
+            int o4 = area(p2x, p2y, q2x, q2y, q1x, q1y);
+            if (o1 != o2 && o3 != o4) return true;
+            if (o1 == 0 && OnSegment(p1x, p1y, p2x, p2y, q1x, q1y)) return true;
+            if (o2 == 0 && OnSegment(p1x, p1y, q2x, q2y, q1x, q1y)) return true;
+            if (o3 == 0 && OnSegment(p2x, p2y, p1x, p1y, q2x, q2y)) return true;
+            if (o4 == 0 && OnSegment(p2x, p2y, q1x, q1y, q2x, q2y)) return true;
+            return false;
+        }
+
+        // Where edge a-p crosses edge p.next-b (a twist in self-intersecting input), cuts off triangle a, p, b
+        int Triangulator::CureLocalIntersections(int start) {
+            int p = start;
+            do {
+                const int a = m_Nodes[p].prev, pn = m_Nodes[p].next, b = m_Nodes[pn].next;
+                const Node& na = m_Nodes[a];
+                const Node& nb = m_Nodes[b];
+                if (!Equals(a, b) && Intersects(na.x, na.y, m_Nodes[p].x, m_Nodes[p].y, m_Nodes[pn].x, m_Nodes[pn].y, nb.x, nb.y) &&
+                    LocallyInside(a, b) && LocallyInside(b, a)) {
+                    m_Triangles->push_back(na.i);
+                    m_Triangles->push_back(m_Nodes[p].i);
+                    m_Triangles->push_back(nb.i);
+                    Remove(p);
+                    Remove(pn);
+                    p = start = b;
+                }
+                p = m_Nodes[p].next;
+            } while (p != start);
+            return FilterPoints(p, -1);
+        }
+
+        void Triangulator::SplitAndCut(int start) {
+            int a = start;
+            do {
+                for (int b = m_Nodes[m_Nodes[a].next].next; b != m_Nodes[a].prev; b = m_Nodes[b].next) {
+                    if (m_Nodes[a].i != m_Nodes[b].i && IsValidDiagonal(a, b)) {
+                        int c = SplitPolygon(a, b);
+                        a = FilterPoints(a, m_Nodes[a].next);
+                        c = FilterPoints(c, m_Nodes[c].next);
+                        CutEars(a, 0);
+                        CutEars(c, 0);
+                        return;
+                    }
+                }
+                a = m_Nodes[a].next;
+            } while (a != start);
+        }
+
+        bool Triangulator::IsValidDiagonal(int a, int b) const {
+            const Node& na = m_Nodes[a];
+            const Node& nb = m_Nodes[b];
+            if (m_Nodes[na.next].i == nb.i || m_Nodes[na.prev].i == nb.i || IntersectsPolygon(a, b)) return false;
+            if (LocallyInside(a, b) && LocallyInside(b, a) && MiddleInside(a, b) &&
+                (Area(na.prev, a, nb.prev) != 0.0 || Area(a, nb.prev, b) != 0.0))
+                return true;
+            // Zero-length diagonal between two touching convex corners
+            return Equals(a, b) && Area(na.prev, a, na.next) > 0.0 && Area(nb.prev, b, nb.next) > 0.0;
+        }
+
+        bool Triangulator::IntersectsPolygon(int a, int b) const {
+            const Node& na = m_Nodes[a];
+            const Node& nb = m_Nodes[b];
+            int p = a;
+            do {
+                const Node& n = m_Nodes[p];
+                const Node& next = m_Nodes[n.next];
+                if (n.i != na.i && next.i != na.i && n.i != nb.i && next.i != nb.i &&
+                    Intersects(n.x, n.y, next.x, next.y, na.x, na.y, nb.x, nb.y))
+                    return true;
+                p = n.next;
+            } while (p != a);
+            return false;
+        }
+
+        // The diagonal a-b leaves a into the inside of the outline
+        bool Triangulator::LocallyInside(int a, int b) const {
+            const Node& na = m_Nodes[a];
+            return Area(na.prev, a, na.next) < 0.0 ?
+                Area(a, b, na.next) >= 0.0 && Area(a, na.prev, b) >= 0.0 :
+                Area(a, b, na.prev) < 0.0 || Area(a, na.next, b) < 0.0;
+        }
+
+        // The midpoint of a-b is inside the outline (even-odd ray cast)
+        bool Triangulator::MiddleInside(int a, int b) const {
+            const double px = (m_Nodes[a].x + m_Nodes[b].x) * 0.5, py = (m_Nodes[a].y + m_Nodes[b].y) * 0.5;
+            bool inside = false;
+            int p = a;
+            do {
+                const Node& n = m_Nodes[p];
+                const Node& next = m_Nodes[n.next];
+                if (((n.y > py) != (next.y > py)) && next.y != n.y &&
+                    (px < (next.x - n.x) * (py - n.y) / (next.y - n.y) + n.x))
+                    inside = !inside;
+                p = n.next;
+            } while (p != a);
+            return inside;
+        }
+
+        // Splits the list along a-b into two outlines that share the diagonal; returns b's copy,
+        // a node of the second outline
+        int Triangulator::SplitPolygon(int a, int b) {
+            const int a2 = static_cast<int>(m_Nodes.size());
+            const int b2 = a2 + 1;
+            m_Nodes.push_back({ m_Nodes[a].i, m_Nodes[a].x, m_Nodes[a].y, -1, -1, -1, -1, 0 });
+            m_Nodes.push_back({ m_Nodes[b].i, m_Nodes[b].x, m_Nodes[b].y, -1, -1, -1, -1, 0 });
+            const int an = m_Nodes[a].next, bp = m_Nodes[b].prev;
+
+            m_Nodes[a].next = b;
+            m_Nodes[b].prev = a;
+            m_Nodes[a2].next = an;
+            m_Nodes[an].prev = a2;
+            m_Nodes[b2].next = a2;
+            m_Nodes[a2].prev = b2;
+            m_Nodes[bp].next = b2;
+            m_Nodes[b2].prev = bp;
+            return b2;
+        }
+
+        Triangulator::Triangulator(Memory::FrameArena& arena) : m_Nodes(arena), m_ZScratch(arena) {
+        }
+
+        int Triangulator::Triangulate(const float* points, int pointCount, Memory::ArenaVector<uint32_t>& triangles) {
+            const size_t first = triangles.size();
+            if (pointCount < 3) return 0;
+
+            m_Nodes.clear();
+            m_Nodes.reserve(static_cast<size_t>(pointCount) * 2);
+            triangles.reserve(first + static_cast<size_t>(pointCount - 2) * 3);
+            m_Triangles = &triangles;
+
+            // The list runs so that ears have negative Area() whatever the input winding
+            double area = 0.0;
+            for (int i = 0, j = pointCount - 1; i < pointCount; j = i++)
+                area += (static_cast<double>(points[j * 2]) - points[i * 2]) * (static_cast<double>(points[i * 2 + 1]) + points[j * 2 + 1]);
+            int last = -1;
+            if (area > 0.0) {
+                for (int i = 0; i < pointCount; i++)
+                    last = Insert(static_cast<uint32_t>(i), points[i * 2], points[i * 2 + 1], last);
+            }
+            else {
+                for (int i = pointCount - 1; i >= 0; i--)
+                    last = Insert(static_cast<uint32_t>(i), points[i * 2], points[i * 2 + 1], last);
+            }
+            if (Equals(last, m_Nodes[last].next)) {
+                Remove(last);
+                last = m_Nodes[last].next;
+            }
+
+            // Grid for the z-order curve over the bounding box
+            m_InvSize = 0.0;
+            if (pointCount > HashedPointCount) {
+                double minX = points[0], minY = points[1], maxX = minX, maxY = minY;
+                for (int i = 1; i < pointCount; i++) {
+                    minX = std::min(minX, static_cast<double>(points[i * 2]));
+                    minY = std::min(minY, static_cast<double>(points[i * 2 + 1]));
+                    maxX = std::max(maxX, static_cast<double>(points[i * 2]));
+                    maxY = std::max(maxY, static_cast<double>(points[i * 2 + 1]));
+                }
+                double size = std::max(maxX - minX, maxY - minY);
+                m_MinX = minX;
+                m_MinY = minY;
+                m_InvSize = (size > 0.0) ? 32767.0 / size : 0.0;
+            }
+
+            if (m_Nodes[last].next != m_Nodes[last].prev) CutEars(last, 0);
+            m_Triangles = nullptr;
+            return static_cast<int>((triangles.size() - first) / 3);
+        }
+
+        const std::vector<uint32_t>* TriangulationCache::Find(uint64_t hash, int pointCount) {
+            auto it = m_Entries.find(hash);
+            if (it == m_Entries.end() || it->second.pointCount != pointCount) return nullptr;
+            it->second.lastUsed = m_Frame;
+            return &it->second.triangles;
+        }
+
+        const std::vector<uint32_t>& TriangulationCache::Insert(uint64_t hash, int pointCount, const uint32_t* triangles, size_t indexCount) {
+            Entry& entry = m_Entries[hash];
+            m_IndexCount -= entry.triangles.size();
+            entry.pointCount = pointCount;
+            entry.lastUsed = m_Frame;
+            entry.triangles.assign(triangles, triangles + indexCount);
+            m_IndexCount += entry.triangles.size();
+            return entry.triangles;
+        }
+
+        void TriangulationCache::EndFrame() {
+            m_Frame++;
+            for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+                if (m_Frame - it->second.lastUsed > static_cast<uint64_t>(MaxUnusedFrames)) {
+                    m_IndexCount -= it->second.triangles.size();
+                    it = m_Entries.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        void TriangulationCache::Clear() {
+            m_Entries.clear();
+            m_IndexCount = 0;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "vgui_arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace VGUI {
+    namespace Polygon {
+        // True when the outline (x, y interleaved, either winding) turns the same way at every corner
+        // and goes around once, so a fan from any vertex covers it. Collinear and repeated points are
+        // allowed; self-intersecting stars are not convex.
+        bool IsConvex(const float* points, int pointCount);
+
+        // Ear clipping for concave outlines, after D. Eberly's method as refined by Mapbox earcut. The
+        // outline is a linked list and an ear is cut when no reflex vertex lies inside it. Outlines
+        // above HashedPointCount points sort their vertices on a z-order curve, so that test only
+        // visits nearby vertices. When no ear is left (self-intersecting input), local intersections
+        // are cut off and the rest is split along a valid diagonal, so every outline gets triangles.
+        // Its linked list lives in arena, so a triangulator is made per call, inside an ArenaScope.
+        class Triangulator {
+        public:
+            static const int HashedPointCount = 80;
+
+            explicit Triangulator(Memory::FrameArena& arena);
+
+            // Appends index triples into points to triangles and returns the triangle count:
+            // pointCount - 2 for simple outlines, fewer when points are repeated or collinear
+            int Triangulate(const float* points, int pointCount, Memory::ArenaVector<uint32_t>& triangles);
+
+        private:
+            struct Node {
+                uint32_t i;             // index of the point
+                double x, y;
+                int prev, next;         // outline order
+                int prevZ, nextZ;       // z-order, -1 at the ends
+                uint32_t z;
+            };
+
+            int Insert(uint32_t i, double x, double y, int last);
+            void Remove(int p);
+            int FilterPoints(int start, int end);
+            void IndexCurve(int start);
+            bool IsEar(int ear) const;
+            bool IsEarHashed(int ear) const;
+            void CutEars(int ear, int pass);
+            int CureLocalIntersections(int start);
+            void SplitAndCut(int start);
+            bool IsValidDiagonal(int a, int b) const;
+            bool IntersectsPolygon(int a, int b) const;
+            bool LocallyInside(int a, int b) const;
+            bool MiddleInside(int a, int b) const;
+            int SplitPolygon(int a, int b);
+            double Area(int p, int q, int r) const;
+            bool Equals(int a, int b) const;
+            uint32_t ZOrder(double x, double y) const;
+
+            Memory::ArenaVector<Node> m_Nodes;
+            Memory::ArenaVector<int> m_ZScratch;
+            Memory::ArenaVector<uint32_t>* m_Triangles = nullptr;
+            double m_MinX = 0.0, m_MinY = 0.0, m_InvSize = 0.0;    // z-order grid, m_InvSize 0 = unhashed
+        };
+
+        // Triangulations of outlines drawn before, keyed by a hash of their points relative to the
+        // first one, so static outlines (map regions, icons) are triangulated once even when they
+        // move by whole pixels. Entries not used for MaxUnusedFrames frames are dropped at EndFrame.
+        class TriangulationCache {
+        public:
+            static const int MaxUnusedFrames = 60;
+
+            // Triangles of a cached outline with this hash and point count, or nullptr
+            const std::vector<uint32_t>* Find(uint64_t hash, int pointCount);
+            const std::vector<uint32_t>& Insert(uint64_t hash, int pointCount, const uint32_t* triangles, size_t indexCount);
+            void EndFrame();
+            void Clear();
+
+            size_t GetEntryCount() const { return m_Entries.size(); }
+            size_t GetIndexCount() const { return m_IndexCount; }
+
+        private:
+            struct Entry {
+                int pointCount;
+                uint64_t lastUsed;
+                std::vector<uint32_t> triangles;
+            };
+
+            std::unordered_map<uint64_t, Entry> m_Entries;
+            size_t m_IndexCount = 0;
+            uint64_t m_Frame = 0;
+        };
+    }
+}
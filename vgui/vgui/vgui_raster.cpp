@@ -0,0 +1,629 @@
+#include "vgui_raster.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VGUI_HAS_SSE2 1
+#else
+#define VGUI_HAS_SSE2 0
+#endif
+
+namespace VGUI {
+    namespace Raster {
+        using Draw::Vertex;
+        using Draw::DrawCommand;
+        using Draw::DrawCommandType;
+        using Draw::ShapeInstance;
+
+        // 28.4 fixed point, samples sit at the pixel centers
+        const int SubpixelBits = 4;
+        const int SubpixelScale = 1 << SubpixelBits;
+        const int SampleOffset = SubpixelScale / 2;
+
+        // Primitive ids in the tile bins: the low bits index m_Triangles / m_Shapes
+        const uint32_t ShapeBit = 0x80000000u;
+        const uint32_t FullTileBit = 0x40000000u;
+        const uint32_t IdMask = 0x3FFFFFFFu;
+
+        // Edge values are clamped to this before the 32-bit inner loop. A row segment inside one
+        // tile changes an edge by less than 2^28 (|a| < 2^18 subpixels within the guard band), so
+        // clamping never flips a sign.
+        const int64_t EdgeClamp = 1 << 30;
+
+        // Rows per band in the band rejection test of partially covered tiles
+        const int BandRows = 8;
+
+        typedef std::chrono::steady_clock Clock;
+
+        static double Milliseconds(Clock::time_point start, Clock::time_point end) {
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        // E(sx, sy) = a * sx + b * sy + c in subpixels, >= 0 inside. The top-left bias is folded into c.
+        struct Edge {
+            int64_t a, b, c;
+        };
+
+        static void SetupEdges(const int32_t* x, const int32_t* y, Edge* edges) {
+            for (int i = 0; i < 3; i++) {
+                int j = (i + 1) % 3;
+                Edge& e = edges[i];
+                e.a = static_cast<int64_t>(y[i]) - y[j];
+                e.b = static_cast<int64_t>(x[j]) - x[i];
+                e.c = -(e.a * x[i] + e.b * y[i]);
+                // The inward normal is (a, b): left edges have a > 0, top edges a == 0 and b > 0.
+                // Samples exactly on any other edge belong to the neighbouring triangle.
+                bool topLeft = e.a > 0 || (e.a == 0 && e.b > 0);
+                if (!topLeft) e.c -= 1;
+            }
+        }
+
+        static inline int32_t ClampEdge(int64_t value) {
+            if (value > EdgeClamp) return static_cast<int32_t>(EdgeClamp);
+            if (value < -EdgeClamp) return static_cast<int32_t>(-EdgeClamp);
+            return static_cast<int32_t>(value);
+        }
+
+        static inline bool InGuardBand(float v) {
+            return fabsf(v) <= static_cast<float>(Rasterizer::GuardBand); // false for NaN too
+        }
+
+        static inline int32_t ToFixed(float v) {
+            return static_cast<int32_t>(lrintf(v * static_cast<float>(SubpixelScale)));
+        }
+
+        // Straight RGBA 0..255
+        static void UnpackColor(Draw::VertexColor col, float* out) {
+#ifdef VGUI_VERTEX_FLOAT_COLOR
+            out[0] = col.r * 255.0f;
+            out[1] = col.g * 255.0f;
+            out[2] = col.b * 255.0f;
+            out[3] = col.a * 255.0f;
+#else
+            out[0] = static_cast<float>(col & 0xFF);
+            out[1] = static_cast<float>((col >> 8) & 0xFF);
+            out[2] = static_cast<float>((col >> 16) & 0xFF);
+            out[3] = static_cast<float>(col >> 24);
+#endif
+        }
+
+        static inline float Clamp255(float v) {
+            return (v < 0.0f) ? 0.0f : (v > 255.0f) ? 255.0f : v;
+        }
+
+        // SRC_ALPHA / INV_SRC_ALPHA on color, ONE / ZERO on alpha (the D3D11 blend state)
+        static inline void BlendPixel(uint32_t& dst, float r, float g, float b, float a) {
+            float t = Clamp255(a) * (1.0f / 255.0f);
+            float dr = static_cast<float>(dst & 0xFF);
+            float dg = static_cast<float>((dst >> 8) & 0xFF);
+            float db = static_cast<float>((dst >> 16) & 0xFF);
+            uint32_t ir = static_cast<uint32_t>(dr + (Clamp255(r) - dr) * t + 0.5f);
+            uint32_t ig = static_cast<uint32_t>(dg + (Clamp255(g) - dg) * t + 0.5f);
+            uint32_t ib = static_cast<uint32_t>(db + (Clamp255(b) - db) * t + 0.5f);
+            uint32_t ia = static_cast<uint32_t>(Clamp255(a) + 0.5f);
+            dst = ir | (ig << 8) | (ib << 16) | (ia << 24);
+        }
+
+        static inline void CountOverdraw(uint16_t* overdraw) {
+            if (*overdraw != 0xFFFF) (*overdraw)++;
+        }
+
+        Rasterizer::Rasterizer(unsigned threadCount)
+            : m_Width(0), m_Height(0), m_TilesX(0), m_TilesY(0), m_Stats(),
+            m_Generation(0), m_Busy(0), m_Quit(false), m_NextTile(0), m_Fragments(0) {
+            if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+            if (threadCount == 0) threadCount = 1;
+            for (unsigned i = 1; i < threadCount; i++)
+                m_Workers.emplace_back(&Rasterizer::WorkerLoop, this);
+        }
+
+        Rasterizer::~Rasterizer() {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Quit = true;
+            }
+            m_WakeWorkers.notify_all();
+            for (auto& worker : m_Workers) worker.join();
+        }
+
+        void Rasterizer::Resize(int width, int height) {
+            if (width < 0) width = 0;
+            if (height < 0) height = 0;
+            m_Width = width;
+            m_Height = height;
+            m_TilesX = (width + TileSize - 1) / TileSize;
+            m_TilesY = (height + TileSize - 1) / TileSize;
+            m_Pixels.assign(static_cast<size_t>(width) * height, 0);
+            if (!m_Overdraw.empty()) m_Overdraw.assign(m_Pixels.size(), 0);
+            m_Bins.clear();
+            m_Bins.resize(static_cast<size_t>(m_TilesX) * m_TilesY);
+            m_ActiveTiles.clear();
+        }
+
+        void Rasterizer::Clear(uint32_t rgba) {
+            for (auto& pixel : m_Pixels) pixel = rgba;
+            for (auto& count : m_Overdraw) count = 0;
+        }
+
+        void Rasterizer::EnableOverdrawCounting(bool enable) {
+            if (enable) m_Overdraw.assign(m_Pixels.size() ? m_Pixels.size() : 1, 0);
+            else m_Overdraw.clear();
+        }
+
+        void Rasterizer::AddTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2) {
+            const Vertex* v[3] = { &v0, &v1, &v2 };
+            for (int i = 0; i < 3; i++) {
+                if (!InGuardBand(v[i]->x) || !InGuardBand(v[i]->y)) return;
+            }
+
+            Triangle tri;
+            for (int i = 0; i < 3; i++) {
+                tri.x[i] = ToFixed(v[i]->x);
+                tri.y[i] = ToFixed(v[i]->y);
+            }
+
+            // Wind so every edge function is positive inside; culling is off like the D3D11 state
+            int64_t area = static_cast<int64_t>(tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) -
+                static_cast<int64_t>(tri.y[1] - tri.y[0]) * (tri.x[2] - tri.x[0]);
+            if (area == 0) return;
+            if (area < 0) {
+                std::swap(tri.x[1], tri.x[2]);
+                std::swap(tri.y[1], tri.y[2]);
+                std::swap(v[1], v[2]);
+            }
+
+            int32_t minXs = std::min(tri.x[0], std::min(tri.x[1], tri.x[2]));
+            int32_t maxXs = std::max(tri.x[0], std::max(tri.x[1], tri.x[2]));
+            int32_t minYs = std::min(tri.y[0], std::min(tri.y[1], tri.y[2]));
+            int32_t maxYs = std::max(tri.y[0], std::max(tri.y[1], tri.y[2]));
+
+            // Pixels whose sample lies inside the bounds
+            tri.minX = std::max(0, (minXs - SampleOffset + SubpixelScale - 1) >> SubpixelBits);
+            tri.minY = std::max(0, (minYs - SampleOffset + SubpixelScale - 1) >> SubpixelBits);
+            tri.maxX = std::min(m_Width - 1, (maxXs - SampleOffset) >> SubpixelBits);
+            tri.maxY = std::min(m_Height - 1, (maxYs - SampleOffset) >> SubpixelBits);
+            if (tri.minX > tri.maxX || tri.minY > tri.maxY) return;
+
+            // Linear color planes over the snapped positions, evaluated at pixel centers
+            float px[3], py[3], col[3][4];
+            for (int i = 0; i < 3; i++) {
+                px[i] = static_cast<float>(tri.x[i]) / SubpixelScale;
+                py[i] = static_cast<float>(tri.y[i]) / SubpixelScale;
+                UnpackColor(v[i]->col, col[i]);
+            }
+            float dx1 = px[1] - px[0], dy1 = py[1] - py[0];
+            float dx2 = px[2] - px[0], dy2 = py[2] - py[0];
+            float invDet = 1.0f / (dx1 * dy2 - dx2 * dy1);
+            for (int c = 0; c < 4; c++) {
+                float dc1 = col[1][c] - col[0][c];
+                float dc2 = col[2][c] - col[0][c];
+                float ddx = (dc1 * dy2 - dc2 * dy1) * invDet;
+                float ddy = (dc2 * dx1 - dc1 * dx2) * invDet;
+                tri.color[c][0] = col[0][c] - ddx * px[0] - ddy * py[0];
+                tri.color[c][1] = ddx;
+                tri.color[c][2] = ddy;
+            }
+
+            m_Triangles.push_back(tri);
+            BinTriangle(static_cast<uint32_t>(m_Triangles.size() - 1));
+        }
+
+        // Hard 1px line: a 1px wide quad along the segment
+        void Rasterizer::AddLine(const Vertex& v0, const Vertex& v1) {
+            float dx = v1.x - v0.x;
+            float dy = v1.y - v0.y;
+            float len2 = dx * dx + dy * dy;
+            if (!(len2 > 0.000001f)) return;
+
+            float inv = 0.5f / sqrtf(len2);
+            float nx = -dy * inv, ny = dx * inv;
+            Vertex a = { v0.x + nx, v0.y + ny, v0.col };
+            Vertex b = { v0.x - nx, v0.y - ny, v0.col };
+            Vertex c = { v1.x - nx, v1.y - ny, v1.col };
+            Vertex d = { v1.x + nx, v1.y + ny, v1.col };
+            AddTriangle(a, b, c);
+            AddTriangle(a, c, d);
+        }
+
+        void Rasterizer::AddShape(const ShapeInstance& instance) {
+            // Same quad as the shape vertex shader: bounds grown by feather + 1
+            float margin = instance.feather + 1.0f;
+            float x0 = instance.x - margin, y0 = instance.y - margin;
+            float x1 = instance.x + instance.w + margin, y1 = instance.y + instance.h + margin;
+            if (!InGuardBand(x0) || !InGuardBand(y0) || !InGuardBand(x1) || !InGuardBand(y1)) return;
+
+            Shape shape;
+            shape.instance = instance;
+            shape.minX = std::max(0, static_cast<int>(ceilf(x0 - 0.5f)));
+            shape.minY = std::max(0, static_cast<int>(ceilf(y0 - 0.5f)));
+            shape.maxX = std::min(m_Width - 1, static_cast<int>(floorf(x1 - 0.5f)));
+            shape.maxY = std::min(m_Height - 1, static_cast<int>(floorf(y1 - 0.5f)));
+            if (shape.minX > shape.maxX || shape.minY > shape.maxY) return;
+            UnpackColor(instance.col, shape.color);
+
+            m_Shapes.push_back(shape);
+            BinShape(static_cast<uint32_t>(m_Shapes.size() - 1));
+        }
+
+        void Rasterizer::BinTriangle(uint32_t id) {
+            const Triangle& tri = m_Triangles[id];
+            Edge edges[3];
+            SetupEdges(tri.x, tri.y, edges);
+
+            for (int ty = tri.minY / TileSize; ty <= tri.maxY / TileSize; ty++) {
+                for (int tx = tri.minX / TileSize; tx <= tri.maxX / TileSize; tx++) {
+                    // Extreme samples of the tile
+                    int64_t sx0 = static_cast<int64_t>(tx * TileSize) * SubpixelScale + SampleOffset;
+                    int64_t sy0 = static_cast<int64_t>(ty * TileSize) * SubpixelScale + SampleOffset;
+                    int64_t sx1 = static_cast<int64_t>(std::min((tx + 1) * TileSize, m_Width) - 1) * SubpixelScale + SampleOffset;
+                    int64_t sy1 = static_cast<int64_t>(std::min((ty + 1) * TileSize, m_Height) - 1) * SubpixelScale + SampleOffset;
+
+                    // Reject when the most inside corner fails an edge, accept the whole tile when
+                    // the most outside corner passes all three
+                    bool outside = false, full = true;
+                    for (const Edge& e : edges) {
+                        int64_t inX = e.a > 0 ? sx1 : sx0, inY = e.b > 0 ? sy1 : sy0;
+                        int64_t outX = e.a > 0 ? sx0 : sx1, outY = e.b > 0 ? sy0 : sy1;
+                        if (e.a * inX + e.b * inY + e.c < 0) { outside = true; break; }
+                        if (e.a * outX + e.b * outY + e.c < 0) full = false;
+                    }
+                    if (outside) continue;
+
+                    std::vector<uint32_t>& bin = m_Bins[ty * m_TilesX + tx];
+                    if (bin.empty()) m_ActiveTiles.push_back(ty * m_TilesX + tx);
+                    bin.push_back(id | (full ? FullTileBit : 0));
+                    m_Stats.binEntries++;
+                    if (full) m_Stats.fullTileEntries++;
+                }
+            }
+        }
+
+        void Rasterizer::BinShape(uint32_t id) {
+            const Shape& shape = m_Shapes[id];
+            for (int ty = shape.minY / TileSize; ty <= shape.maxY / TileSize; ty++) {
+                for (int tx = shape.minX / TileSize; tx <= shape.maxX / TileSize; tx++) {
+                    std::vector<uint32_t>& bin = m_Bins[ty * m_TilesX + tx];
+                    if (bin.empty()) m_ActiveTiles.push_back(ty * m_TilesX + tx);
+                    bin.push_back(id | ShapeBit);
+                    m_Stats.binEntries++;
+                }
+            }
+        }
+
+        void Rasterizer::ShadeTriangle(const Triangle& tri, int x0, int y0, int x1, int y1, bool full, uint64_t& fragments) {
+            Edge edges[3];
+            SetupEdges(tri.x, tri.y, edges);
+            int32_t step[3];
+            double invStep[3];
+            for (int i = 0; i < 3; i++) {
+                step[i] = static_cast<int32_t>(edges[i].a * SubpixelScale);
+                invStep[i] = step[i] ? 1.0 / step[i] : 0.0;
+            }
+
+            uint16_t* overdrawRow = m_Overdraw.empty() ? nullptr : m_Overdraw.data();
+            for (int y = y0; y <= y1; y++) {
+                // Skip bands of rows the triangle misses entirely: the most inside corner of the band
+                // fails an edge. Shallow slivers cross a tile in a few rows.
+                if (!full && ((y - y0) % BandRows) == 0) {
+                    int bandY1 = std::min(y + BandRows - 1, y1);
+                    int64_t sx0 = static_cast<int64_t>(x0) * SubpixelScale + SampleOffset;
+                    int64_t sx1 = static_cast<int64_t>(x1) * SubpixelScale + SampleOffset;
+                    int64_t sy0 = static_cast<int64_t>(y) * SubpixelScale + SampleOffset;
+                    int64_t sy1 = static_cast<int64_t>(bandY1) * SubpixelScale + SampleOffset;
+                    bool missed = false;
+                    for (const Edge& edge : edges) {
+                        if (edge.a * (edge.a > 0 ? sx1 : sx0) + edge.b * (edge.b > 0 ? sy1 : sy0) + edge.c < 0)
+                            missed = true;
+                    }
+                    if (missed) {
+                        y = bandY1;
+                        continue;
+                    }
+                }
+
+                int spanX0 = x0, spanX1 = x1;
+                int64_t sy = static_cast<int64_t>(y) * SubpixelScale + SampleOffset;
+                if (!full) {
+                    // Narrow the row to the pixels every edge can accept, so slivers crossing a tile
+                    // do not walk the whole tile width: E(k) = rowE + k * step for pixel k of the row.
+                    int64_t sx = static_cast<int64_t>(x0) * SubpixelScale + SampleOffset;
+                    int64_t first = 0, last = x1 - x0;
+                    for (int i = 0; i < 3 && first <= last; i++) {
+                        int64_t rowE = edges[i].a * sx + edges[i].b * sy + edges[i].c;
+                        int64_t s = step[i];
+                        if (s == 0) {
+                            if (rowE < 0) last = -1;
+                            continue;
+                        }
+                        // Boundary pixel from a reciprocal (truncated), then settled exactly on the integer edge
+                        int64_t k = static_cast<int64_t>(static_cast<double>(-rowE) * invStep[i]);
+                        if (s > 0) {
+                            while (rowE + k * s < 0) k++;
+                            while (rowE + (k - 1) * s >= 0) k--;
+                            first = std::max(first, k);
+                        }
+                        else {
+                            while (rowE + k * s < 0) k--;
+                            while (rowE + (k + 1) * s >= 0) k++;
+                            last = std::min(last, k);
+                        }
+                    }
+                    if (first > last) continue;
+                    spanX0 = x0 + static_cast<int>(first);
+                    spanX1 = x0 + static_cast<int>(last);
+                }
+
+                int64_t sx = static_cast<int64_t>(spanX0) * SubpixelScale + SampleOffset;
+                int32_t e[3];
+                for (int i = 0; i < 3; i++) e[i] = ClampEdge(edges[i].a * sx + edges[i].b * sy + edges[i].c);
+
+                float fx = static_cast<float>(spanX0) + 0.5f, fy = static_cast<float>(y) + 0.5f;
+                float c[4];
+                for (int i = 0; i < 4; i++) c[i] = tri.color[i][0] + tri.color[i][1] * fx + tri.color[i][2] * fy;
+
+                uint32_t* dst = m_Pixels.data() + static_cast<size_t>(y) * m_Width;
+                uint16_t* overdraw = overdrawRow ? overdrawRow + static_cast<size_t>(y) * m_Width : nullptr;
+                int x = spanX0;
+
+#if VGUI_HAS_SSE2
+                // 4 pixels per iteration: edge tests on 32-bit lanes, float interpolation and blend.
+                // Spans shorter than one vector go straight to the scalar loop.
+                if (spanX1 - spanX0 >= 3) {
+                    __m128i e0 = _mm_add_epi32(_mm_set1_epi32(e[0]), _mm_set_epi32(step[0] * 3, step[0] * 2, step[0], 0));
+                    __m128i e1 = _mm_add_epi32(_mm_set1_epi32(e[1]), _mm_set_epi32(step[1] * 3, step[1] * 2, step[1], 0));
+                    __m128i e2 = _mm_add_epi32(_mm_set1_epi32(e[2]), _mm_set_epi32(step[2] * 3, step[2] * 2, step[2], 0));
+                    const __m128i step0 = _mm_set1_epi32(step[0] * 4);
+                    const __m128i step1 = _mm_set1_epi32(step[1] * 4);
+                    const __m128i step2 = _mm_set1_epi32(step[2] * 4);
+
+                    const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+                    __m128 cr = _mm_add_ps(_mm_set1_ps(c[0]), _mm_mul_ps(lane, _mm_set1_ps(tri.color[0][1])));
+                    __m128 cg = _mm_add_ps(_mm_set1_ps(c[1]), _mm_mul_ps(lane, _mm_set1_ps(tri.color[1][1])));
+                    __m128 cb = _mm_add_ps(_mm_set1_ps(c[2]), _mm_mul_ps(lane, _mm_set1_ps(tri.color[2][1])));
+                    __m128 ca = _mm_add_ps(_mm_set1_ps(c[3]), _mm_mul_ps(lane, _mm_set1_ps(tri.color[3][1])));
+                    const __m128 dr4 = _mm_set1_ps(tri.color[0][1] * 4.0f);
+                    const __m128 dg4 = _mm_set1_ps(tri.color[1][1] * 4.0f);
+                    const __m128 db4 = _mm_set1_ps(tri.color[2][1] * 4.0f);
+                    const __m128 da4 = _mm_set1_ps(tri.color[3][1] * 4.0f);
+
+                    const __m128 zero = _mm_setzero_ps();
+                    const __m128 max255 = _mm_set1_ps(255.0f);
+                    const __m128 inv255 = _mm_set1_ps(1.0f / 255.0f);
+                    const __m128i byteMask = _mm_set1_epi32(0xFF);
+
+                    for (; x + 3 <= spanX1; x += 4) {
+                        // Sign bit set in the lanes where any edge is negative
+                        __m128i outside = _mm_or_si128(e0, _mm_or_si128(e1, e2));
+                        int covered = full ? 0xF : (~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF);
+
+                        if (covered) {
+                            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+                            __m128 sr = _mm_min_ps(_mm_max_ps(cr, zero), max255);
+                            __m128 sg = _mm_min_ps(_mm_max_ps(cg, zero), max255);
+                            __m128 sb = _mm_min_ps(_mm_max_ps(cb, zero), max255);
+                            __m128 sa = _mm_min_ps(_mm_max_ps(ca, zero), max255);
+                            __m128 t = _mm_mul_ps(sa, inv255);
+
+                            __m128 dr = _mm_cvtepi32_ps(_mm_and_si128(d, byteMask));
+                            __m128 dg = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(d, 8), byteMask));
+                            __m128 db = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(d, 16), byteMask));
+                            __m128i r = _mm_cvtps_epi32(_mm_add_ps(dr, _mm_mul_ps(_mm_sub_ps(sr, dr), t)));
+                            __m128i g = _mm_cvtps_epi32(_mm_add_ps(dg, _mm_mul_ps(_mm_sub_ps(sg, dg), t)));
+                            __m128i b = _mm_cvtps_epi32(_mm_add_ps(db, _mm_mul_ps(_mm_sub_ps(sb, db), t)));
+                            __m128i a = _mm_cvtps_epi32(sa);
+                            __m128i blended = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)),
+                                _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(a, 24)));
+
+                            if (covered != 0xF) {
+                                // Uncovered lanes keep the destination
+                                __m128i keep = _mm_srai_epi32(outside, 31);
+                                blended = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, blended));
+                            }
+                            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), blended);
+
+                            for (int lane = 0; lane < 4; lane++) {
+                                if (!(covered & (1 << lane))) continue;
+                                fragments++;
+                                if (overdraw) CountOverdraw(overdraw + x + lane);
+                            }
+                        }
+
+                        e0 = _mm_add_epi32(e0, step0);
+                        e1 = _mm_add_epi32(e1, step1);
+                        e2 = _mm_add_epi32(e2, step2);
+                        cr = _mm_add_ps(cr, dr4);
+                        cg = _mm_add_ps(cg, dg4);
+                        cb = _mm_add_ps(cb, db4);
+                        ca = _mm_add_ps(ca, da4);
+                    }
+
+                    // Scalar tail continues from the lanes the vector loop stopped at
+                    int done = x - spanX0;
+                    for (int i = 0; i < 3; i++) e[i] += step[i] * done;
+                    for (int i = 0; i < 4; i++) c[i] += tri.color[i][1] * static_cast<float>(done);
+                }
+#endif
+                for (; x <= spanX1; x++) {
+                    if (full || (e[0] | e[1] | e[2]) >= 0) {
+                        BlendPixel(dst[x], c[0], c[1], c[2], c[3]);
+                        fragments++;
+                        if (overdraw) CountOverdraw(overdraw + x);
+                    }
+                    for (int i = 0; i < 3; i++) e[i] += step[i];
+                    for (int i = 0; i < 4; i++) c[i] += tri.color[i][1];
+                }
+            }
+        }
+
+        void Rasterizer::ShadeShape(const Shape& shape, int x0, int y0, int x1, int y1, uint64_t& fragments) {
+            for (int y = y0; y <= y1; y++) {
+                uint32_t* dst = m_Pixels.data() + static_cast<size_t>(y) * m_Width;
+                uint16_t* overdraw = m_Overdraw.empty() ? nullptr : m_Overdraw.data() + static_cast<size_t>(y) * m_Width;
+                for (int x = x0; x <= x1; x++) {
+                    // Every pixel of the quad is shaded on the GPU too, covered or not
+                    fragments++;
+                    if (overdraw) CountOverdraw(overdraw + x);
+
+                    float coverage = Draw::EvaluateShapeCoverage(shape.instance,
+                        static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f);
+                    // An uncovered pixel still gets the source alpha of 0, the color is kept
+                    if (coverage > 0.0f)
+                        BlendPixel(dst[x], shape.color[0], shape.color[1], shape.color[2], shape.color[3] * coverage);
+                    else
+                        dst[x] &= 0x00FFFFFFu;
+                }
+            }
+        }
+
+        void Rasterizer::ShadeTile(int tile, uint64_t& fragments) {
+            int tx = tile % m_TilesX, ty = tile / m_TilesX;
+            int tileX0 = tx * TileSize, tileY0 = ty * TileSize;
+            int tileX1 = std::min(tileX0 + TileSize, m_Width) - 1;
+            int tileY1 = std::min(tileY0 + TileSize, m_Height) - 1;
+
+            for (uint32_t entry : m_Bins[tile]) {
+                uint32_t id = entry & IdMask;
+                if (entry & ShapeBit) {
+                    const Shape& shape = m_Shapes[id];
+                    ShadeShape(shape, std::max(tileX0, shape.minX), std::max(tileY0, shape.minY),
+                        std::min(tileX1, shape.maxX), std::min(tileY1, shape.maxY), fragments);
+                }
+                else {
+                    const Triangle& tri = m_Triangles[id];
+                    ShadeTriangle(tri, std::max(tileX0, tri.minX), std::max(tileY0, tri.minY),
+                        std::min(tileX1, tri.maxX), std::min(tileY1, tri.maxY), (entry & FullTileBit) != 0, fragments);
+                }
+            }
+        }
+
+        void Rasterizer::ShadeTiles() {
+            m_NextTile = 0;
+            m_Fragments = 0;
+
+            bool parallel = !m_Workers.empty() && m_ActiveTiles.size() > 1;
+            if (parallel) {
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    m_Busy = static_cast<unsigned>(m_Workers.size());
+                    m_Generation++;
+                }
+                m_WakeWorkers.notify_all();
+            }
+
+            uint64_t fragments = 0;
+            for (size_t i; (i = m_NextTile.fetch_add(1)) < m_ActiveTiles.size();)
+                ShadeTile(m_ActiveTiles[i], fragments);
+            m_Fragments += fragments;
+
+            if (parallel) {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WorkersDone.wait(lock, [this] { return m_Busy == 0; });
+            }
+        }
+
+        void Rasterizer::WorkerLoop() {
+            uint64_t seen = 0;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(m_Mutex);
+                    m_WakeWorkers.wait(lock, [&] { return m_Quit || m_Generation != seen; });
+                    if (m_Quit) return;
+                    seen = m_Generation;
+                }
+
+                uint64_t fragments = 0;
+                for (size_t i; (i = m_NextTile.fetch_add(1)) < m_ActiveTiles.size();)
+                    ShadeTile(m_ActiveTiles[i], fragments);
+                m_Fragments += fragments;
+
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (--m_Busy == 0) m_WorkersDone.notify_one();
+            }
+        }
+
+        void Rasterizer::Render(const Draw::DrawData& data) {
+            Clock::time_point start = Clock::now();
+
+            for (int tile : m_ActiveTiles) m_Bins[tile].clear();
+            m_ActiveTiles.clear();
+            m_Triangles.clear();
+            m_Shapes.clear();
+            m_Stats = RasterStats();
+            if (m_Width == 0 || m_Height == 0) return;
+
+            // Expand every command into triangles and shapes, binned as they are set up
+            for (size_t c = 0; c < data.commandCount; c++) {
+                const DrawCommand& cmd = data.commands[c];
+                const Draw::DrawIndex* idx = data.indices + cmd.indexStart;
+                const Vertex* base = data.vertices + cmd.vertexStart;
+
+                switch (cmd.type) {
+                case DrawCommandType::Shapes:
+                    for (size_t i = 0; i < cmd.indexCount; i++)
+                        AddShape(data.instances[cmd.indexStart + i]);
+                    break;
+
+                case DrawCommandType::Triangles:
+                    for (size_t i = 0; i + 2 < cmd.indexCount; i += 3)
+                        AddTriangle(base[idx[i]], base[idx[i + 1]], base[idx[i + 2]]);
+                    break;
+
+                case DrawCommandType::TriangleStrip:
+                    // StripRestartIndex starts a new strip
+                    for (size_t i = 0, first = 0; i < cmd.indexCount; i++) {
+                        if (idx[i] == Draw::StripRestartIndex) first = i + 1;
+                        else if (i >= first + 2) AddTriangle(base[idx[i - 2]], base[idx[i - 1]], base[idx[i]]);
+                    }
+                    break;
+
+                case DrawCommandType::Lines:
+                    for (size_t i = 0; i + 1 < cmd.indexCount; i += 2)
+                        AddLine(base[idx[i]], base[idx[i + 1]]);
+                    break;
+
+                case DrawCommandType::LineStrip:
+                    for (size_t i = 0, first = 0; i < cmd.indexCount; i++) {
+                        if (idx[i] == Draw::StripRestartIndex) first = i + 1;
+                        else if (i >= first + 1) AddLine(base[idx[i - 1]], base[idx[i]]);
+                    }
+                    break;
+                }
+            }
+
+            Clock::time_point binned = Clock::now();
+            ShadeTiles();
+
+            m_Stats.triangles = m_Triangles.size();
+            m_Stats.shapes = m_Shapes.size();
+            m_Stats.activeTiles = m_ActiveTiles.size();
+            m_Stats.fragments = m_Fragments;
+            m_Stats.setupMilliseconds = Milliseconds(start, binned);
+            m_Stats.shadeMilliseconds = Milliseconds(binned, Clock::now());
+        }
+
+        bool RasterBackend::Upload(const Draw::DrawData& data, int displayWidth, int displayHeight) {
+            if (displayWidth != m_Rasterizer.GetWidth() || displayHeight != m_Rasterizer.GetHeight())
+                m_Rasterizer.Resize(displayWidth, displayHeight);
+
+            // The streams stay valid until EndFrame(), only the submitted commands are copied
+            m_Frame = data;
+            m_Commands.clear();
+            return true;
+        }
+
+        void RasterBackend::Submit(const Draw::DrawCommand& cmd) {
+            m_Commands.push_back(cmd);
+        }
+
+        void RasterBackend::EndFrame() {
+            if (m_Commands.empty()) return;
+
+            m_Frame.commands = m_Commands.data();
+            m_Frame.commandCount = m_Commands.size();
+            m_Rasterizer.Render(m_Frame);
+            m_Commands.clear();
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "vgui_draw.h"
+#include "vgui_render.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VGUI {
+    namespace Raster {
+        // Counters of the last Render()
+        struct RasterStats {
+            size_t triangles;           // triangles set up, after lines and strips are expanded
+            size_t shapes;              // SDF shape instances
+            size_t binEntries;          // primitive / tile pairs written by the binner
+            size_t fullTileEntries;     // entries covering their whole tile (no edge tests)
+            size_t activeTiles;         // tiles with at least one primitive
+            uint64_t fragments;         // pixels shaded, every layer counted (overdraw included)
+            double setupMilliseconds;   // triangle setup and binning, single threaded
+            double shadeMilliseconds;   // tile shading, all threads
+        };
+
+        // Tile-binned CPU rasterizer for the Draw:: command stream, for hosts without D3D11 and for
+        // golden-image checks. It follows the D3D11 renderer: pixel centers at +0.5, 4-bit subpixel
+        // precision with the top-left fill rule, SRC_ALPHA / INV_SRC_ALPHA color blending with the
+        // source alpha written as is, and the SDF coverage of Draw::EvaluateShapeCoverage for shapes.
+        // 1px line lists are widened into 1px quads. Pixels are RGBA8, red in the lowest byte.
+        //
+        // Render() sets up and bins primitives into TileSize tiles in submission order, then shades
+        // the tiles in parallel; every tile blends its primitives in order, so the image does not
+        // depend on the thread count. Vertices further than GuardBand pixels off screen are dropped.
+        class Rasterizer {
+        public:
+            static const int TileSize = 64;
+            static const int GuardBand = 8192;
+
+            // threadCount = 0 uses every hardware thread. The calling thread is one of them.
+            explicit Rasterizer(unsigned threadCount = 0);
+            ~Rasterizer();
+            Rasterizer(const Rasterizer&) = delete;
+            Rasterizer& operator=(const Rasterizer&) = delete;
+
+            void Resize(int width, int height);
+            // Fills the framebuffer and resets the overdraw counts
+            void Clear(uint32_t rgba);
+            void Render(const Draw::DrawData& data);
+
+            // Counts fragments per pixel (saturating) until the next Clear(), for overdraw heat maps
+            void EnableOverdrawCounting(bool enable);
+            const uint16_t* GetOverdraw() const { return m_Overdraw.empty() ? nullptr : m_Overdraw.data(); }
+
+            const uint32_t* GetPixels() const { return m_Pixels.data(); }
+            int GetWidth() const { return m_Width; }
+            int GetHeight() const { return m_Height; }
+            unsigned GetThreadCount() const { return static_cast<unsigned>(m_Workers.size()) + 1; }
+            const RasterStats& GetStats() const { return m_Stats; }
+
+        private:
+            struct Triangle {
+                int32_t x[3], y[3];         // 28.4 fixed point, wound so the edge functions are >= 0 inside
+                int minX, minY, maxX, maxY; // covered pixel bounds, clipped to the framebuffer
+                float color[4][3];          // per channel plane (0..255): c = p[0] + p[1] * x + p[2] * y
+            };
+
+            struct Shape {
+                Draw::ShapeInstance instance;
+                int minX, minY, maxX, maxY;
+                float color[4];
+            };
+
+            void AddTriangle(const Draw::Vertex& v0, const Draw::Vertex& v1, const Draw::Vertex& v2);
+            void AddLine(const Draw::Vertex& v0, const Draw::Vertex& v1);
+            void AddShape(const Draw::ShapeInstance& instance);
+            void BinTriangle(uint32_t id);
+            void BinShape(uint32_t id);
+
+            void ShadeTiles();
+            void ShadeTile(int tile, uint64_t& fragments);
+            void ShadeTriangle(const Triangle& tri, int x0, int y0, int x1, int y1, bool full, uint64_t& fragments);
+            void ShadeShape(const Shape& shape, int x0, int y0, int x1, int y1, uint64_t& fragments);
+            void WorkerLoop();
+
+            int m_Width;
+            int m_Height;
+            int m_TilesX;
+            int m_TilesY;
+            std::vector<uint32_t> m_Pixels;
+            std::vector<uint16_t> m_Overdraw;
+            std::vector<Triangle> m_Triangles;
+            std::vector<Shape> m_Shapes;
+            std::vector<std::vector<uint32_t>> m_Bins;  // per tile: primitive ids, in submission order
+            std::vector<int> m_ActiveTiles;
+            RasterStats m_Stats;
+
+            // Persistent workers, woken once per Render()
+            std::vector<std::thread> m_Workers;
+            std::mutex m_Mutex;
+            std::condition_variable m_WakeWorkers;
+            std::condition_variable m_WorkersDone;
+            uint64_t m_Generation;
+            unsigned m_Busy;
+            bool m_Quit;
+            std::atomic<size_t> m_NextTile;
+            std::atomic<uint64_t> m_Fragments;
+        };
+
+        // Render backend drawing into a Rasterizer, so Draw::Render() can target the CPU renderer
+        // through Draw::SetRenderBackend(). The frame is rasterized at EndFrame(); the framebuffer is
+        // resized to the display size when it differs and is never cleared by the backend.
+        class RasterBackend : public Draw::RenderBackend {
+        public:
+            explicit RasterBackend(Rasterizer& rasterizer) : m_Rasterizer(rasterizer), m_Frame() {}
+
+            bool Upload(const Draw::DrawData& data, int displayWidth, int displayHeight) override;
+            void BindPipeline(Draw::DrawCommandType) override {}
+            void Submit(const Draw::DrawCommand& cmd) override;
+            void EndFrame() override;
+
+        private:
+            Rasterizer& m_Rasterizer;
+            Draw::DrawData m_Frame;
+            std::vector<Draw::DrawCommand> m_Commands;
+        };
+    }
+}
@@ -0,0 +1,76 @@
+#include "vgui_render.h"
+#include "vgui_context.h"
+
+namespace VGUI {
+    namespace Draw {
+        bool NullBackend::Upload(const DrawData& data, int, int) {
+            m_Counters.uploadedBytes += data.vertexCount * sizeof(Vertex) + data.indexCount * sizeof(DrawIndex) +
+                data.instanceCount * sizeof(ShapeInstance);
+            return true;
+        }
+
+        void NullBackend::BindPipeline(DrawCommandType) {
+            m_Counters.pipelineBinds++;
+        }
+
+        void NullBackend::Submit(const DrawCommand&) {
+            m_Counters.submits++;
+        }
+
+        void NullBackend::EndFrame() {
+            m_Counters.frames++;
+        }
+
+        void SetRenderBackend(RenderBackend* backend) {
+            Context& ctx = GetCurrentContext();
+            ctx.backend = backend ? backend : &ctx.nullBackend;
+        }
+
+        RenderBackend* GetRenderBackend() {
+            return GetCurrentContext().backend;
+        }
+
+        void RenderDrawData(RenderBackend& backend, const DrawData& data, int displayWidth, int displayHeight) {
+            if (!backend.Upload(data, displayWidth, displayHeight)) {
+                backend.EndFrame();
+                return;
+            }
+
+            // Pipeline and topology only change between runs of different command types
+            bool first = true;
+            DrawCommandType bound = DrawCommandType::Lines;
+            for (size_t i = 0; i < data.commandCount; i++) {
+                const DrawCommand& cmd = data.commands[i];
+                if (first || cmd.type != bound) {
+                    first = false;
+                    bound = cmd.type;
+                    backend.BindPipeline(cmd.type);
+                }
+                backend.Submit(cmd);
+            }
+            backend.EndFrame();
+        }
+
+        static const Upload::RingStats& GetRingStats(UploadStream stream) {
+            static const Upload::RingStats empty = {};
+            const Upload::RingStats* stats = GetCurrentContext().backend->GetUploadStats(stream);
+            return stats ? *stats : empty;
+        }
+
+        const Upload::RingStats& GetVertexRingStats() {
+            return GetRingStats(UploadStream::Vertices);
+        }
+
+        const Upload::RingStats& GetIndexRingStats() {
+            return GetRingStats(UploadStream::Indices);
+        }
+
+        const Upload::RingStats& GetInstanceRingStats() {
+            return GetRingStats(UploadStream::Instances);
+        }
+
+        void ReleaseResources() {
+            GetCurrentContext().backend->ReleaseResources();
+        }
+    }
+}
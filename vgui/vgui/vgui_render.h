@@ -0,0 +1,68 @@
+#pragma once
+#include "vgui_draw.h"
+#include "vgui_upload.h"
+#include <cstdint>
+
+namespace VGUI {
+    namespace Draw {
+        enum class UploadStream {
+            Vertices,
+            Indices,
+            Instances
+        };
+
+        // Graphics API behind Draw::Render(). Render() hands the merged frame to Upload() once, then
+        // walks the commands, calling BindPipeline() only when the command type changes and Submit()
+        // for every command. Backends: D3D11 (vgui_render_d3d11.cpp), OpenGL 3.3 / GLES 3
+        // (vgui_render_gl.cpp), Vulkan (vgui_render_vulkan.cpp) and the software rasterizer
+        // (Raster::RasterBackend).
+        class RenderBackend {
+        public:
+            virtual ~RenderBackend() {}
+
+            // Copies the vertex, index and instance streams of the frame to the device. Returning false
+            // drops the frame; EndFrame() is still called.
+            virtual bool Upload(const DrawData& data, int displayWidth, int displayHeight) = 0;
+            // Binds the shaders, input layout and topology the commands of this type need
+            virtual void BindPipeline(DrawCommandType type) = 0;
+            virtual void Submit(const DrawCommand& cmd) = 0;
+            virtual void EndFrame() = 0;
+
+            // Drops device buffers; the next frame recreates them
+            virtual void ReleaseResources() {}
+            // Ring statistics of an upload stream, nullptr when the backend does not stream through one
+            virtual const Upload::RingStats* GetUploadStats(UploadStream) const { return nullptr; }
+        };
+
+        // Accepts and discards everything, counting what a real backend would have been asked to do.
+        // The default backend, so the tessellation and batching cost of real frames can be profiled
+        // without a driver on any OS.
+        class NullBackend : public RenderBackend {
+        public:
+            struct Counters {
+                uint64_t frames;
+                uint64_t uploadedBytes;
+                uint64_t pipelineBinds;
+                uint64_t submits;
+            };
+
+            bool Upload(const DrawData& data, int displayWidth, int displayHeight) override;
+            void BindPipeline(DrawCommandType type) override;
+            void Submit(const DrawCommand& cmd) override;
+            void EndFrame() override;
+
+            const Counters& GetCounters() const { return m_Counters; }
+            void ResetCounters() { m_Counters = Counters(); }
+
+        private:
+            Counters m_Counters = {};
+        };
+
+        // Backend used by Render(); nullptr restores the built-in NullBackend. Not owned.
+        void SetRenderBackend(RenderBackend* backend);
+        RenderBackend* GetRenderBackend();
+
+        // Uploads and submits a merged frame through a backend; called by Render()
+        void RenderDrawData(RenderBackend& backend, const DrawData& data, int displayWidth, int displayHeight);
+    }
+}
@@ -0,0 +1,471 @@
+#include "vgui_render_d3d11.h"
+#include "vgui_upload.h"
+#include <d3dcompiler.h>
+#include <vector>
+#include <cstring>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+namespace VGUI {
+    namespace Draw {
+        static const char* vertexShaderSource = R"(
+cbuffer Projection : register(b0) {
+    float2 scale;   // 2 / width, -2 / height
+    float2 offset;  // -1, 1
+};
+struct VS_INPUT {
+    float2 pos : POSITION;
+    float4 col : COLOR;
+};
+struct PS_INPUT {
+    float4 pos : SV_POSITION;
+    float4 col : COLOR;
+};
+PS_INPUT main(VS_INPUT input) {
+    PS_INPUT output;
+    output.pos = float4(input.pos * scale + offset, 0.0f, 1.0f);
+    output.col = input.col;
+    return output;
+}
+)";
+
+        static const char* pixelShaderSource = R"(
+struct PS_INPUT {
+    float4 pos : SV_POSITION;
+    float4 col : COLOR;
+};
+float4 main(PS_INPUT input) : SV_Target {
+    return input.col;
+}
+)";
+
+        // Instanced SDF shapes: one Draw::ShapeInstance per instance, expanded to a quad from SV_VertexID
+        static const char* shapeVertexShaderSource = R"(
+cbuffer Projection : register(b0) {
+    float2 scale;
+    float2 offset;
+};
+struct VS_INPUT {
+    float4 rect : RECT;         // x, y, w, h in pixels
+    float3 params : PARAMS;     // corner radius, border width, feather
+    float4 col : COLOR;
+    uint id : SV_VertexID;
+};
+struct PS_INPUT {
+    float4 pos : SV_POSITION;
+    float2 local : TEXCOORD0;   // pixel position relative to the shape center
+    float2 halfSize : TEXCOORD1;
+    float3 params : TEXCOORD2;
+    float4 col : COLOR;
+};
+PS_INPUT main(VS_INPUT input) {
+    PS_INPUT output;
+    float2 corner = float2(input.id & 1, input.id >> 1);
+    float2 halfSize = input.rect.zw * 0.5f;
+    float margin = input.params.z + 1.0f;
+    float2 local = (corner * 2.0f - 1.0f) * (halfSize + margin);
+    output.pos = float4((input.rect.xy + halfSize + local) * scale + offset, 0.0f, 1.0f);
+    output.local = local;
+    output.halfSize = halfSize;
+    output.params = input.params;
+    output.col = input.col;
+    return output;
+}
+)";
+
+        // Must stay in sync with Draw::EvaluateShapeCoverage
+        static const char* shapePixelShaderSource = R"(
+struct PS_INPUT {
+    float4 pos : SV_POSITION;
+    float2 local : TEXCOORD0;
+    float2 halfSize : TEXCOORD1;
+    float3 params : TEXCOORD2;
+    float4 col : COLOR;
+};
+float4 main(PS_INPUT input) : SV_Target {
+    float radius = input.params.x;
+    float border = input.params.y;
+    float feather = input.params.z;
+    float2 q = abs(input.local) - input.halfSize + radius;
+    float d = length(max(q, 0.0f)) + min(max(q.x, q.y), 0.0f) - radius;
+    if (border > 0.0f) d = abs(d + border * 0.5f) - border * 0.5f;
+    float coverage = feather > 0.0f ? saturate(0.5f - d / feather) : (d <= 0.0f ? 1.0f : 0.0f);
+    return float4(input.col.rgb, input.col.a * coverage);
+}
+)";
+
+        template <typename T>
+        static void SafeRelease(T*& object) {
+            if (object) { object->Release(); object = nullptr; }
+        }
+
+        // Dynamic D3D11 buffer + event queries backing an Upload::RingBuffer
+        class D3D11UploadDevice : public Upload::UploadDevice {
+        public:
+            D3D11UploadDevice(ID3D11Device* device, ID3D11DeviceContext* context, UINT bindFlags)
+                : m_Device(device), m_Context(context), m_BindFlags(bindFlags) {}
+
+            ~D3D11UploadDevice() override {
+                Release();
+            }
+
+            bool CreateBuffer(size_t capacity) override {
+                ReleaseBuffer();
+
+                D3D11_BUFFER_DESC bd = {};
+                bd.Usage = D3D11_USAGE_DYNAMIC;
+                bd.ByteWidth = static_cast<UINT>(capacity);
+                bd.BindFlags = m_BindFlags;
+                bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+                return SUCCEEDED(m_Device->CreateBuffer(&bd, nullptr, &m_Buffer));
+            }
+
+            void* Map(bool discard) override {
+                if (!m_Buffer) return nullptr;
+
+                D3D11_MAPPED_SUBRESOURCE mapped = {};
+                D3D11_MAP mapType = discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+                if (FAILED(m_Context->Map(m_Buffer, 0, mapType, 0, &mapped))) return nullptr;
+                return mapped.pData;
+            }
+
+            void Unmap() override {
+                m_Context->Unmap(m_Buffer, 0);
+            }
+
+            uint64_t SignalFence() override {
+                Fence fence = { ++m_LastFence, nullptr };
+                if (!m_FreeQueries.empty()) {
+                    fence.query = m_FreeQueries.back();
+                    m_FreeQueries.pop_back();
+                }
+                else {
+                    D3D11_QUERY_DESC qd = {};
+                    qd.Query = D3D11_QUERY_EVENT;
+                    m_Device->CreateQuery(&qd, &fence.query);
+                }
+
+                // Without a query the frame is treated as retired immediately, which is what
+                // the old per-frame CreateBuffer path assumed anyway.
+                if (fence.query) {
+                    m_Context->End(fence.query);
+                    m_Pending.push_back(fence);
+                }
+                else {
+                    m_CompletedFence = fence.value;
+                }
+                return fence.value;
+            }
+
+            uint64_t GetCompletedFence() override {
+                while (!m_Pending.empty()) {
+                    BOOL done = FALSE;
+                    if (m_Context->GetData(m_Pending.front().query, &done, sizeof(done), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK || !done)
+                        break;
+                    m_CompletedFence = m_Pending.front().value;
+                    m_FreeQueries.push_back(m_Pending.front().query);
+                    m_Pending.erase(m_Pending.begin());
+                }
+                return m_CompletedFence;
+            }
+
+            ID3D11Buffer* GetBuffer() const { return m_Buffer; }
+
+            void Release() {
+                ReleaseBuffer();
+                for (auto& fence : m_Pending) fence.query->Release();
+                for (auto* query : m_FreeQueries) query->Release();
+                m_Pending.clear();
+                m_FreeQueries.clear();
+            }
+
+        private:
+            struct Fence {
+                uint64_t value;
+                ID3D11Query* query;
+            };
+
+            void ReleaseBuffer() {
+                SafeRelease(m_Buffer);
+            }
+
+            ID3D11Device* m_Device;
+            ID3D11DeviceContext* m_Context;
+            UINT m_BindFlags;
+            ID3D11Buffer* m_Buffer = nullptr;
+            uint64_t m_LastFence = 0;
+            uint64_t m_CompletedFence = 0;
+            std::vector<Fence> m_Pending;
+            std::vector<ID3D11Query*> m_FreeQueries;
+        };
+
+        // Copies a CPU stream into its ring, empty streams map nothing
+        template <typename T>
+        static bool CopyToRing(Upload::RingBuffer& ring, const T* data, size_t count, size_t& outOffset) {
+            outOffset = 0;
+            if (count == 0) return true;
+
+            size_t bytes = sizeof(T) * count;
+            void* dst = ring.Map(bytes, sizeof(T), outOffset);
+            if (!dst) return false;
+            memcpy(dst, data, bytes);
+            ring.Unmap();
+            return true;
+        }
+
+        static ID3DBlob* CompileShader(const char* source, const char* target) {
+            ID3DBlob* blob = nullptr;
+            ID3DBlob* errorBlob = nullptr;
+            D3DCompile(source, strlen(source), nullptr, nullptr, nullptr, "main", target, 0, 0, &blob, &errorBlob);
+            SafeRelease(errorBlob);
+            return blob;
+        }
+
+        // Owns the D3D11 pipeline objects and the persistent vertex, index and instance rings
+        class D3D11Backend : public RenderBackend {
+        public:
+            D3D11Backend(ID3D11Device* device, ID3D11DeviceContext* context)
+                : m_Device(device), m_Context(context),
+                m_VertexUpload(device, context, D3D11_BIND_VERTEX_BUFFER),
+                m_IndexUpload(device, context, D3D11_BIND_INDEX_BUFFER),
+                m_InstanceUpload(device, context, D3D11_BIND_VERTEX_BUFFER),
+                m_VertexRing(&m_VertexUpload), m_IndexRing(&m_IndexUpload), m_InstanceRing(&m_InstanceUpload) {
+            }
+
+            ~D3D11Backend() override {
+                SafeRelease(m_InputLayout);
+                SafeRelease(m_VertexShader);
+                SafeRelease(m_PixelShader);
+                SafeRelease(m_BlendState);
+                SafeRelease(m_RasterizerState);
+                SafeRelease(m_ProjectionBuffer);
+                SafeRelease(m_ShapeInputLayout);
+                SafeRelease(m_ShapeVertexShader);
+                SafeRelease(m_ShapePixelShader);
+            }
+
+            bool CreatePipeline() {
+                ID3DBlob* vsBlob = CompileShader(vertexShaderSource, "vs_5_0");
+                ID3DBlob* psBlob = CompileShader(pixelShaderSource, "ps_5_0");
+                bool ok = vsBlob && psBlob;
+                if (ok) {
+                    m_Device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &m_VertexShader);
+                    m_Device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &m_PixelShader);
+
+                    // Matches Draw::Vertex: float2 position + packed RGBA8 (or float4) color
+                    D3D11_INPUT_ELEMENT_DESC layout[] = {
+                        { "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                        { "COLOR", 0, ColorFormat, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+                    };
+                    m_Device->CreateInputLayout(layout, 2, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), &m_InputLayout);
+                }
+                SafeRelease(vsBlob);
+                SafeRelease(psBlob);
+                if (!ok) return false;
+
+                vsBlob = CompileShader(shapeVertexShaderSource, "vs_5_0");
+                psBlob = CompileShader(shapePixelShaderSource, "ps_5_0");
+                ok = vsBlob && psBlob;
+                if (ok) {
+                    m_Device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &m_ShapeVertexShader);
+                    m_Device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &m_ShapePixelShader);
+
+                    // Matches Draw::ShapeInstance, stepped once per instance
+                    D3D11_INPUT_ELEMENT_DESC shapeLayout[] = {
+                        { "RECT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+                        { "PARAMS", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+                        { "COLOR", 0, ColorFormat, 0, 28, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+                    };
+                    m_Device->CreateInputLayout(shapeLayout, 3, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), &m_ShapeInputLayout);
+                }
+                SafeRelease(vsBlob);
+                SafeRelease(psBlob);
+                if (!ok) return false;
+
+                D3D11_BLEND_DESC blendDesc = {};
+                blendDesc.RenderTarget[0].BlendEnable = TRUE;
+                blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+                blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+                blendDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+                blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+                blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+                blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+                blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+                m_Device->CreateBlendState(&blendDesc, &m_BlendState);
+
+                D3D11_RASTERIZER_DESC rastDesc = {};
+                rastDesc.FillMode = D3D11_FILL_SOLID;
+                rastDesc.CullMode = D3D11_CULL_NONE;
+                // No MSAA or hardware line AA: edges are anti-aliased by the CPU fringe and the shape shader
+                rastDesc.MultisampleEnable = FALSE;
+                rastDesc.AntialiasedLineEnable = FALSE;
+                m_Device->CreateRasterizerState(&rastDesc, &m_RasterizerState);
+
+                // Pixel -> NDC transform, refreshed every frame
+                D3D11_BUFFER_DESC cbDesc = {};
+                cbDesc.ByteWidth = 16;
+                cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+                cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+                cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+                m_Device->CreateBuffer(&cbDesc, nullptr, &m_ProjectionBuffer);
+
+                return m_VertexShader && m_PixelShader && m_InputLayout && m_ShapeVertexShader &&
+                    m_ShapePixelShader && m_ShapeInputLayout && m_BlendState && m_RasterizerState && m_ProjectionBuffer;
+            }
+
+            bool Upload(const DrawData& data, int displayWidth, int displayHeight) override {
+                // Stream vertices, indices and shape instances into the persistent rings
+                bool uploaded = CopyToRing(m_VertexRing, data.vertices, data.vertexCount, m_VertexOffset) &&
+                    CopyToRing(m_IndexRing, data.indices, data.indexCount, m_IndexOffset) &&
+                    CopyToRing(m_InstanceRing, data.instances, data.instanceCount, m_InstanceOffset);
+                if (!uploaded) return false;
+
+                // Pixel -> NDC projection for the current display size
+                D3D11_MAPPED_SUBRESOURCE mapped = {};
+                if (SUCCEEDED(m_Context->Map(m_ProjectionBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+                    float* projection = static_cast<float*>(mapped.pData);
+                    projection[0] = 2.0f / static_cast<float>(displayWidth > 0 ? displayWidth : 1);
+                    projection[1] = -2.0f / static_cast<float>(displayHeight > 0 ? displayHeight : 1);
+                    projection[2] = -1.0f;
+                    projection[3] = 1.0f;
+                    m_Context->Unmap(m_ProjectionBuffer, 0);
+                }
+
+                // Shared pipeline state
+                m_Context->VSSetConstantBuffers(0, 1, &m_ProjectionBuffer);
+                m_Context->OMSetBlendState(m_BlendState, nullptr, 0xffffffff);
+                m_Context->RSSetState(m_RasterizerState);
+                if (data.indexCount > 0) {
+                    m_Context->IASetIndexBuffer(m_IndexUpload.GetBuffer(),
+                        sizeof(DrawIndex) == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, static_cast<UINT>(m_IndexOffset));
+                }
+                m_PipelineBound = false;
+                return true;
+            }
+
+            void BindPipeline(DrawCommandType type) override {
+                // Shaders and input layout only switch between shapes and plain vertices
+                bool shapes = type == DrawCommandType::Shapes;
+                if (!m_PipelineBound || shapes != m_ShapesBound) {
+                    m_PipelineBound = true;
+                    m_ShapesBound = shapes;
+                    if (shapes) {
+                        ID3D11Buffer* instanceBuffer = m_InstanceUpload.GetBuffer();
+                        UINT stride = sizeof(ShapeInstance);
+                        UINT offset = static_cast<UINT>(m_InstanceOffset);
+                        m_Context->IASetVertexBuffers(0, 1, &instanceBuffer, &stride, &offset);
+                        m_Context->IASetInputLayout(m_ShapeInputLayout);
+                        m_Context->VSSetShader(m_ShapeVertexShader, nullptr, 0);
+                        m_Context->PSSetShader(m_ShapePixelShader, nullptr, 0);
+                    }
+                    else {
+                        ID3D11Buffer* vertexBuffer = m_VertexUpload.GetBuffer();
+                        UINT stride = sizeof(Vertex);
+                        UINT offset = static_cast<UINT>(m_VertexOffset);
+                        m_Context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+                        m_Context->IASetInputLayout(m_InputLayout);
+                        m_Context->VSSetShader(m_VertexShader, nullptr, 0);
+                        m_Context->PSSetShader(m_PixelShader, nullptr, 0);
+                    }
+                }
+
+                switch (type) {
+                case DrawCommandType::Lines:
+                    m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+                    break;
+
+                case DrawCommandType::Triangles:
+                    m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+                    break;
+
+                // Indexed strips always cut at 0xFFFF with 16-bit indices (Draw::StripRestartIndex)
+                case DrawCommandType::TriangleStrip:
+                case DrawCommandType::Shapes:
+                    m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+                    break;
+
+                case DrawCommandType::LineStrip:
+                    m_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP);
+                    break;
+                }
+            }
+
+            void Submit(const DrawCommand& cmd) override {
+                if (cmd.type == DrawCommandType::Shapes) {
+                    // 4-vertex strip per instance, corners come from SV_VertexID
+                    m_Context->DrawInstanced(4, static_cast<UINT>(cmd.indexCount), 0, static_cast<UINT>(cmd.indexStart));
+                }
+                else {
+                    m_Context->DrawIndexed(static_cast<UINT>(cmd.indexCount), static_cast<UINT>(cmd.indexStart),
+                        static_cast<INT>(cmd.vertexStart));
+                }
+            }
+
+            void EndFrame() override {
+                m_VertexRing.EndFrame();
+                m_IndexRing.EndFrame();
+                m_InstanceRing.EndFrame();
+            }
+
+            void ReleaseResources() override {
+                m_VertexUpload.Release();
+                m_IndexUpload.Release();
+                m_InstanceUpload.Release();
+                m_VertexRing.Reset();
+                m_IndexRing.Reset();
+                m_InstanceRing.Reset();
+            }
+
+            const Upload::RingStats* GetUploadStats(UploadStream stream) const override {
+                switch (stream) {
+                case UploadStream::Vertices: return &m_VertexRing.GetStats();
+                case UploadStream::Indices: return &m_IndexRing.GetStats();
+                case UploadStream::Instances: return &m_InstanceRing.GetStats();
+                }
+                return nullptr;
+            }
+
+        private:
+#ifdef VGUI_VERTEX_FLOAT_COLOR
+            static const DXGI_FORMAT ColorFormat = DXGI_FORMAT_R32G32B32A32_FLOAT;
+#else
+            static const DXGI_FORMAT ColorFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+#endif
+
+            ID3D11Device* m_Device;
+            ID3D11DeviceContext* m_Context;
+            ID3D11VertexShader* m_VertexShader = nullptr;
+            ID3D11PixelShader* m_PixelShader = nullptr;
+            ID3D11InputLayout* m_InputLayout = nullptr;
+            ID3D11VertexShader* m_ShapeVertexShader = nullptr;
+            ID3D11PixelShader* m_ShapePixelShader = nullptr;
+            ID3D11InputLayout* m_ShapeInputLayout = nullptr;
+            ID3D11BlendState* m_BlendState = nullptr;
+            ID3D11RasterizerState* m_RasterizerState = nullptr;
+            ID3D11Buffer* m_ProjectionBuffer = nullptr;
+
+            D3D11UploadDevice m_VertexUpload;
+            D3D11UploadDevice m_IndexUpload;
+            D3D11UploadDevice m_InstanceUpload;
+            Upload::RingBuffer m_VertexRing;
+            Upload::RingBuffer m_IndexRing;
+            Upload::RingBuffer m_InstanceRing;
+            size_t m_VertexOffset = 0;
+            size_t m_IndexOffset = 0;
+            size_t m_InstanceOffset = 0;
+            bool m_PipelineBound = false;
+            bool m_ShapesBound = false;
+        };
+
+        RenderBackend* CreateD3D11Backend(ID3D11Device* device, ID3D11DeviceContext* context) {
+            if (!device || !context) return nullptr;
+
+            D3D11Backend* backend = new D3D11Backend(device, context);
+            if (!backend->CreatePipeline()) {
+                delete backend;
+                return nullptr;
+            }
+            return backend;
+        }
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "vgui_render.h"
+#include <d3d11.h>
+
+namespace VGUI {
+    namespace Draw {
+        // Compiles the VGUI shaders and creates the pipeline state on the given device. The caller
+        // owns the returned backend and deletes it before releasing the device; nullptr on failure.
+        RenderBackend* CreateD3D11Backend(ID3D11Device* device, ID3D11DeviceContext* context);
+    }
+}
@@ -0,0 +1,541 @@
+#include "vgui_render_gl.h"
+#include "vgui_upload.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define VGUI_GLAPI __stdcall
+#else
+#define VGUI_GLAPI
+#endif
+
+namespace VGUI {
+    namespace Draw {
+        // The few GL types and enums the backend needs, so no system GL header is required
+        typedef unsigned int GLenum;
+        typedef unsigned int GLuint;
+        typedef int GLint;
+        typedef int GLsizei;
+        typedef unsigned char GLboolean;
+        typedef unsigned char GLubyte;
+        typedef unsigned int GLbitfield;
+        typedef float GLfloat;
+        typedef char GLchar;
+        typedef ptrdiff_t GLsizeiptr;
+        typedef ptrdiff_t GLintptr;
+        typedef unsigned long long GLuint64;
+        typedef struct __GLsync* GLsync;
+
+        static const GLenum GL_ZERO = 0;
+        static const GLenum GL_ONE = 1;
+        static const GLenum GL_LINES = 0x0001;
+        static const GLenum GL_LINE_STRIP = 0x0003;
+        static const GLenum GL_TRIANGLES = 0x0004;
+        static const GLenum GL_TRIANGLE_STRIP = 0x0005;
+        static const GLenum GL_SRC_ALPHA = 0x0302;
+        static const GLenum GL_ONE_MINUS_SRC_ALPHA = 0x0303;
+        static const GLenum GL_CULL_FACE = 0x0B44;
+        static const GLenum GL_DEPTH_TEST = 0x0B71;
+        static const GLenum GL_STENCIL_TEST = 0x0B90;
+        static const GLenum GL_BLEND = 0x0BE2;
+        static const GLenum GL_SCISSOR_TEST = 0x0C11;
+        static const GLenum GL_UNSIGNED_BYTE = 0x1401;
+        static const GLenum GL_UNSIGNED_SHORT = 0x1403;
+        static const GLenum GL_UNSIGNED_INT = 0x1405;
+        static const GLenum GL_FLOAT = 0x1406;
+        static const GLenum GL_VERSION = 0x1F02;
+        static const GLenum GL_FUNC_ADD = 0x8006;
+        static const GLenum GL_ARRAY_BUFFER = 0x8892;
+        static const GLenum GL_ELEMENT_ARRAY_BUFFER = 0x8893;
+        static const GLenum GL_STREAM_DRAW = 0x88E0;
+        static const GLenum GL_FRAGMENT_SHADER = 0x8B30;
+        static const GLenum GL_VERTEX_SHADER = 0x8B31;
+        static const GLenum GL_COMPILE_STATUS = 0x8B81;
+        static const GLenum GL_LINK_STATUS = 0x8B82;
+        static const GLenum GL_PRIMITIVE_RESTART_FIXED_INDEX = 0x8D69;
+        static const GLenum GL_PRIMITIVE_RESTART = 0x8F9D;
+        static const GLenum GL_SYNC_GPU_COMMANDS_COMPLETE = 0x9117;
+        static const GLenum GL_ALREADY_SIGNALED = 0x911A;
+        static const GLenum GL_CONDITION_SATISFIED = 0x911C;
+        static const GLbitfield GL_MAP_WRITE_BIT = 0x0002;
+        static const GLbitfield GL_MAP_INVALIDATE_BUFFER_BIT = 0x0008;
+        static const GLbitfield GL_MAP_UNSYNCHRONIZED_BIT = 0x0020;
+
+#define VGUI_GL_FUNCTIONS(X) \
+        X(const GLubyte*, GetString, (GLenum name)) \
+        X(void, Enable, (GLenum cap)) \
+        X(void, Disable, (GLenum cap)) \
+        X(void, BlendEquation, (GLenum mode)) \
+        X(void, BlendFuncSeparate, (GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)) \
+        X(GLuint, CreateShader, (GLenum type)) \
+        X(void, ShaderSource, (GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)) \
+        X(void, CompileShader, (GLuint shader)) \
+        X(void, GetShaderiv, (GLuint shader, GLenum pname, GLint* params)) \
+        X(void, DeleteShader, (GLuint shader)) \
+        X(GLuint, CreateProgram, ()) \
+        X(void, AttachShader, (GLuint program, GLuint shader)) \
+        X(void, LinkProgram, (GLuint program)) \
+        X(void, GetProgramiv, (GLuint program, GLenum pname, GLint* params)) \
+        X(void, DeleteProgram, (GLuint program)) \
+        X(void, UseProgram, (GLuint program)) \
+        X(GLint, GetUniformLocation, (GLuint program, const GLchar* name)) \
+        X(void, Uniform4f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)) \
+        X(void, GenVertexArrays, (GLsizei n, GLuint* arrays)) \
+        X(void, DeleteVertexArrays, (GLsizei n, const GLuint* arrays)) \
+        X(void, BindVertexArray, (GLuint array)) \
+        X(void, EnableVertexAttribArray, (GLuint index)) \
+        X(void, VertexAttribPointer, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)) \
+        X(void, VertexAttribDivisor, (GLuint index, GLuint divisor)) \
+        X(void, GenBuffers, (GLsizei n, GLuint* buffers)) \
+        X(void, DeleteBuffers, (GLsizei n, const GLuint* buffers)) \
+        X(void, BindBuffer, (GLenum target, GLuint buffer)) \
+        X(void, BufferData, (GLenum target, GLsizeiptr size, const void* data, GLenum usage)) \
+        X(void*, MapBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)) \
+        X(GLboolean, UnmapBuffer, (GLenum target)) \
+        X(GLsync, FenceSync, (GLenum condition, GLbitfield flags)) \
+        X(GLenum, ClientWaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout)) \
+        X(void, DeleteSync, (GLsync sync)) \
+        X(void, DrawElements, (GLenum mode, GLsizei count, GLenum type, const void* indices)) \
+        X(void, DrawArraysInstanced, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount))
+
+// Entry points only some versions have; nullptr when missing (glPrimitiveRestartIndex is desktop GL only)
+#define VGUI_GL_OPTIONAL_FUNCTIONS(X) \
+        X(void, PrimitiveRestartIndex, (GLuint index))
+
+        struct GLFunctions {
+#define VGUI_GL_DECLARE(ret, name, args) ret (VGUI_GLAPI* name) args;
+            VGUI_GL_FUNCTIONS(VGUI_GL_DECLARE)
+            VGUI_GL_OPTIONAL_FUNCTIONS(VGUI_GL_DECLARE)
+#undef VGUI_GL_DECLARE
+
+            bool Load(GLProcLoader getProcAddress) {
+                bool complete = true;
+#define VGUI_GL_LOAD(ret, name, args) \
+                name = reinterpret_cast<ret (VGUI_GLAPI*) args>(getProcAddress("gl" #name)); \
+                complete = complete && name != nullptr;
+                VGUI_GL_FUNCTIONS(VGUI_GL_LOAD)
+#undef VGUI_GL_LOAD
+#define VGUI_GL_LOAD_OPTIONAL(ret, name, args) \
+                name = reinterpret_cast<ret (VGUI_GLAPI*) args>(getProcAddress("gl" #name));
+                VGUI_GL_OPTIONAL_FUNCTIONS(VGUI_GL_LOAD_OPTIONAL)
+#undef VGUI_GL_LOAD_OPTIONAL
+                return complete;
+            }
+        };
+
+        // GLSL ports of the HLSL in vgui_render_d3d11.cpp. The version line is prepended at
+        // creation: "#version 330 core" on desktop GL, "#version 300 es" on GLES.
+        static const char* vertexShaderSource = R"(
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in vec4 a_Color;
+uniform vec4 u_Projection;  // xy: 2 / width, -2 / height  zw: -1, 1
+out vec4 v_Color;
+void main() {
+    gl_Position = vec4(a_Position * u_Projection.xy + u_Projection.zw, 0.0, 1.0);
+    v_Color = a_Color;
+}
+)";
+
+        static const char* pixelShaderSource = R"(
+in vec4 v_Color;
+out vec4 o_Color;
+void main() {
+    o_Color = v_Color;
+}
+)";
+
+        // Instanced SDF shapes: one Draw::ShapeInstance per instance, expanded to a quad from gl_VertexID
+        static const char* shapeVertexShaderSource = R"(
+layout(location = 0) in vec4 a_Rect;    // x, y, w, h in pixels
+layout(location = 1) in vec3 a_Params;  // corner radius, border width, feather
+layout(location = 2) in vec4 a_Color;
+uniform vec4 u_Projection;
+out vec2 v_Local;                       // pixel position relative to the shape center
+out vec2 v_HalfSize;
+out vec3 v_Params;
+out vec4 v_Color;
+void main() {
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    vec2 halfSize = a_Rect.zw * 0.5;
+    float margin = a_Params.z + 1.0;
+    vec2 local = (corner * 2.0 - 1.0) * (halfSize + margin);
+    gl_Position = vec4((a_Rect.xy + halfSize + local) * u_Projection.xy + u_Projection.zw, 0.0, 1.0);
+    v_Local = local;
+    v_HalfSize = halfSize;
+    v_Params = a_Params;
+    v_Color = a_Color;
+}
+)";
+
+        // Must stay in sync with Draw::EvaluateShapeCoverage
+        static const char* shapePixelShaderSource = R"(
+in vec2 v_Local;
+in vec2 v_HalfSize;
+in vec3 v_Params;
+in vec4 v_Color;
+out vec4 o_Color;
+void main() {
+    float radius = v_Params.x;
+    float border = v_Params.y;
+    float feather = v_Params.z;
+    vec2 q = abs(v_Local) - v_HalfSize + radius;
+    float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+    if (border > 0.0) d = abs(d + border * 0.5) - border * 0.5;
+    float coverage = feather > 0.0 ? clamp(0.5 - d / feather, 0.0, 1.0) : (d <= 0.0 ? 1.0 : 0.0);
+    o_Color = vec4(v_Color.rgb, v_Color.a * coverage);
+}
+)";
+
+        // Streaming GL buffer backing an Upload::RingBuffer. GL 3.3 / GLES 3.0 have no persistent
+        // mapping, so every frame maps the buffer with glMapBufferRange: unsynchronized while the
+        // ring writes retired space, invalidated (orphaned) when it falls back to a discard.
+        // Fences are glFenceSync objects polled with a zero timeout.
+        class GLUploadDevice : public Upload::UploadDevice {
+        public:
+            GLUploadDevice(const GLFunctions& gl, GLenum target) : m_GL(gl), m_Target(target) {}
+
+            ~GLUploadDevice() override {
+                Release();
+            }
+
+            bool CreateBuffer(size_t capacity) override {
+                if (!m_Buffer) m_GL.GenBuffers(1, &m_Buffer);
+                if (!m_Buffer) return false;
+
+                m_GL.BindBuffer(m_Target, m_Buffer);
+                m_GL.BufferData(m_Target, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+                m_Capacity = capacity;
+                return true;
+            }
+
+            void* Map(bool discard) override {
+                if (!m_Buffer) return nullptr;
+
+                m_GL.BindBuffer(m_Target, m_Buffer);
+                GLbitfield access = GL_MAP_WRITE_BIT | (discard ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT);
+                return m_GL.MapBufferRange(m_Target, 0, static_cast<GLsizeiptr>(m_Capacity), access);
+            }
+
+            void Unmap() override {
+                m_GL.UnmapBuffer(m_Target);
+            }
+
+            uint64_t SignalFence() override {
+                Fence fence = { ++m_LastFence, m_GL.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) };
+                // Without a sync object the frame is treated as retired immediately
+                if (fence.sync) m_Pending.push_back(fence);
+                else m_CompletedFence = fence.value;
+                return fence.value;
+            }
+
+            uint64_t GetCompletedFence() override {
+                while (!m_Pending.empty()) {
+                    GLenum status = m_GL.ClientWaitSync(m_Pending.front().sync, 0, 0);
+                    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                        break;
+                    m_CompletedFence = m_Pending.front().value;
+                    m_GL.DeleteSync(m_Pending.front().sync);
+                    m_Pending.erase(m_Pending.begin());
+                }
+                return m_CompletedFence;
+            }
+
+            GLuint GetBuffer() const { return m_Buffer; }
+
+            void Release() {
+                if (m_Buffer) { m_GL.DeleteBuffers(1, &m_Buffer); m_Buffer = 0; }
+                for (auto& fence : m_Pending) m_GL.DeleteSync(fence.sync);
+                m_Pending.clear();
+                m_Capacity = 0;
+            }
+
+        private:
+            struct Fence {
+                uint64_t value;
+                GLsync sync;
+            };
+
+            const GLFunctions& m_GL;
+            GLenum m_Target;
+            GLuint m_Buffer = 0;
+            size_t m_Capacity = 0;
+            uint64_t m_LastFence = 0;
+            uint64_t m_CompletedFence = 0;
+            std::vector<Fence> m_Pending;
+        };
+
+        // Copies a CPU stream into its ring, empty streams map nothing
+        template <typename T>
+        static bool CopyToRing(Upload::RingBuffer& ring, const T* data, size_t count, size_t& outOffset) {
+            outOffset = 0;
+            if (count == 0) return true;
+
+            size_t bytes = sizeof(T) * count;
+            void* dst = ring.Map(bytes, sizeof(T), outOffset);
+            if (!dst) return false;
+            memcpy(dst, data, bytes);
+            ring.Unmap();
+            return true;
+        }
+
+        static const void* BufferOffset(size_t offset) {
+            return reinterpret_cast<const void*>(static_cast<uintptr_t>(offset));
+        }
+
+        // Owns the GL programs, vertex arrays and the vertex, index and instance rings
+        class GLBackend : public RenderBackend {
+        public:
+            explicit GLBackend(const GLFunctions& gl)
+                : m_GL(gl),
+                m_VertexUpload(m_GL, GL_ARRAY_BUFFER),
+                m_IndexUpload(m_GL, GL_ELEMENT_ARRAY_BUFFER),
+                m_InstanceUpload(m_GL, GL_ARRAY_BUFFER),
+                m_VertexRing(&m_VertexUpload), m_IndexRing(&m_IndexUpload), m_InstanceRing(&m_InstanceUpload) {
+            }
+
+            ~GLBackend() override {
+                ReleaseResources();
+                if (m_Program) m_GL.DeleteProgram(m_Program);
+                if (m_ShapeProgram) m_GL.DeleteProgram(m_ShapeProgram);
+                if (m_VertexArray) m_GL.DeleteVertexArrays(1, &m_VertexArray);
+                if (m_ShapeVertexArray) m_GL.DeleteVertexArrays(1, &m_ShapeVertexArray);
+            }
+
+            bool CreatePipeline() {
+                const char* version = reinterpret_cast<const char*>(m_GL.GetString(GL_VERSION));
+                bool es = version && strstr(version, "OpenGL ES") != nullptr;
+                const char* header = es ? "#version 300 es\nprecision highp float;\n" : "#version 330 core\n";
+
+                // GLES 3.0 and GL 4.3+ restart 16-bit strips at the fixed index 0xFFFF. Desktop GL 3.3 - 4.2
+                // (macOS stops at 4.1) only has the GL 3.1 restart with an explicit index.
+                int major = 0, minor = 0;
+                if (version && !es && sscanf(version, "%d.%d", &major, &minor) != 2) major = minor = 0;
+                m_FixedIndexRestart = es || major > 4 || (major == 4 && minor >= 3);
+                if (!m_FixedIndexRestart && !m_GL.PrimitiveRestartIndex) return false;
+
+                m_Program = LinkProgram(header, vertexShaderSource, pixelShaderSource);
+                m_ShapeProgram = LinkProgram(header, shapeVertexShaderSource, shapePixelShaderSource);
+                if (!m_Program || !m_ShapeProgram) return false;
+                m_ProjectionLocation = m_GL.GetUniformLocation(m_Program, "u_Projection");
+                m_ShapeProjectionLocation = m_GL.GetUniformLocation(m_ShapeProgram, "u_Projection");
+
+                // Attribute pointers are set per draw, the arrays only record which ones are enabled
+                m_GL.GenVertexArrays(1, &m_VertexArray);
+                m_GL.BindVertexArray(m_VertexArray);
+                m_GL.EnableVertexAttribArray(0);
+                m_GL.EnableVertexAttribArray(1);
+
+                m_GL.GenVertexArrays(1, &m_ShapeVertexArray);
+                m_GL.BindVertexArray(m_ShapeVertexArray);
+                for (GLuint i = 0; i < 3; i++) {
+                    m_GL.EnableVertexAttribArray(i);
+                    m_GL.VertexAttribDivisor(i, 1);
+                }
+                m_GL.BindVertexArray(0);
+                return m_VertexArray && m_ShapeVertexArray;
+            }
+
+            bool Upload(const DrawData& data, int displayWidth, int displayHeight) override {
+                // The index ring binds GL_ELEMENT_ARRAY_BUFFER, which is vertex array state
+                m_GL.BindVertexArray(m_VertexArray);
+
+                // Stream vertices, indices and shape instances into the rings
+                bool uploaded = CopyToRing(m_VertexRing, data.vertices, data.vertexCount, m_VertexOffset) &&
+                    CopyToRing(m_IndexRing, data.indices, data.indexCount, m_IndexOffset) &&
+                    CopyToRing(m_InstanceRing, data.instances, data.instanceCount, m_InstanceOffset);
+                if (!uploaded) return false;
+                if (data.indexCount > 0) m_GL.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexUpload.GetBuffer());
+
+                // Pixel -> NDC projection for the current display size
+                float sx = 2.0f / static_cast<float>(displayWidth > 0 ? displayWidth : 1);
+                float sy = -2.0f / static_cast<float>(displayHeight > 0 ? displayHeight : 1);
+                m_GL.UseProgram(m_ShapeProgram);
+                m_GL.Uniform4f(m_ShapeProjectionLocation, sx, sy, -1.0f, 1.0f);
+                m_GL.UseProgram(m_Program);
+                m_GL.Uniform4f(m_ProjectionLocation, sx, sy, -1.0f, 1.0f);
+
+                // Shared pipeline state, matching the D3D11 blend and rasterizer states
+                m_GL.Enable(GL_BLEND);
+                m_GL.BlendEquation(GL_FUNC_ADD);
+                m_GL.BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
+                m_GL.Disable(GL_CULL_FACE);
+                m_GL.Disable(GL_DEPTH_TEST);
+                m_GL.Disable(GL_STENCIL_TEST);
+                m_GL.Disable(GL_SCISSOR_TEST);
+                // Strips end with Draw::StripRestartIndex, the fixed restart index of 16-bit indices
+                if (m_FixedIndexRestart) {
+                    m_GL.Enable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+                }
+                else {
+                    m_GL.Enable(GL_PRIMITIVE_RESTART);
+                    m_GL.PrimitiveRestartIndex(StripRestartIndex);
+                }
+
+                m_PipelineBound = false;
+                return true;
+            }
+
+            void BindPipeline(DrawCommandType type) override {
+                // Programs and vertex arrays only switch between shapes and plain vertices
+                bool shapes = type == DrawCommandType::Shapes;
+                if (!m_PipelineBound || shapes != m_ShapesBound) {
+                    m_PipelineBound = true;
+                    m_ShapesBound = shapes;
+                    m_GL.BindVertexArray(shapes ? m_ShapeVertexArray : m_VertexArray);
+                    m_GL.UseProgram(shapes ? m_ShapeProgram : m_Program);
+                    m_GL.BindBuffer(GL_ARRAY_BUFFER, shapes ? m_InstanceUpload.GetBuffer() : m_VertexUpload.GetBuffer());
+                    m_BoundOffset = SIZE_MAX;
+                }
+
+                switch (type) {
+                case DrawCommandType::Lines: m_Mode = GL_LINES; break;
+                case DrawCommandType::Triangles: m_Mode = GL_TRIANGLES; break;
+                case DrawCommandType::TriangleStrip: m_Mode = GL_TRIANGLE_STRIP; break;
+                case DrawCommandType::Shapes: m_Mode = GL_TRIANGLE_STRIP; break;
+                case DrawCommandType::LineStrip: m_Mode = GL_LINE_STRIP; break;
+                }
+            }
+
+            void Submit(const DrawCommand& cmd) override {
+                // GLES 3.0 has neither base vertex nor base instance draws, so the command's window
+                // is applied by moving the attribute pointers
+                if (cmd.type == DrawCommandType::Shapes) {
+                    size_t offset = m_InstanceOffset + cmd.indexStart * sizeof(ShapeInstance);
+                    if (offset != m_BoundOffset) {
+                        m_BoundOffset = offset;
+                        const GLsizei stride = sizeof(ShapeInstance);
+                        m_GL.VertexAttribPointer(0, 4, GL_FLOAT, 0, stride, BufferOffset(offset));
+                        m_GL.VertexAttribPointer(1, 3, GL_FLOAT, 0, stride, BufferOffset(offset + 16));
+                        SetColorPointer(2, stride, offset + 28);
+                    }
+                    // 4-vertex strip per instance, corners come from gl_VertexID
+                    m_GL.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(cmd.indexCount));
+                }
+                else {
+                    size_t offset = m_VertexOffset + cmd.vertexStart * sizeof(Vertex);
+                    if (offset != m_BoundOffset) {
+                        m_BoundOffset = offset;
+                        const GLsizei stride = sizeof(Vertex);
+                        m_GL.VertexAttribPointer(0, 2, GL_FLOAT, 0, stride, BufferOffset(offset));
+                        SetColorPointer(1, stride, offset + 8);
+                    }
+                    m_GL.DrawElements(m_Mode, static_cast<GLsizei>(cmd.indexCount),
+                        sizeof(DrawIndex) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                        BufferOffset(m_IndexOffset + cmd.indexStart * sizeof(DrawIndex)));
+                }
+            }
+
+            void EndFrame() override {
+                m_GL.BindVertexArray(0);
+                m_VertexRing.EndFrame();
+                m_IndexRing.EndFrame();
+                m_InstanceRing.EndFrame();
+            }
+
+            void ReleaseResources() override {
+                m_VertexUpload.Release();
+                m_IndexUpload.Release();
+                m_InstanceUpload.Release();
+                m_VertexRing.Reset();
+                m_IndexRing.Reset();
+                m_InstanceRing.Reset();
+            }
+
+            const Upload::RingStats* GetUploadStats(UploadStream stream) const override {
+                switch (stream) {
+                case UploadStream::Vertices: return &m_VertexRing.GetStats();
+                case UploadStream::Indices: return &m_IndexRing.GetStats();
+                case UploadStream::Instances: return &m_InstanceRing.GetStats();
+                }
+                return nullptr;
+            }
+
+        private:
+            GLuint CompileShader(GLenum type, const char* header, const char* source) {
+                GLuint shader = m_GL.CreateShader(type);
+                const GLchar* sources[2] = { header, source };
+                m_GL.ShaderSource(shader, 2, sources, nullptr);
+                m_GL.CompileShader(shader);
+
+                GLint status = 0;
+                m_GL.GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+                if (!status) {
+                    m_GL.DeleteShader(shader);
+                    return 0;
+                }
+                return shader;
+            }
+
+            GLuint LinkProgram(const char* header, const char* vertexSource, const char* pixelSource) {
+                GLuint vs = CompileShader(GL_VERTEX_SHADER, header, vertexSource);
+                GLuint ps = CompileShader(GL_FRAGMENT_SHADER, header, pixelSource);
+                GLuint program = 0;
+                if (vs && ps) {
+                    program = m_GL.CreateProgram();
+                    m_GL.AttachShader(program, vs);
+                    m_GL.AttachShader(program, ps);
+                    m_GL.LinkProgram(program);
+
+                    GLint status = 0;
+                    m_GL.GetProgramiv(program, GL_LINK_STATUS, &status);
+                    if (!status) {
+                        m_GL.DeleteProgram(program);
+                        program = 0;
+                    }
+                }
+                // Flagged shaders are freed with the program
+                if (vs) m_GL.DeleteShader(vs);
+                if (ps) m_GL.DeleteShader(ps);
+                return program;
+            }
+
+            void SetColorPointer(GLuint index, GLsizei stride, size_t offset) {
+#ifdef VGUI_VERTEX_FLOAT_COLOR
+                m_GL.VertexAttribPointer(index, 4, GL_FLOAT, 0, stride, BufferOffset(offset));
+#else
+                // Packed RGBA8, red in the lowest byte: normalized bytes in memory order
+                m_GL.VertexAttribPointer(index, 4, GL_UNSIGNED_BYTE, 1, stride, BufferOffset(offset));
+#endif
+            }
+
+            GLFunctions m_GL;
+            GLUploadDevice m_VertexUpload;
+            GLUploadDevice m_IndexUpload;
+            GLUploadDevice m_InstanceUpload;
+            Upload::RingBuffer m_VertexRing;
+            Upload::RingBuffer m_IndexRing;
+            Upload::RingBuffer m_InstanceRing;
+
+            GLuint m_Program = 0;
+            GLuint m_ShapeProgram = 0;
+            GLint m_ProjectionLocation = -1;
+            GLint m_ShapeProjectionLocation = -1;
+            GLuint m_VertexArray = 0;
+            GLuint m_ShapeVertexArray = 0;
+
+            size_t m_VertexOffset = 0;
+            size_t m_IndexOffset = 0;
+            size_t m_InstanceOffset = 0;
+            size_t m_BoundOffset = SIZE_MAX;    // attribute pointer base of the bound vertex array
+            GLenum m_Mode = GL_TRIANGLES;
+            bool m_PipelineBound = false;
+            bool m_ShapesBound = false;
+            bool m_FixedIndexRestart = true;    // GL_PRIMITIVE_RESTART_FIXED_INDEX, else GL_PRIMITIVE_RESTART
+        };
+
+        RenderBackend* CreateGLBackend(GLProcLoader getProcAddress) {
+            GLFunctions gl;
+            if (!getProcAddress || !gl.Load(getProcAddress)) return nullptr;
+
+            GLBackend* backend = new GLBackend(gl);
+            if (!backend->CreatePipeline()) {
+                delete backend;
+                return nullptr;
+            }
+            return backend;
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "vgui_render.h"
+
+namespace VGUI {
+    namespace Draw {
+        typedef void (*GLProc)();
+        typedef GLProc (*GLProcLoader)(const char* name);
+
+        // OpenGL 3.3 core / OpenGL ES 3.0 backend, for hosts without D3D11 (Linux tools, headless
+        // EGL on Mesa llvmpipe). Needs a current context on the calling thread; GLSL 330 or 300 es
+        // is picked from GL_VERSION. Entry points, including the GL 1.x ones, come from
+        // getProcAddress (eglGetProcAddress, glfwGetProcAddress, SDL_GL_GetProcAddress...).
+        // The host binds the target framebuffer and sets the viewport, as with D3D11.
+        // The caller owns the returned backend and deletes it with the context current; nullptr
+        // when an entry point is missing or the shaders fail to build.
+        RenderBackend* CreateGLBackend(GLProcLoader getProcAddress);
+    }
+}
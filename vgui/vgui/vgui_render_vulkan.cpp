@@ -0,0 +1,700 @@
+#ifndef VK_NO_PROTOTYPES
+#define VK_NO_PROTOTYPES
+#endif
+#include "vgui_render_vulkan.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace VGUI {
+    namespace Draw {
+#define VGUI_VK_DEVICE_FUNCTIONS(X) \
+        X(CreateBuffer) \
+        X(DestroyBuffer) \
+        X(GetBufferMemoryRequirements) \
+        X(AllocateMemory) \
+        X(FreeMemory) \
+        X(BindBufferMemory) \
+        X(MapMemory) \
+        X(UnmapMemory) \
+        X(CreateShaderModule) \
+        X(DestroyShaderModule) \
+        X(CreatePipelineLayout) \
+        X(DestroyPipelineLayout) \
+        X(CreateGraphicsPipelines) \
+        X(DestroyPipeline) \
+        X(CreateCommandPool) \
+        X(DestroyCommandPool) \
+        X(ResetCommandPool) \
+        X(AllocateCommandBuffers) \
+        X(BeginCommandBuffer) \
+        X(EndCommandBuffer) \
+        X(CmdBindPipeline) \
+        X(CmdSetViewport) \
+        X(CmdSetScissor) \
+        X(CmdPushConstants) \
+        X(CmdBindIndexBuffer) \
+        X(CmdBindVertexBuffers) \
+        X(CmdDraw) \
+        X(CmdDrawIndexed) \
+        X(CmdExecuteCommands)
+
+        struct VulkanFunctions {
+            PFN_vkGetPhysicalDeviceMemoryProperties GetPhysicalDeviceMemoryProperties;
+#define VGUI_VK_DECLARE(name) PFN_vk##name name;
+            VGUI_VK_DEVICE_FUNCTIONS(VGUI_VK_DECLARE)
+#undef VGUI_VK_DECLARE
+
+            bool Load(PFN_vkGetInstanceProcAddr getInstanceProcAddr, VkInstance instance, VkDevice device) {
+                PFN_vkGetDeviceProcAddr getDeviceProcAddr =
+                    reinterpret_cast<PFN_vkGetDeviceProcAddr>(getInstanceProcAddr(instance, "vkGetDeviceProcAddr"));
+                GetPhysicalDeviceMemoryProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties>(
+                    getInstanceProcAddr(instance, "vkGetPhysicalDeviceMemoryProperties"));
+                if (!getDeviceProcAddr || !GetPhysicalDeviceMemoryProperties) return false;
+
+                bool complete = true;
+#define VGUI_VK_LOAD(name) \
+                name = reinterpret_cast<PFN_vk##name>(getDeviceProcAddr(device, "vk" #name)); \
+                complete = complete && name != nullptr;
+                VGUI_VK_DEVICE_FUNCTIONS(VGUI_VK_LOAD)
+#undef VGUI_VK_LOAD
+                return complete;
+            }
+        };
+
+        // SPIR-V 1.0 modules of the GLSL 450 below: the shaders of vgui_render_gl.cpp with the projection
+        // in a push constant block. Vulkan's clip space has y pointing down, so the projection is
+        // (2 / width, 2 / height, -1, -1). Rebuild with glslangValidator -V --vn <name> after editing.
+        //
+        // layout(location = 0) in vec2 a_Position;
+        // layout(location = 1) in vec4 a_Color;
+        // layout(push_constant) uniform Projection { vec4 u_Projection; };
+        // layout(location = 0) out vec4 v_Color;
+        // void main() {
+        //     gl_Position = vec4(a_Position * u_Projection.xy + u_Projection.zw, 0.0, 1.0);
+        //     v_Color = a_Color;
+        // }
+        static const uint32_t vertexShaderSpirv[] = {
+            0x07230203, 0x00010000, 0x00000000, 0x00000025, 0x00000000, 0x00020011, 0x00000001, 0x0006000b,
+            0x00000001, 0x4c534c47, 0x6474732e, 0x3035342e, 0x00000000, 0x0003000e, 0x00000000, 0x00000001,
+            0x0009000f, 0x00000000, 0x00000002, 0x6e69616d, 0x00000000, 0x00000003, 0x00000004, 0x00000005,
+            0x00000006, 0x00040047, 0x00000003, 0x0000001e, 0x00000000, 0x00040047, 0x00000004, 0x0000001e,
+            0x00000001, 0x00040047, 0x00000006, 0x0000001e, 0x00000000, 0x00040047, 0x00000005, 0x0000000b,
+            0x00000000, 0x00030047, 0x00000007, 0x00000002, 0x00050048, 0x00000007, 0x00000000, 0x00000023,
+            0x00000000, 0x00020013, 0x00000008, 0x00030021, 0x00000009, 0x00000008, 0x00030016, 0x0000000a,
+            0x00000020, 0x00040015, 0x0000000b, 0x00000020, 0x00000001, 0x00040017, 0x0000000c, 0x0000000a,
+            0x00000002, 0x00040017, 0x0000000d, 0x0000000a, 0x00000003, 0x00040017, 0x0000000e, 0x0000000a,
+            0x00000004, 0x0004002b, 0x0000000b, 0x0000000f, 0x00000000, 0x0004002b, 0x0000000b, 0x00000010,
+            0x00000001, 0x0004002b, 0x0000000a, 0x00000011, 0x00000000, 0x0004002b, 0x0000000a, 0x00000012,
+            0x3f800000, 0x0003001e, 0x00000007, 0x0000000e, 0x00040020, 0x00000013, 0x00000009, 0x00000007,
+            0x00040020, 0x00000014, 0x00000009, 0x0000000e, 0x0004003b, 0x00000013, 0x00000015, 0x00000009,
+            0x00040020, 0x00000016, 0x00000001, 0x0000000c, 0x00040020, 0x00000017, 0x00000001, 0x0000000e,
+            0x00040020, 0x00000018, 0x00000003, 0x0000000e, 0x0004003b, 0x00000016, 0x00000003, 0x00000001,
+            0x0004003b, 0x00000017, 0x00000004, 0x00000001, 0x0004003b, 0x00000018, 0x00000005, 0x00000003,
+            0x0004003b, 0x00000018, 0x00000006, 0x00000003, 0x00050036, 0x00000008, 0x00000002, 0x00000000,
+            0x00000009, 0x000200f8, 0x00000019, 0x00050041, 0x00000014, 0x0000001a, 0x00000015, 0x0000000f,
+            0x0004003d, 0x0000000e, 0x0000001b, 0x0000001a, 0x0007004f, 0x0000000c, 0x0000001c, 0x0000001b,
+            0x0000001b, 0x00000000, 0x00000001, 0x0007004f, 0x0000000c, 0x0000001d, 0x0000001b, 0x0000001b,
+            0x00000002, 0x00000003, 0x0004003d, 0x0000000c, 0x0000001e, 0x00000003, 0x00050085, 0x0000000c,
+            0x0000001f, 0x0000001e, 0x0000001c, 0x00050081, 0x0000000c, 0x00000020, 0x0000001f, 0x0000001d,
+            0x00050051, 0x0000000a, 0x00000021, 0x00000020, 0x00000000, 0x00050051, 0x0000000a, 0x00000022,
+            0x00000020, 0x00000001, 0x00070050, 0x0000000e, 0x00000023, 0x00000021, 0x00000022, 0x00000011,
+            0x00000012, 0x0003003e, 0x00000005, 0x00000023, 0x0004003d, 0x0000000e, 0x00000024, 0x00000004,
+            0x0003003e, 0x00000006, 0x00000024, 0x000100fd, 0x00010038,
+        };
+
+        // layout(location = 0) in vec4 v_Color;
+        // layout(location = 0) out vec4 o_Color;
+        // void main() {
+        //     o_Color = v_Color;
+        // }
+        static const uint32_t pixelShaderSpirv[] = {
+            0x07230203, 0x00010000, 0x00000000, 0x0000000d, 0x00000000, 0x00020011, 0x00000001, 0x0006000b,
+            0x00000001, 0x4c534c47, 0x6474732e, 0x3035342e, 0x00000000, 0x0003000e, 0x00000000, 0x00000001,
+            0x0007000f, 0x00000004, 0x00000002, 0x6e69616d, 0x00000000, 0x00000003, 0x00000004, 0x00030010,
+            0x00000002, 0x00000007, 0x00040047, 0x00000003, 0x0000001e, 0x00000000, 0x00040047, 0x00000004,
+            0x0000001e, 0x00000000, 0x00020013, 0x00000005, 0x00030021, 0x00000006, 0x00000005, 0x00030016,
+            0x00000007, 0x00000020, 0x00040017, 0x00000008, 0x00000007, 0x00000004, 0x00040020, 0x00000009,
+            0x00000001, 0x00000008, 0x00040020, 0x0000000a, 0x00000003, 0x00000008, 0x0004003b, 0x00000009,
+            0x00000003, 0x00000001, 0x0004003b, 0x0000000a, 0x00000004, 0x00000003, 0x00050036, 0x00000005,
+            0x00000002, 0x00000000, 0x00000006, 0x000200f8, 0x0000000b, 0x0004003d, 0x00000008, 0x0000000c,
+            0x00000003, 0x0003003e, 0x00000004, 0x0000000c, 0x000100fd, 0x00010038,
+        };
+
+        // Instanced SDF shapes: one Draw::ShapeInstance per instance, expanded to a quad from gl_VertexIndex
+        //
+        // layout(location = 0) in vec4 a_Rect;    // x, y, w, h in pixels
+        // layout(location = 1) in vec3 a_Params;  // corner radius, border width, feather
+        // layout(location = 2) in vec4 a_Color;
+        // layout(push_constant) uniform Projection { vec4 u_Projection; };
+        // layout(location = 0) out vec2 v_Local;  // pixel position relative to the shape center
+        // layout(location = 1) out vec2 v_HalfSize;
+        // layout(location = 2) out vec3 v_Params;
+        // layout(location = 3) out vec4 v_Color;
+        // void main() {
+        //     vec2 corner = vec2(float(gl_VertexIndex & 1), float(gl_VertexIndex >> 1));
+        //     vec2 halfSize = a_Rect.zw * 0.5;
+        //     float margin = a_Params.z + 1.0;
+        //     vec2 local = (corner * 2.0 - 1.0) * (halfSize + margin);
+        //     gl_Position = vec4((a_Rect.xy + halfSize + local) * u_Projection.xy + u_Projection.zw, 0.0, 1.0);
+        //     v_Local = local;
+        //     v_HalfSize = halfSize;
+        //     v_Params = a_Params;
+        //     v_Color = a_Color;
+        // }
+        static const uint32_t shapeVertexShaderSpirv[] = {
+            0x07230203, 0x00010000, 0x00000000, 0x00000043, 0x00000000, 0x00020011, 0x00000001, 0x0006000b,
+            0x00000001, 0x4c534c47, 0x6474732e, 0x3035342e, 0x00000000, 0x0003000e, 0x00000000, 0x00000001,
+            0x000e000f, 0x00000000, 0x00000002, 0x6e69616d, 0x00000000, 0x00000003, 0x00000004, 0x00000005,
+            0x00000006, 0x00000007, 0x00000008, 0x00000009, 0x0000000a, 0x0000000b, 0x00040047, 0x00000003,
+            0x0000001e, 0x00000000, 0x00040047, 0x00000004, 0x0000001e, 0x00000001, 0x00040047, 0x00000005,
+            0x0000001e, 0x00000002, 0x00040047, 0x00000008, 0x0000001e, 0x00000000, 0x00040047, 0x00000009,
+            0x0000001e, 0x00000001, 0x00040047, 0x0000000a, 0x0000001e, 0x00000002, 0x00040047, 0x0000000b,
+            0x0000001e, 0x00000003, 0x00040047, 0x00000006, 0x0000000b, 0x0000002a, 0x00040047, 0x00000007,
+            0x0000000b, 0x00000000, 0x00030047, 0x0000000c, 0x00000002, 0x00050048, 0x0000000c, 0x00000000,
+            0x00000023, 0x00000000, 0x00020013, 0x0000000d, 0x00030021, 0x0000000e, 0x0000000d, 0x00030016,
+            0x0000000f, 0x00000020, 0x00040015, 0x00000010, 0x00000020, 0x00000001, 0x00040017, 0x00000011,
+            0x0000000f, 0x00000002, 0x00040017, 0x00000012, 0x0000000f, 0x00000003, 0x00040017, 0x00000013,
+            0x0000000f, 0x00000004, 0x0004002b, 0x00000010, 0x00000014, 0x00000000, 0x0004002b, 0x00000010,
+            0x00000015, 0x00000001, 0x0004002b, 0x0000000f, 0x00000016, 0x00000000, 0x0004002b, 0x0000000f,
+            0x00000017, 0x3f800000, 0x0003001e, 0x0000000c, 0x00000013, 0x00040020, 0x00000018, 0x00000009,
+            0x0000000c, 0x00040020, 0x00000019, 0x00000009, 0x00000013, 0x0004003b, 0x00000018, 0x0000001a,
+            0x00000009, 0x0004002b, 0x0000000f, 0x0000001b, 0x3f000000, 0x0004002b, 0x0000000f, 0x0000001c,
+            0x40000000, 0x00040020, 0x0000001d, 0x00000001, 0x00000010, 0x00040020, 0x0000001e, 0x00000001,
+            0x00000012, 0x00040020, 0x0000001f, 0x00000001, 0x00000013, 0x00040020, 0x00000020, 0x00000003,
+            0x00000011, 0x00040020, 0x00000021, 0x00000003, 0x00000012, 0x00040020, 0x00000022, 0x00000003,
+            0x00000013, 0x0004003b, 0x0000001f, 0x00000003, 0x00000001, 0x0004003b, 0x0000001e, 0x00000004,
+            0x00000001, 0x0004003b, 0x0000001f, 0x00000005, 0x00000001, 0x0004003b, 0x0000001d, 0x00000006,
+            0x00000001, 0x0004003b, 0x00000022, 0x00000007, 0x00000003, 0x0004003b, 0x00000020, 0x00000008,
+            0x00000003, 0x0004003b, 0x00000020, 0x00000009, 0x00000003, 0x0004003b, 0x00000021, 0x0000000a,
+            0x00000003, 0x0004003b, 0x00000022, 0x0000000b, 0x00000003, 0x00050036, 0x0000000d, 0x00000002,
+            0x00000000, 0x0000000e, 0x000200f8, 0x00000023, 0x00050041, 0x00000019, 0x00000024, 0x0000001a,
+            0x00000014, 0x0004003d, 0x00000013, 0x00000025, 0x00000024, 0x0007004f, 0x00000011, 0x00000026,
+            0x00000025, 0x00000025, 0x00000000, 0x00000001, 0x0007004f, 0x00000011, 0x00000027, 0x00000025,
+            0x00000025, 0x00000002, 0x00000003, 0x0004003d, 0x00000010, 0x00000028, 0x00000006, 0x000500c7,
+            0x00000010, 0x00000029, 0x00000028, 0x00000015, 0x000500c3, 0x00000010, 0x0000002a, 0x00000028,
+            0x00000015, 0x0004006f, 0x0000000f, 0x0000002b, 0x00000029, 0x0004006f, 0x0000000f, 0x0000002c,
+            0x0000002a, 0x00050050, 0x00000011, 0x0000002d, 0x0000002b, 0x0000002c, 0x0004003d, 0x00000013,
+            0x0000002e, 0x00000003, 0x0004003d, 0x00000012, 0x0000002f, 0x00000004, 0x0007004f, 0x00000011,
+            0x00000030, 0x0000002e, 0x0000002e, 0x00000002, 0x00000003, 0x0005008e, 0x00000011, 0x00000031,
+            0x00000030, 0x0000001b, 0x00050051, 0x0000000f, 0x00000032, 0x0000002f, 0x00000002, 0x00050081,
+            0x0000000f, 0x00000033, 0x00000032, 0x00000017, 0x0005008e, 0x00000011, 0x00000034, 0x0000002d,
+            0x0000001c, 0x00050050, 0x00000011, 0x00000035, 0x00000017, 0x00000017, 0x00050083, 0x00000011,
+            0x00000036, 0x00000034, 0x00000035, 0x00050050, 0x00000011, 0x00000037, 0x00000033, 0x00000033,
+            0x00050081, 0x00000011, 0x00000038, 0x00000031, 0x00000037, 0x00050085, 0x00000011, 0x00000039,
+            0x00000036, 0x00000038, 0x0007004f, 0x00000011, 0x0000003a, 0x0000002e, 0x0000002e, 0x00000000,
+            0x00000001, 0x00050081, 0x00000011, 0x0000003b, 0x0000003a, 0x00000031, 0x00050081, 0x00000011,
+            0x0000003c, 0x0000003b, 0x00000039, 0x00050085, 0x00000011, 0x0000003d, 0x0000003c, 0x00000026,
+            0x00050081, 0x00000011, 0x0000003e, 0x0000003d, 0x00000027, 0x00050051, 0x0000000f, 0x0000003f,
+            0x0000003e, 0x00000000, 0x00050051, 0x0000000f, 0x00000040, 0x0000003e, 0x00000001, 0x00070050,
+            0x00000013, 0x00000041, 0x0000003f, 0x00000040, 0x00000016, 0x00000017, 0x0003003e, 0x00000007,
+            0x00000041, 0x0003003e, 0x00000008, 0x00000039, 0x0003003e, 0x00000009, 0x00000031, 0x0003003e,
+            0x0000000a, 0x0000002f, 0x0004003d, 0x00000013, 0x00000042, 0x00000005, 0x0003003e, 0x0000000b,
+            0x00000042, 0x000100fd, 0x00010038,
+        };
+
+        // Must stay in sync with Draw::EvaluateShapeCoverage
+        //
+        // layout(location = 0) in vec2 v_Local;
+        // layout(location = 1) in vec2 v_HalfSize;
+        // layout(location = 2) in vec3 v_Params;
+        // layout(location = 3) in vec4 v_Color;
+        // layout(location = 0) out vec4 o_Color;
+        // void main() {
+        //     float radius = v_Params.x;
+        //     float border = v_Params.y;
+        //     float feather = v_Params.z;
+        //     vec2 q = abs(v_Local) - v_HalfSize + radius;
+        //     float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+        //     d = border > 0.0 ? abs(d + border * 0.5) - border * 0.5 : d;
+        //     float coverage = feather > 0.0 ? clamp(0.5 - d / feather, 0.0, 1.0) : (d <= 0.0 ? 1.0 : 0.0);
+        //     o_Color = vec4(v_Color.rgb, v_Color.a * coverage);
+        // }
+        static const uint32_t shapePixelShaderSpirv[] = {
+            0x07230203, 0x00010000, 0x00000000, 0x0000003e, 0x00000000, 0x00020011, 0x00000001, 0x0006000b,
+            0x00000001, 0x4c534c47, 0x6474732e, 0x3035342e, 0x00000000, 0x0003000e, 0x00000000, 0x00000001,
+            0x000a000f, 0x00000004, 0x00000002, 0x6e69616d, 0x00000000, 0x00000003, 0x00000004, 0x00000005,
+            0x00000006, 0x00000007, 0x00030010, 0x00000002, 0x00000007, 0x00040047, 0x00000003, 0x0000001e,
+            0x00000000, 0x00040047, 0x00000004, 0x0000001e, 0x00000001, 0x00040047, 0x00000005, 0x0000001e,
+            0x00000002, 0x00040047, 0x00000006, 0x0000001e, 0x00000003, 0x00040047, 0x00000007, 0x0000001e,
+            0x00000000, 0x00020013, 0x00000008, 0x00030021, 0x00000009, 0x00000008, 0x00020014, 0x0000000a,
+            0x00030016, 0x0000000b, 0x00000020, 0x00040017, 0x0000000c, 0x0000000b, 0x00000002, 0x00040017,
+            0x0000000d, 0x0000000b, 0x00000003, 0x00040017, 0x0000000e, 0x0000000b, 0x00000004, 0x0004002b,
+            0x0000000b, 0x0000000f, 0x00000000, 0x0004002b, 0x0000000b, 0x00000010, 0x3f800000, 0x0004002b,
+            0x0000000b, 0x00000011, 0x3f000000, 0x00040020, 0x00000012, 0x00000001, 0x0000000c, 0x00040020,
+            0x00000013, 0x00000001, 0x0000000d, 0x00040020, 0x00000014, 0x00000001, 0x0000000e, 0x00040020,
+            0x00000015, 0x00000003, 0x0000000e, 0x0004003b, 0x00000012, 0x00000003, 0x00000001, 0x0004003b,
+            0x00000012, 0x00000004, 0x00000001, 0x0004003b, 0x00000013, 0x00000005, 0x00000001, 0x0004003b,
+            0x00000014, 0x00000006, 0x00000001, 0x0004003b, 0x00000015, 0x00000007, 0x00000003, 0x00050036,
+            0x00000008, 0x00000002, 0x00000000, 0x00000009, 0x000200f8, 0x00000016, 0x0004003d, 0x0000000c,
+            0x00000017, 0x00000003, 0x0004003d, 0x0000000c, 0x00000018, 0x00000004, 0x0004003d, 0x0000000d,
+            0x00000019, 0x00000005, 0x00050051, 0x0000000b, 0x0000001a, 0x00000019, 0x00000000, 0x00050051,
+            0x0000000b, 0x0000001b, 0x00000019, 0x00000001, 0x00050051, 0x0000000b, 0x0000001c, 0x00000019,
+            0x00000002, 0x0006000c, 0x0000000c, 0x0000001d, 0x00000001, 0x00000004, 0x00000017, 0x00050083,
+            0x0000000c, 0x0000001e, 0x0000001d, 0x00000018, 0x00050050, 0x0000000c, 0x0000001f, 0x0000001a,
+            0x0000001a, 0x00050081, 0x0000000c, 0x00000020, 0x0000001e, 0x0000001f, 0x00050050, 0x0000000c,
+            0x00000021, 0x0000000f, 0x0000000f, 0x0007000c, 0x0000000c, 0x00000022, 0x00000001, 0x00000028,
+            0x00000020, 0x00000021, 0x0006000c, 0x0000000b, 0x00000023, 0x00000001, 0x00000042, 0x00000022,
+            0x00050051, 0x0000000b, 0x00000024, 0x00000020, 0x00000000, 0x00050051, 0x0000000b, 0x00000025,
+            0x00000020, 0x00000001, 0x0007000c, 0x0000000b, 0x00000026, 0x00000001, 0x00000028, 0x00000024,
+            0x00000025, 0x0007000c, 0x0000000b, 0x00000027, 0x00000001, 0x00000025, 0x00000026, 0x0000000f,
+            0x00050081, 0x0000000b, 0x00000028, 0x00000023, 0x00000027, 0x00050083, 0x0000000b, 0x00000029,
+            0x00000028, 0x0000001a, 0x00050085, 0x0000000b, 0x0000002a, 0x0000001b, 0x00000011, 0x00050081,
+            0x0000000b, 0x0000002b, 0x00000029, 0x0000002a, 0x0006000c, 0x0000000b, 0x0000002c, 0x00000001,
+            0x00000004, 0x0000002b, 0x00050083, 0x0000000b, 0x0000002d, 0x0000002c, 0x0000002a, 0x000500ba,
+            0x0000000a, 0x0000002e, 0x0000001b, 0x0000000f, 0x000600a9, 0x0000000b, 0x0000002f, 0x0000002e,
+            0x0000002d, 0x00000029, 0x00050088, 0x0000000b, 0x00000030, 0x0000002f, 0x0000001c, 0x00050083,
+            0x0000000b, 0x00000031, 0x00000011, 0x00000030, 0x0008000c, 0x0000000b, 0x00000032, 0x00000001,
+            0x0000002b, 0x00000031, 0x0000000f, 0x00000010, 0x000500bc, 0x0000000a, 0x00000033, 0x0000002f,
+            0x0000000f, 0x000600a9, 0x0000000b, 0x00000034, 0x00000033, 0x00000010, 0x0000000f, 0x000500ba,
+            0x0000000a, 0x00000035, 0x0000001c, 0x0000000f, 0x000600a9, 0x0000000b, 0x00000036, 0x00000035,
+            0x00000032, 0x00000034, 0x0004003d, 0x0000000e, 0x00000037, 0x00000006, 0x00050051, 0x0000000b,
+            0x00000038, 0x00000037, 0x00000003, 0x00050085, 0x0000000b, 0x00000039, 0x00000038, 0x00000036,
+            0x00050051, 0x0000000b, 0x0000003a, 0x00000037, 0x00000000, 0x00050051, 0x0000000b, 0x0000003b,
+            0x00000037, 0x00000001, 0x00050051, 0x0000000b, 0x0000003c, 0x00000037, 0x00000002, 0x00070050,
+            0x0000000e, 0x0000003d, 0x0000003a, 0x0000003b, 0x0000003c, 0x00000039, 0x0003003e, 0x00000007,
+            0x0000003d, 0x000100fd, 0x00010038,
+        };
+#ifdef VGUI_VERTEX_FLOAT_COLOR
+        static const VkFormat g_ColorFormat = VK_FORMAT_R32G32B32A32_SFLOAT;
+#else
+        // Packed RGBA8, red in the lowest byte: normalized bytes in memory order
+        static const VkFormat g_ColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+#endif
+
+        static const VkDeviceSize g_MinArenaSize = 256 * 1024;
+        static const size_t g_PipelineCount = static_cast<size_t>(DrawCommandType::Shapes) + 1;
+
+        static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        // Everything one frame in flight writes: the upload arena its streams are copied to and the
+        // pool its batch command buffers come from. Both are reused once the GPU is done with the frame.
+        struct FrameSlot {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            uint8_t* mapped = nullptr;      // persistently mapped, host coherent
+            VkDeviceSize capacity = 0;
+            VkCommandPool commandPool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> batches;   // secondaries allocated so far, reset with the pool
+            uint32_t batchCount = 0;                // used by the frame being recorded
+        };
+
+        class VulkanBackendImpl : public VulkanBackend {
+        public:
+            VulkanBackendImpl(const VulkanFunctions& vk, const VulkanBackendDesc& desc)
+                : m_VK(vk), m_Device(desc.device), m_RenderPass(desc.renderPass), m_Subpass(desc.subpass),
+                m_Slots(desc.framesInFlight ? desc.framesInFlight : 2) {
+                m_VK.GetPhysicalDeviceMemoryProperties(desc.physicalDevice, &m_MemoryProperties);
+            }
+
+            ~VulkanBackendImpl() override {
+                ReleaseResources();
+                for (FrameSlot& slot : m_Slots) {
+                    if (slot.commandPool) m_VK.DestroyCommandPool(m_Device, slot.commandPool, nullptr);
+                }
+                for (VkPipeline pipeline : m_Pipelines) {
+                    if (pipeline) m_VK.DestroyPipeline(m_Device, pipeline, nullptr);
+                }
+                if (m_PipelineLayout) m_VK.DestroyPipelineLayout(m_Device, m_PipelineLayout, nullptr);
+            }
+
+            bool CreateCommandPools(uint32_t queueFamilyIndex) {
+                VkCommandPoolCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+                info.queueFamilyIndex = queueFamilyIndex;
+                for (FrameSlot& slot : m_Slots) {
+                    if (m_VK.CreateCommandPool(m_Device, &info, nullptr, &slot.commandPool) != VK_SUCCESS) return false;
+                }
+                return true;
+            }
+
+            bool CreatePipelines() {
+                VkPushConstantRange pushConstants = {};
+                pushConstants.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+                pushConstants.size = sizeof(m_Projection);
+
+                VkPipelineLayoutCreateInfo layoutInfo = {};
+                layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+                layoutInfo.pushConstantRangeCount = 1;
+                layoutInfo.pPushConstantRanges = &pushConstants;
+                if (m_VK.CreatePipelineLayout(m_Device, &layoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS) return false;
+
+                VkShaderModule vs = CreateShaderModule(vertexShaderSpirv, sizeof(vertexShaderSpirv));
+                VkShaderModule ps = CreateShaderModule(pixelShaderSpirv, sizeof(pixelShaderSpirv));
+                VkShaderModule shapeVs = CreateShaderModule(shapeVertexShaderSpirv, sizeof(shapeVertexShaderSpirv));
+                VkShaderModule shapePs = CreateShaderModule(shapePixelShaderSpirv, sizeof(shapePixelShaderSpirv));
+                if (vs && ps && shapeVs && shapePs) {
+                    m_Pipelines[static_cast<size_t>(DrawCommandType::Lines)] = CreatePipeline(vs, ps, VK_PRIMITIVE_TOPOLOGY_LINE_LIST, false);
+                    m_Pipelines[static_cast<size_t>(DrawCommandType::Triangles)] = CreatePipeline(vs, ps, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, false);
+                    m_Pipelines[static_cast<size_t>(DrawCommandType::TriangleStrip)] = CreatePipeline(vs, ps, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP, false);
+                    m_Pipelines[static_cast<size_t>(DrawCommandType::LineStrip)] = CreatePipeline(vs, ps, VK_PRIMITIVE_TOPOLOGY_LINE_STRIP, false);
+                    // 4-vertex strip per instance, corners come from gl_VertexIndex
+                    m_Pipelines[static_cast<size_t>(DrawCommandType::Shapes)] = CreatePipeline(shapeVs, shapePs, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP, true);
+                }
+                // Modules are only needed while the pipelines are built
+                if (vs) m_VK.DestroyShaderModule(m_Device, vs, nullptr);
+                if (ps) m_VK.DestroyShaderModule(m_Device, ps, nullptr);
+                if (shapeVs) m_VK.DestroyShaderModule(m_Device, shapeVs, nullptr);
+                if (shapePs) m_VK.DestroyShaderModule(m_Device, shapePs, nullptr);
+
+                for (VkPipeline pipeline : m_Pipelines) {
+                    if (!pipeline) return false;
+                }
+                return true;
+            }
+
+            void BeginFrame(uint64_t frameIndex, VkCommandBuffer commandBuffer, VkFramebuffer framebuffer) override {
+                // The host has waited for this slot's last submission, so its arena and command
+                // buffers are free again
+                m_Slot = &m_Slots[frameIndex % m_Slots.size()];
+                m_VK.ResetCommandPool(m_Device, m_Slot->commandPool, 0);
+                m_Slot->batchCount = 0;
+                m_CommandBuffer = commandBuffer;
+                m_Framebuffer = framebuffer;
+            }
+
+            bool Upload(const DrawData& data, int displayWidth, int displayHeight) override {
+                m_Uploaded = false;
+                if (!m_Slot || !m_CommandBuffer) return false;
+
+                // Vertices, indices and instances share the slot's arena
+                VkDeviceSize vertexBytes = data.vertexCount * sizeof(Vertex);
+                VkDeviceSize indexBytes = data.indexCount * sizeof(DrawIndex);
+                VkDeviceSize instanceBytes = data.instanceCount * sizeof(ShapeInstance);
+                m_IndexOffset = AlignUp(vertexBytes, 4);
+                m_InstanceOffset = AlignUp(m_IndexOffset + indexBytes, 16);
+                VkDeviceSize total = m_InstanceOffset + instanceBytes;
+                if (total == 0) return false;
+                if (total > m_Slot->capacity && !CreateArena(*m_Slot, total)) return false;
+
+                if (vertexBytes) memcpy(m_Slot->mapped, data.vertices, static_cast<size_t>(vertexBytes));
+                if (indexBytes) memcpy(m_Slot->mapped + m_IndexOffset, data.indices, static_cast<size_t>(indexBytes));
+                if (instanceBytes) memcpy(m_Slot->mapped + m_InstanceOffset, data.instances, static_cast<size_t>(instanceBytes));
+                m_HasIndices = indexBytes > 0;
+
+                // Pixel -> NDC projection for the current display size, y down like the pixels
+                uint32_t width = static_cast<uint32_t>(displayWidth > 0 ? displayWidth : 1);
+                uint32_t height = static_cast<uint32_t>(displayHeight > 0 ? displayHeight : 1);
+                m_Projection[0] = 2.0f / static_cast<float>(width);
+                m_Projection[1] = 2.0f / static_cast<float>(height);
+                m_Projection[2] = -1.0f;
+                m_Projection[3] = -1.0f;
+                m_Viewport = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f };
+                m_Scissor = { { 0, 0 }, { width, height } };
+
+                m_Uploaded = true;
+                return true;
+            }
+
+            void BindPipeline(DrawCommandType type) override {
+                // Every batch gets its own secondary command buffer, which starts without any state
+                FinishBatch();
+                if (!m_Uploaded) return;
+                m_Batch = BeginBatch();
+                if (!m_Batch) return;
+
+                bool shapes = type == DrawCommandType::Shapes;
+                m_VK.CmdBindPipeline(m_Batch, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipelines[static_cast<size_t>(type)]);
+                m_VK.CmdSetViewport(m_Batch, 0, 1, &m_Viewport);
+                m_VK.CmdSetScissor(m_Batch, 0, 1, &m_Scissor);
+                m_VK.CmdPushConstants(m_Batch, m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(m_Projection), m_Projection);
+
+                VkDeviceSize offset = shapes ? m_InstanceOffset : 0;
+                m_VK.CmdBindVertexBuffers(m_Batch, 0, 1, &m_Slot->buffer, &offset);
+                if (!shapes && m_HasIndices) {
+                    m_VK.CmdBindIndexBuffer(m_Batch, m_Slot->buffer, m_IndexOffset,
+                        sizeof(DrawIndex) == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+                }
+            }
+
+            void Submit(const DrawCommand& cmd) override {
+                if (!m_Batch) return;
+                if (cmd.type == DrawCommandType::Shapes) {
+                    m_VK.CmdDraw(m_Batch, 4, static_cast<uint32_t>(cmd.indexCount), 0, static_cast<uint32_t>(cmd.indexStart));
+                }
+                else {
+                    m_VK.CmdDrawIndexed(m_Batch, static_cast<uint32_t>(cmd.indexCount), 1, static_cast<uint32_t>(cmd.indexStart),
+                        static_cast<int32_t>(cmd.vertexStart), 0);
+                }
+            }
+
+            void EndFrame() override {
+                FinishBatch();
+                if (m_Slot && m_CommandBuffer && m_Slot->batchCount > 0) {
+                    m_VK.CmdExecuteCommands(m_CommandBuffer, m_Slot->batchCount, m_Slot->batches.data());
+                }
+                // The next frame needs a new BeginFrame()
+                m_CommandBuffer = VK_NULL_HANDLE;
+                m_Framebuffer = VK_NULL_HANDLE;
+                m_Uploaded = false;
+            }
+
+            void ReleaseResources() override {
+                // The host has made the device idle; the next frame recreates its arena
+                for (FrameSlot& slot : m_Slots) {
+                    if (slot.memory) {
+                        m_VK.UnmapMemory(m_Device, slot.memory);
+                        m_VK.FreeMemory(m_Device, slot.memory, nullptr);
+                    }
+                    if (slot.buffer) m_VK.DestroyBuffer(m_Device, slot.buffer, nullptr);
+                    slot.buffer = VK_NULL_HANDLE;
+                    slot.memory = VK_NULL_HANDLE;
+                    slot.mapped = nullptr;
+                    slot.capacity = 0;
+                }
+            }
+
+        private:
+            VkShaderModule CreateShaderModule(const uint32_t* code, size_t size) {
+                VkShaderModuleCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+                info.codeSize = size;
+                info.pCode = code;
+                VkShaderModule module = VK_NULL_HANDLE;
+                if (m_VK.CreateShaderModule(m_Device, &info, nullptr, &module) != VK_SUCCESS) return VK_NULL_HANDLE;
+                return module;
+            }
+
+            VkPipeline CreatePipeline(VkShaderModule vs, VkShaderModule ps, VkPrimitiveTopology topology, bool shapes) {
+                VkPipelineShaderStageCreateInfo stages[2] = {};
+                stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+                stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+                stages[0].module = vs;
+                stages[0].pName = "main";
+                stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+                stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+                stages[1].module = ps;
+                stages[1].pName = "main";
+
+                // Same streams as the D3D11 input layouts
+                VkVertexInputBindingDescription binding = {};
+                VkVertexInputAttributeDescription attributes[3] = {};
+                uint32_t attributeCount;
+                if (shapes) {
+                    binding = { 0, sizeof(ShapeInstance), VK_VERTEX_INPUT_RATE_INSTANCE };
+                    attributes[0] = { 0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(ShapeInstance, x) };
+                    attributes[1] = { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(ShapeInstance, radius) };
+                    attributes[2] = { 2, 0, g_ColorFormat, offsetof(ShapeInstance, col) };
+                    attributeCount = 3;
+                }
+                else {
+                    binding = { 0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX };
+                    attributes[0] = { 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, x) };
+                    attributes[1] = { 1, 0, g_ColorFormat, offsetof(Vertex, col) };
+                    attributeCount = 2;
+                }
+                VkPipelineVertexInputStateCreateInfo vertexInput = {};
+                vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+                vertexInput.vertexBindingDescriptionCount = 1;
+                vertexInput.pVertexBindingDescriptions = &binding;
+                vertexInput.vertexAttributeDescriptionCount = attributeCount;
+                vertexInput.pVertexAttributeDescriptions = attributes;
+
+                VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+                inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+                inputAssembly.topology = topology;
+                // Strips end with Draw::StripRestartIndex (0xFFFF, the restart value of 16-bit indices)
+                inputAssembly.primitiveRestartEnable = (topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP ||
+                    topology == VK_PRIMITIVE_TOPOLOGY_LINE_STRIP) ? VK_TRUE : VK_FALSE;
+
+                // Viewport and scissor follow the display size, so they are dynamic
+                VkPipelineViewportStateCreateInfo viewport = {};
+                viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+                viewport.viewportCount = 1;
+                viewport.scissorCount = 1;
+                const VkDynamicState dynamicStates[2] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+                VkPipelineDynamicStateCreateInfo dynamic = {};
+                dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+                dynamic.dynamicStateCount = 2;
+                dynamic.pDynamicStates = dynamicStates;
+
+                // Matching the D3D11 blend and rasterizer states: no culling, no depth or stencil
+                VkPipelineRasterizationStateCreateInfo rasterizer = {};
+                rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+                rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+                rasterizer.cullMode = VK_CULL_MODE_NONE;
+                rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+                rasterizer.lineWidth = 1.0f;
+
+                VkPipelineMultisampleStateCreateInfo multisample = {};
+                multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+                multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+                VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+                depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+                depthStencil.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+
+                VkPipelineColorBlendAttachmentState blendAttachment = {};
+                blendAttachment.blendEnable = VK_TRUE;
+                blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+                blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+                blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+                blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+                blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+                blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                    VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+                VkPipelineColorBlendStateCreateInfo blend = {};
+                blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+                blend.attachmentCount = 1;
+                blend.pAttachments = &blendAttachment;
+
+                VkGraphicsPipelineCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+                info.stageCount = 2;
+                info.pStages = stages;
+                info.pVertexInputState = &vertexInput;
+                info.pInputAssemblyState = &inputAssembly;
+                info.pViewportState = &viewport;
+                info.pRasterizationState = &rasterizer;
+                info.pMultisampleState = &multisample;
+                info.pDepthStencilState = &depthStencil;
+                info.pColorBlendState = &blend;
+                info.pDynamicState = &dynamic;
+                info.layout = m_PipelineLayout;
+                info.renderPass = m_RenderPass;
+                info.subpass = m_Subpass;
+                info.basePipelineIndex = -1;
+
+                VkPipeline pipeline = VK_NULL_HANDLE;
+                if (m_VK.CreateGraphicsPipelines(m_Device, VK_NULL_HANDLE, 1, &info, nullptr, &pipeline) != VK_SUCCESS) {
+                    return VK_NULL_HANDLE;
+                }
+                return pipeline;
+            }
+
+            // Host-visible memory type, preferring one that is also device local (UMA, resizable BAR)
+            uint32_t FindMemoryType(uint32_t typeBits) const {
+                const VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+                const VkMemoryPropertyFlags preferred[2] = { required | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, required };
+                for (VkMemoryPropertyFlags flags : preferred) {
+                    for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; i++) {
+                        if ((typeBits & (1u << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & flags) == flags) return i;
+                    }
+                }
+                return UINT32_MAX;
+            }
+
+            // (Re)creates a slot's arena with room for at least size bytes. Only called for the slot
+            // being recorded, whose previous frame has retired.
+            bool CreateArena(FrameSlot& slot, VkDeviceSize size) {
+                VkDeviceSize capacity = slot.capacity * 2;
+                if (capacity < size) capacity = size;
+                if (capacity < g_MinArenaSize) capacity = g_MinArenaSize;
+
+                if (slot.memory) {
+                    m_VK.UnmapMemory(m_Device, slot.memory);
+                    m_VK.FreeMemory(m_Device, slot.memory, nullptr);
+                }
+                if (slot.buffer) m_VK.DestroyBuffer(m_Device, slot.buffer, nullptr);
+                slot.buffer = VK_NULL_HANDLE;
+                slot.memory = VK_NULL_HANDLE;
+                slot.mapped = nullptr;
+                slot.capacity = 0;
+
+                VkBufferCreateInfo bufferInfo = {};
+                bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+                bufferInfo.size = capacity;
+                bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+                bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                if (m_VK.CreateBuffer(m_Device, &bufferInfo, nullptr, &slot.buffer) != VK_SUCCESS) {
+                    slot.buffer = VK_NULL_HANDLE;
+                    return false;
+                }
+
+                VkMemoryRequirements requirements;
+                m_VK.GetBufferMemoryRequirements(m_Device, slot.buffer, &requirements);
+                VkMemoryAllocateInfo allocInfo = {};
+                allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                allocInfo.allocationSize = requirements.size;
+                allocInfo.memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits);
+                void* mapped = nullptr;
+                if (allocInfo.memoryTypeIndex == UINT32_MAX ||
+                    m_VK.AllocateMemory(m_Device, &allocInfo, nullptr, &slot.memory) != VK_SUCCESS) {
+                    slot.memory = VK_NULL_HANDLE;
+                    return false;
+                }
+                if (m_VK.BindBufferMemory(m_Device, slot.buffer, slot.memory, 0) != VK_SUCCESS ||
+                    m_VK.MapMemory(m_Device, slot.memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+                    return false;
+                }
+                slot.mapped = static_cast<uint8_t*>(mapped);
+                slot.capacity = capacity;
+                return true;
+            }
+
+            VkCommandBuffer BeginBatch() {
+                FrameSlot& slot = *m_Slot;
+                if (slot.batchCount == slot.batches.size()) {
+                    VkCommandBufferAllocateInfo allocInfo = {};
+                    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                    allocInfo.commandPool = slot.commandPool;
+                    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+                    allocInfo.commandBufferCount = 1;
+                    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+                    if (m_VK.AllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer) != VK_SUCCESS) return VK_NULL_HANDLE;
+                    slot.batches.push_back(commandBuffer);
+                }
+
+                VkCommandBufferInheritanceInfo inheritance = {};
+                inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+                inheritance.renderPass = m_RenderPass;
+                inheritance.subpass = m_Subpass;
+                inheritance.framebuffer = m_Framebuffer;
+                VkCommandBufferBeginInfo beginInfo = {};
+                beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+                beginInfo.pInheritanceInfo = &inheritance;
+
+                VkCommandBuffer commandBuffer = slot.batches[slot.batchCount];
+                if (m_VK.BeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) return VK_NULL_HANDLE;
+                slot.batchCount++;
+                return commandBuffer;
+            }
+
+            void FinishBatch() {
+                if (!m_Batch) return;
+                m_VK.EndCommandBuffer(m_Batch);
+                m_Batch = VK_NULL_HANDLE;
+            }
+
+            VulkanFunctions m_VK;
+            VkDevice m_Device;
+            VkRenderPass m_RenderPass;
+            uint32_t m_Subpass;
+            VkPhysicalDeviceMemoryProperties m_MemoryProperties = {};
+            VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+            VkPipeline m_Pipelines[g_PipelineCount] = {};   // indexed by DrawCommandType
+
+            std::vector<FrameSlot> m_Slots;
+            FrameSlot* m_Slot = nullptr;                    // slot of the frame being recorded
+            VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+            VkFramebuffer m_Framebuffer = VK_NULL_HANDLE;
+            VkCommandBuffer m_Batch = VK_NULL_HANDLE;       // secondary being recorded
+
+            VkDeviceSize m_IndexOffset = 0;                 // vertices start at 0 in the arena
+            VkDeviceSize m_InstanceOffset = 0;
+            bool m_HasIndices = false;
+            bool m_Uploaded = false;
+            float m_Projection[4] = {};
+            VkViewport m_Viewport = {};
+            VkRect2D m_Scissor = {};
+        };
+
+        VulkanBackend* CreateVulkanBackend(const VulkanBackendDesc& desc) {
+            VulkanFunctions vk;
+            if (!desc.getInstanceProcAddr || !desc.device || !vk.Load(desc.getInstanceProcAddr, desc.instance, desc.device)) return nullptr;
+
+            VulkanBackendImpl* backend = new VulkanBackendImpl(vk, desc);
+            if (!backend->CreateCommandPools(desc.queueFamilyIndex) || !backend->CreatePipelines()) {
+                delete backend;
+                return nullptr;
+            }
+            return backend;
+        }
+    }
+}
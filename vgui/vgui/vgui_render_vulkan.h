@@ -0,0 +1,39 @@
+#pragma once
+#include "vgui_render.h"
+#include <vulkan/vulkan.h>
+
+namespace VGUI {
+    namespace Draw {
+        struct VulkanBackendDesc {
+            PFN_vkGetInstanceProcAddr getInstanceProcAddr;  // loader entry (vkGetInstanceProcAddr, volk...)
+            VkInstance instance;
+            VkPhysicalDevice physicalDevice;
+            VkDevice device;
+            uint32_t queueFamilyIndex;  // family of the queue the host submits to
+            VkRenderPass renderPass;    // pass VGUI draws in, one color attachment, no multisampling
+            uint32_t subpass;
+            uint32_t framesInFlight;    // frames the host lets the GPU queue up; 0 means 2
+        };
+
+        // Vulkan 1.0 backend. Pipelines for every command type are built up front, so a frame
+        // only binds them. Each frame in flight owns a host-visible upload arena and a command
+        // pool; every batch (run of commands of one type) is recorded into its own secondary
+        // command buffer, and EndFrame() executes them into the host's primary command buffer.
+        //
+        // Per frame the host waits for the fence of slot frameIndex % framesInFlight, begins
+        // renderPass with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS, calls BeginFrame() and
+        // then Draw::Render(). The slot's arena and command buffers are only reused once that
+        // fence has signaled, so the CPU can build frame N + 1 while the GPU still draws frame N.
+        class VulkanBackend : public RenderBackend {
+        public:
+            // Selects the frame slot and the primary command buffer (inside renderPass, on
+            // framebuffer) the next Render() records into
+            virtual void BeginFrame(uint64_t frameIndex, VkCommandBuffer commandBuffer, VkFramebuffer framebuffer) = 0;
+        };
+
+        // The caller owns the returned backend and deletes it once the device is idle; nullptr
+        // when an entry point is missing or a pipeline fails to build. Entry points are loaded
+        // through desc.getInstanceProcAddr, so nothing needs to link against the Vulkan loader.
+        VulkanBackend* CreateVulkanBackend(const VulkanBackendDesc& desc);
+    }
+}
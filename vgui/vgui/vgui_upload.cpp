@@ -0,0 +1,153 @@
+#include "vgui_upload.h"
+
+namespace VGUI {
+    namespace Upload {
+        static size_t AlignUp(size_t value, size_t alignment) {
+            return ((value + alignment - 1) / alignment) * alignment;
+        }
+
+        static size_t NextPow2(size_t value) {
+            size_t result = 1;
+            while (result < value) result <<= 1;
+            return result;
+        }
+
+        RingBuffer::RingBuffer(UploadDevice* device, size_t minCapacity, size_t headroomFrames)
+            : m_Device(device), m_MinCapacity(minCapacity), m_HeadroomFrames(headroomFrames ? headroomFrames : 1),
+            m_Capacity(0), m_Head(0), m_Used(0), m_FrameBytes(0), m_PendingGrow(0),
+            m_NeedsDiscard(true), m_Mapped(false), m_Stats() {
+        }
+
+        void RingBuffer::Retire() {
+            if (m_InFlight.empty()) return;
+
+            uint64_t completed = m_Device->GetCompletedFence();
+            while (!m_InFlight.empty() && m_InFlight.front().fence <= completed) {
+                m_Used -= m_InFlight.front().bytes;
+                m_InFlight.pop_front();
+            }
+        }
+
+        bool RingBuffer::Grow(size_t required) {
+            size_t capacity = NextPow2(required);
+            if (capacity < m_MinCapacity) capacity = m_MinCapacity;
+
+            if (!m_Device->CreateBuffer(capacity)) {
+                m_Capacity = 0;
+                return false;
+            }
+
+            // The old buffer is released by the device; whatever the GPU still reads from it
+            // stays alive until the driver is done with it.
+            m_Capacity = capacity;
+            m_Head = 0;
+            m_Used = 0;
+            m_FrameBytes = 0;
+            m_PendingGrow = 0;
+            m_NeedsDiscard = true;
+            m_InFlight.clear();
+            m_Stats.bufferCreations++;
+            return true;
+        }
+
+        bool RingBuffer::Fits(size_t offset, size_t size) const {
+            if (offset + size > m_Capacity) return false;
+            if (m_Used == 0) return true;
+
+            size_t tail = (m_Head + m_Capacity - m_Used) % m_Capacity;
+            if (tail == m_Head) return false; // full
+
+            if (tail < m_Head) {
+                // Live data in [tail, head): free space is after head or before tail
+                return offset >= m_Head || offset + size <= tail;
+            }
+            // Live data wraps: free space is [head, tail)
+            return offset >= m_Head && offset + size <= tail;
+        }
+
+        void* RingBuffer::Map(size_t size, size_t alignment, size_t& outOffset) {
+            if (m_Mapped || size == 0) return nullptr;
+            if (alignment == 0) alignment = 1;
+
+            Retire();
+
+            size_t required = size + alignment;
+            if (m_Capacity == 0 || required > m_Capacity || m_PendingGrow > m_Capacity) {
+                size_t target = required * m_HeadroomFrames;
+                if (target < m_PendingGrow) target = m_PendingGrow;
+                if (!Grow(target)) return nullptr;
+            }
+
+            bool discard = m_NeedsDiscard;
+            size_t offset = AlignUp(m_Head, alignment);
+            size_t consumed = 0;
+
+            if (!discard && Fits(offset, size)) {
+                consumed = offset - m_Head + size;
+            }
+            else if (!discard && Fits(0, size)) {
+                // Wrap: the tail end of the ring is padding owned by this frame
+                offset = 0;
+                consumed = m_Capacity - m_Head + size;
+                m_Stats.wraps++;
+            }
+            else {
+                // No retired space left. Orphan the buffer: draws already submitted keep
+                // the old storage, everything handed out before this point is forgotten.
+                discard = true;
+                offset = 0;
+                consumed = size;
+                m_Used = 0;
+                m_FrameBytes = 0;
+                m_InFlight.clear();
+                if (!m_NeedsDiscard) m_Stats.discards++;
+            }
+
+            void* data = m_Device->Map(discard);
+            if (!data) return nullptr;
+
+            m_NeedsDiscard = false;
+            m_Mapped = true;
+            m_Head = offset + size;
+            m_Used += consumed;
+            m_FrameBytes += consumed;
+            outOffset = offset;
+            return static_cast<unsigned char*>(data) + offset;
+        }
+
+        void RingBuffer::Unmap() {
+            if (!m_Mapped) return;
+            m_Device->Unmap();
+            m_Mapped = false;
+        }
+
+        void RingBuffer::EndFrame() {
+            m_Stats.bytesThisFrame = m_FrameBytes;
+            if (m_FrameBytes > m_Stats.peakFrameBytes) m_Stats.peakFrameBytes = m_FrameBytes;
+
+            if (m_FrameBytes > 0) {
+                m_InFlight.push_back({ m_Device->SignalFence(), m_FrameBytes });
+
+                // Keep room for headroomFrames frames of this size before the ring has to
+                // discard; growing happens at the start of the next Map.
+                size_t wanted = m_FrameBytes * m_HeadroomFrames;
+                if (wanted > m_Capacity) m_PendingGrow = NextPow2(wanted);
+            }
+
+            m_FrameBytes = 0;
+            m_Stats.capacity = m_Capacity;
+            m_Stats.framesInFlight = m_InFlight.size();
+        }
+
+        void RingBuffer::Reset() {
+            m_Capacity = 0;
+            m_Head = 0;
+            m_Used = 0;
+            m_FrameBytes = 0;
+            m_PendingGrow = 0;
+            m_NeedsDiscard = true;
+            m_Mapped = false;
+            m_InFlight.clear();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace VGUI {
+    namespace Upload {
+        // Minimal view of a GPU buffer the ring streams into. The D3D11 implementation lives
+        // next to Draw::Render, tests can drive the ring with a mock.
+        class UploadDevice {
+        public:
+            virtual ~UploadDevice() {}
+
+            // (Re)create the backing buffer. Previous contents are dropped.
+            virtual bool CreateBuffer(size_t capacity) = 0;
+            // discard = orphan the old contents (driver renames), otherwise no-overwrite
+            virtual void* Map(bool discard) = 0;
+            virtual void Unmap() = 0;
+
+            // Fence-style frame tracking: SignalFence is called once per frame after the
+            // draws that read the frame's data, GetCompletedFence returns the highest
+            // signalled value the GPU is known to have passed.
+            virtual uint64_t SignalFence() = 0;
+            virtual uint64_t GetCompletedFence() = 0;
+        };
+
+        struct RingStats {
+            size_t capacity;
+            size_t bytesThisFrame;
+            size_t peakFrameBytes;
+            uint64_t bufferCreations;
+            uint64_t discards;
+            uint64_t wraps;
+            uint64_t framesInFlight;
+        };
+
+        // Persistent ring-buffer upload allocator.
+        // Steady state: every Map is a no-overwrite map into space the GPU has retired.
+        // When the ring runs out of retired space it falls back to a discard map, and when a
+        // frame needs more than capacity / headroomFrames bytes the buffer grows once.
+        class RingBuffer {
+        public:
+            RingBuffer(UploadDevice* device, size_t minCapacity = 64 * 1024, size_t headroomFrames = 3);
+
+            // Reserve 'size' bytes aligned to 'alignment' (any non-zero value) and map them.
+            // Returns nullptr if the device failed. Must be paired with Unmap().
+            void* Map(size_t size, size_t alignment, size_t& outOffset);
+            void Unmap();
+
+            // Close the current frame: signals a fence covering everything mapped since
+            // the previous EndFrame and applies the growth policy.
+            void EndFrame();
+
+            // Drops the backing buffer, the next Map recreates it.
+            void Reset();
+
+            const RingStats& GetStats() const { return m_Stats; }
+            size_t GetCapacity() const { return m_Capacity; }
+
+        private:
+            struct InFlightFrame {
+                uint64_t fence;
+                size_t bytes;   // bytes the frame holds, including alignment and wrap padding
+            };
+
+            void Retire();
+            bool Grow(size_t required);
+            bool Fits(size_t offset, size_t size) const;
+
+            UploadDevice* m_Device;
+            size_t m_MinCapacity;
+            size_t m_HeadroomFrames;
+            size_t m_Capacity;
+            size_t m_Head;          // next free byte
+            size_t m_Used;          // bytes owned by in-flight frames and the open frame
+            size_t m_FrameBytes;    // bytes owned by the open frame
+            size_t m_PendingGrow;   // capacity requested by the growth policy, applied on next Map
+            bool m_NeedsDiscard;
+            bool m_Mapped;
+            std::deque<InFlightFrame> m_InFlight;
+            RingStats m_Stats;
+        };
+    }
+}
\ No newline at end of file